@@ -0,0 +1,152 @@
+/*********************************************************************
+ *
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2015, Daichi Yoshikawa
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the Daichi Yoshikawa nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Author: Daichi Yoshikawa
+ *
+ *********************************************************************/
+
+#ifndef __AHL_DIGITAL_FILTER_BIQUAD_FILTER_HPP
+#define __AHL_DIGITAL_FILTER_BIQUAD_FILTER_HPP
+
+#include <vector>
+#include <Eigen/StdVector>
+#include "ahl_digital_filter/digital_filter.hpp"
+
+namespace ahl_filter
+{
+
+  /*
+    Coefficients of H(z) = (b0 + b1 z^-1 + b2 z^-2) / (1 + a1 z^-1 + a2 z^-2).
+    Designed by the bilinear transform with frequency prewarping.
+  */
+  struct BiquadCoefficients
+  {
+    double b0, b1, b2;
+    double a1, a2;
+
+    static BiquadCoefficients lowpass(double period, double cutoff_freq, double q);
+    static BiquadCoefficients highpass(double period, double cutoff_freq, double q);
+    static BiquadCoefficients notch(double period, double center_freq, double q);
+    static BiquadCoefficients firstOrderLowpass(double period, double cutoff_freq);
+    static BiquadCoefficients firstOrderHighpass(double period, double cutoff_freq);
+  };
+
+  /*
+    Analog prototype of a section, kept to discretize it again for another period.
+  */
+  struct BiquadDesign
+  {
+    enum Type
+    {
+      CUSTOM,
+      LOWPASS,
+      HIGHPASS,
+      NOTCH,
+      FIRST_ORDER_LOWPASS,
+      FIRST_ORDER_HIGHPASS
+    };
+
+    BiquadDesign(Type type = CUSTOM, double freq = 0.0, double q = 1.0)
+      : type(type), freq(freq), q(q) {}
+
+    BiquadCoefficients discretize(double period) const;
+
+    Type type;
+    double freq;
+    double q;
+  };
+
+  /*
+    Cascade of biquad sections in transposed direct form II.
+  */
+  class BiquadFilter : public DigitalFilter
+  {
+  public:
+    BiquadFilter(double period = 0.0)
+      : period_(period), pre_time_(-1.0) {}
+
+    void addSection(const BiquadCoefficients& coeff);
+    void addSection(const BiquadDesign& design);
+    void clear();
+    unsigned int getSectionNum() const
+    {
+      return section_.size();
+    }
+
+    virtual void init(const Eigen::VectorXd& x);
+    virtual void apply(Eigen::VectorXd& x);
+    // Sections added with BiquadDesign are discretized again when the step changes
+    virtual void apply(Eigen::VectorXd& x, double time);
+
+  private:
+    struct Section
+    {
+      BiquadDesign design;
+      BiquadCoefficients coeff;
+      Eigen::ArrayXd z1;
+      Eigen::ArrayXd z2;
+    };
+
+    std::vector<Section> section_;
+    Eigen::ArrayXd y_;
+    double period_;
+    double pre_time_;
+  };
+
+  typedef boost::shared_ptr<BiquadFilter> BiquadFilterPtr;
+
+  /*
+    Butterworth filters of arbitrary order, built from ceil(order / 2) sections.
+  */
+  class ButterworthLowpassFilter : public BiquadFilter
+  {
+  public:
+    ButterworthLowpassFilter(double period, double cutoff_freq, unsigned int order);
+  };
+
+  class ButterworthHighpassFilter : public BiquadFilter
+  {
+  public:
+    ButterworthHighpassFilter(double period, double cutoff_freq, unsigned int order);
+  };
+
+  class NotchFilter : public BiquadFilter
+  {
+  public:
+    NotchFilter(double period, double center_freq, double q);
+  };
+
+}
+
+#endif /* __AHL_DIGITAL_FILTER_BIQUAD_FILTER_HPP */
@@ -51,7 +51,16 @@ namespace ahl_filter
     virtual ~Differentiator() {}
     virtual void init(const Eigen::VectorXd& q, const Eigen::VectorXd& dq) = 0;
     virtual void apply(const Eigen::VectorXd& q) = 0;
+    // Differentiate using the time stamp [sec] of q instead of the nominal period
+    virtual void apply(const Eigen::VectorXd& q, double time)
+    {
+      this->apply(q);
+    }
     virtual void copyDerivativeValueTo(Eigen::VectorXd& dq) = 0;
+    virtual void copySecondDerivativeValueTo(Eigen::VectorXd& ddq)
+    {
+      ddq.setZero();
+    }
   };
 
   typedef boost::shared_ptr<Differentiator> DifferentiatorPtr;
@@ -0,0 +1,71 @@
+/*********************************************************************
+ *
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2015, Daichi Yoshikawa
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the Daichi Yoshikawa nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Author: Daichi Yoshikawa
+ *
+ *********************************************************************/
+
+#ifndef __AHL_DIGITAL_FILTER_DIGITAL_FILTER_HPP
+#define __AHL_DIGITAL_FILTER_DIGITAL_FILTER_HPP
+
+#include <boost/shared_ptr.hpp>
+#include <Eigen/Dense>
+
+namespace ahl_filter
+{
+
+  /*
+    Filter applied to all channels of a signal at once.
+    Each element of x is one channel, and the internal state is
+    stored per state variable across channels so that apply() is vectorized.
+  */
+  class DigitalFilter
+  {
+  public:
+    virtual ~DigitalFilter() {}
+    // Resize the state to x.rows() channels and settle it on constant input x
+    virtual void init(const Eigen::VectorXd& x) = 0;
+    // Overwrite x with the filtered value without allocating memory
+    virtual void apply(Eigen::VectorXd& x) = 0;
+    // Same as apply(x), but discretized with the time stamp [sec] of x
+    virtual void apply(Eigen::VectorXd& x, double time)
+    {
+      this->apply(x);
+    }
+  };
+
+  typedef boost::shared_ptr<DigitalFilter> DigitalFilterPtr;
+}
+
+#endif /* __AHL_DIGITAL_FILTER_DIGITAL_FILTER_HPP */
@@ -0,0 +1,116 @@
+/*********************************************************************
+ *
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2015, Daichi Yoshikawa
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the Daichi Yoshikawa nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Author: Daichi Yoshikawa
+ *
+ *********************************************************************/
+
+#ifndef __AHL_DIGITAL_FILTER_FILTER_BANK_HPP
+#define __AHL_DIGITAL_FILTER_FILTER_BANK_HPP
+
+#include <string>
+#include <vector>
+#include "ahl_digital_filter/digital_filter.hpp"
+#include "ahl_digital_filter/differentiator.hpp"
+
+namespace ahl_filter
+{
+
+  namespace filter
+  {
+    static const std::string LOWPASS  = "lowpass";
+    static const std::string HIGHPASS = "highpass";
+    static const std::string NOTCH    = "notch";
+  }
+
+  namespace differentiator
+  {
+    static const std::string PSEUDO         = "pseudo";
+    static const std::string SAVITZKY_GOLAY = "savitzky_golay";
+    static const std::string FIXED_LAG_SMOOTHER = "fixed_lag_smoother";
+  }
+
+  struct FilterParam
+  {
+    FilterParam()
+      : type(filter::LOWPASS), frequency(0.0), order(2), q(1.0) {}
+
+    std::string type;
+    double frequency; // cutoff frequency, or center frequency of notch
+    unsigned int order; // order of lowpass and highpass
+    double q; // quality factor of notch
+  };
+
+  struct DifferentiatorParam
+  {
+    DifferentiatorParam()
+      : type(differentiator::PSEUDO), cutoff_frequency(0.0), window_size(0), polynomial_order(2), lag(0) {}
+
+    std::string type;
+    double cutoff_frequency; // pseudo
+    unsigned int window_size; // savitzky_golay, fixed_lag_smoother
+    unsigned int polynomial_order; // savitzky_golay, fixed_lag_smoother
+    unsigned int lag; // fixed_lag_smoother
+  };
+
+  /*
+    Series of filters applied in place to all channels.
+  */
+  class FilterBank : public DigitalFilter
+  {
+  public:
+    FilterBank(double period);
+
+    void addFilter(const FilterParam& param);
+    void addFilter(const DigitalFilterPtr& filter);
+    bool empty() const
+    {
+      return filter_.empty();
+    }
+
+    virtual void init(const Eigen::VectorXd& x);
+    virtual void apply(Eigen::VectorXd& x);
+    virtual void apply(Eigen::VectorXd& x, double time);
+
+    static DifferentiatorPtr createDifferentiator(double period, const DifferentiatorParam& param);
+
+  private:
+    double period_;
+    std::vector<DigitalFilterPtr> filter_;
+  };
+
+  typedef boost::shared_ptr<FilterBank> FilterBankPtr;
+}
+
+#endif /* __AHL_DIGITAL_FILTER_FILTER_BANK_HPP */
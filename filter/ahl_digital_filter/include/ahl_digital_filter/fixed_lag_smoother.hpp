@@ -0,0 +1,97 @@
+/*********************************************************************
+ *
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2015, Daichi Yoshikawa
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the Daichi Yoshikawa nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Author: Daichi Yoshikawa
+ *
+ *********************************************************************/
+
+#ifndef __AHL_DIGITAL_FILTER_FIXED_LAG_SMOOTHER_HPP
+#define __AHL_DIGITAL_FILTER_FIXED_LAG_SMOOTHER_HPP
+
+#include <Eigen/Dense>
+#include "ahl_digital_filter/differentiator.hpp"
+
+namespace ahl_filter
+{
+
+  /*
+    Fits a polynomial to the latest window_size samples by least squares
+    on their actual time stamps, and evaluates its first and second derivatives
+    lag samples before the latest one.
+    Larger lag gives smoother estimates at the cost of delay, and lag = 0 is
+    a causal Savitzky-Golay differentiator which tolerates jitter.
+  */
+  class FixedLagSmoother : public Differentiator
+  {
+  public:
+    FixedLagSmoother(double period, unsigned int window_size, unsigned int lag, unsigned int polynomial_order = 2);
+
+    virtual void init(const Eigen::VectorXd& q, const Eigen::VectorXd& dq);
+    // Assumes the nominal period between samples
+    virtual void apply(const Eigen::VectorXd& q);
+    virtual void apply(const Eigen::VectorXd& q, double time);
+    virtual void copyDerivativeValueTo(Eigen::VectorXd& dq)
+    {
+      dq = dq_;
+    }
+    virtual void copySecondDerivativeValueTo(Eigen::VectorXd& ddq)
+    {
+      ddq = ddq_;
+    }
+
+  private:
+    void computeWeights();
+
+    double period_;
+    unsigned int lag_;
+
+    Eigen::MatrixXd history_; // each column holds all channels at one sample
+    Eigen::VectorXd time_;
+    unsigned int head_;
+    bool initialized_;
+    double last_time_;
+
+    Eigen::VectorXd dq_;
+    Eigen::VectorXd ddq_;
+
+    // work space of computeWeights()
+    Eigen::MatrixXd A_;
+    Eigen::MatrixXd AtA_;
+    Eigen::MatrixXd coeff_;
+    Eigen::LDLT<Eigen::MatrixXd> ldlt_;
+  };
+
+}
+
+#endif /* __AHL_DIGITAL_FILTER_FIXED_LAG_SMOOTHER_HPP */
@@ -39,9 +39,14 @@
 #ifndef __AHL_DIGITAL_FILTER_LOWPASS_FILTER_HPP
 #define __AHL_DIGITAL_FILTER_LOWPASS_FILTER_HPP
 
+#include "ahl_digital_filter/biquad_filter.hpp"
 
+namespace ahl_filter
+{
 
+  typedef ButterworthLowpassFilter LowpassFilter;
+  typedef boost::shared_ptr<LowpassFilter> LowpassFilterPtr;
 
-
+}
 
 #endif /* __AHL_DIGITAL_FILTER_LOWPASS_FILTER_HPP */
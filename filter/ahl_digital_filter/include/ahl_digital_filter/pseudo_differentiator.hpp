@@ -53,18 +53,18 @@ namespace ahl_filter
 
     virtual void init(const Eigen::VectorXd& q, const Eigen::VectorXd& dq);
     virtual void apply(const Eigen::VectorXd& q);
+    virtual void apply(const Eigen::VectorXd& q, double time);
     virtual void copyDerivativeValueTo(Eigen::VectorXd& dq)
     {
       dq = dq_;
     }
 
   private:
-    Eigen::VectorXd q_;
     Eigen::VectorXd dq_;
     Eigen::VectorXd pre_q_;
-    Eigen::VectorXd pre_dq_;
     double period_;
     double T_;
+    double pre_time_;
 
     double coeff1_;
     double coeff2_;
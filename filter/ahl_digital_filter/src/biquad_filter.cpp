@@ -0,0 +1,256 @@
+#include <cmath>
+#include "ahl_digital_filter/exception.hpp"
+#include "ahl_digital_filter/biquad_filter.hpp"
+
+using namespace ahl_filter;
+
+namespace
+{
+  void checkFrequency(const std::string& src, double period, double freq)
+  {
+    if(period <= 0.0)
+    {
+      std::stringstream msg;
+      msg << "Period should be larger than zero.";
+      throw ahl_filter::Exception(src, msg.str());
+    }
+
+    if(freq <= 0.0 || freq >= 0.5 / period)
+    {
+      std::stringstream msg;
+      msg << "Frequency should be between zero and the Nyquist frequency." << std::endl
+          << "  frequency         : " << freq << std::endl
+          << "  nyquist frequency : " << 0.5 / period;
+      throw ahl_filter::Exception(src, msg.str());
+    }
+  }
+
+  BiquadCoefficients normalize(double b0, double b1, double b2, double a0, double a1, double a2)
+  {
+    BiquadCoefficients coeff;
+    coeff.b0 = b0 / a0;
+    coeff.b1 = b1 / a0;
+    coeff.b2 = b2 / a0;
+    coeff.a1 = a1 / a0;
+    coeff.a2 = a2 / a0;
+    return coeff;
+  }
+}
+
+BiquadCoefficients BiquadCoefficients::lowpass(double period, double cutoff_freq, double q)
+{
+  checkFrequency("BiquadCoefficients::lowpass", period, cutoff_freq);
+
+  double w0 = 2.0 * M_PI * cutoff_freq * period;
+  double alpha = sin(w0) / (2.0 * q);
+  double c = cos(w0);
+
+  return normalize(0.5 * (1.0 - c), 1.0 - c, 0.5 * (1.0 - c),
+                   1.0 + alpha, -2.0 * c, 1.0 - alpha);
+}
+
+BiquadCoefficients BiquadCoefficients::highpass(double period, double cutoff_freq, double q)
+{
+  checkFrequency("BiquadCoefficients::highpass", period, cutoff_freq);
+
+  double w0 = 2.0 * M_PI * cutoff_freq * period;
+  double alpha = sin(w0) / (2.0 * q);
+  double c = cos(w0);
+
+  return normalize(0.5 * (1.0 + c), -(1.0 + c), 0.5 * (1.0 + c),
+                   1.0 + alpha, -2.0 * c, 1.0 - alpha);
+}
+
+BiquadCoefficients BiquadCoefficients::notch(double period, double center_freq, double q)
+{
+  checkFrequency("BiquadCoefficients::notch", period, center_freq);
+
+  double w0 = 2.0 * M_PI * center_freq * period;
+  double alpha = sin(w0) / (2.0 * q);
+  double c = cos(w0);
+
+  return normalize(1.0, -2.0 * c, 1.0,
+                   1.0 + alpha, -2.0 * c, 1.0 - alpha);
+}
+
+BiquadCoefficients BiquadCoefficients::firstOrderLowpass(double period, double cutoff_freq)
+{
+  checkFrequency("BiquadCoefficients::firstOrderLowpass", period, cutoff_freq);
+
+  double k = tan(M_PI * cutoff_freq * period);
+  return normalize(k, k, 0.0, k + 1.0, k - 1.0, 0.0);
+}
+
+BiquadCoefficients BiquadCoefficients::firstOrderHighpass(double period, double cutoff_freq)
+{
+  checkFrequency("BiquadCoefficients::firstOrderHighpass", period, cutoff_freq);
+
+  double k = tan(M_PI * cutoff_freq * period);
+  return normalize(1.0, -1.0, 0.0, k + 1.0, k - 1.0, 0.0);
+}
+
+BiquadCoefficients BiquadDesign::discretize(double period) const
+{
+  switch(type)
+  {
+  case LOWPASS:
+    return BiquadCoefficients::lowpass(period, freq, q);
+  case HIGHPASS:
+    return BiquadCoefficients::highpass(period, freq, q);
+  case NOTCH:
+    return BiquadCoefficients::notch(period, freq, q);
+  case FIRST_ORDER_LOWPASS:
+    return BiquadCoefficients::firstOrderLowpass(period, freq);
+  case FIRST_ORDER_HIGHPASS:
+    return BiquadCoefficients::firstOrderHighpass(period, freq);
+  default:
+    break;
+  }
+
+  std::stringstream msg;
+  msg << "Custom sections cannot be discretized.";
+  throw ahl_filter::Exception("BiquadDesign::discretize", msg.str());
+}
+
+void BiquadFilter::addSection(const BiquadCoefficients& coeff)
+{
+  Section section;
+  section.coeff = coeff;
+  section_.push_back(section);
+}
+
+void BiquadFilter::addSection(const BiquadDesign& design)
+{
+  Section section;
+  section.design = design;
+  section.coeff = design.discretize(period_);
+  section_.push_back(section);
+}
+
+void BiquadFilter::clear()
+{
+  section_.clear();
+}
+
+void BiquadFilter::init(const Eigen::VectorXd& x)
+{
+  y_ = x.array();
+  pre_time_ = -1.0;
+
+  for(unsigned int i = 0; i < section_.size(); ++i)
+  {
+    const BiquadCoefficients& c = section_[i].coeff;
+    double dc_gain = (c.b0 + c.b1 + c.b2) / (1.0 + c.a1 + c.a2);
+
+    // Steady state of transposed direct form II for constant input
+    section_[i].z1 = (dc_gain - c.b0) * y_;
+    section_[i].z2 = (c.b2 - c.a2 * dc_gain) * y_;
+    y_ *= dc_gain;
+  }
+}
+
+void BiquadFilter::apply(Eigen::VectorXd& x)
+{
+  if(x.rows() != y_.rows())
+  {
+    std::stringstream msg;
+    msg << "x.rows() != number of channels" << std::endl
+        << "  x.rows   : " << x.rows() << std::endl
+        << "  channels : " << y_.rows();
+
+    throw ahl_filter::Exception("BiquadFilter::apply", msg.str());
+  }
+
+  for(unsigned int i = 0; i < section_.size(); ++i)
+  {
+    const BiquadCoefficients& c = section_[i].coeff;
+    Eigen::ArrayXd& z1 = section_[i].z1;
+    Eigen::ArrayXd& z2 = section_[i].z2;
+
+    y_ = c.b0 * x.array() + z1;
+    z1 = c.b1 * x.array() - c.a1 * y_ + z2;
+    z2 = c.b2 * x.array() - c.a2 * y_;
+    x = y_.matrix();
+  }
+}
+
+void BiquadFilter::apply(Eigen::VectorXd& x, double time)
+{
+  double h = (pre_time_ < 0.0) ? period_ : time - pre_time_;
+  pre_time_ = time;
+
+  // Skip small deviations since redesign costs a few trigonometric functions per section
+  if(h > 0.0 && std::fabs(h - period_) > 1e-3 * period_)
+  {
+    for(unsigned int i = 0; i < section_.size(); ++i)
+    {
+      const BiquadDesign& design = section_[i].design;
+
+      // Keep the previous coefficients if the step is too long to represent the section
+      if(design.type != BiquadDesign::CUSTOM && design.freq * h < 0.5)
+      {
+        section_[i].coeff = design.discretize(h);
+      }
+    }
+    period_ = h;
+  }
+
+  this->apply(x);
+}
+
+ButterworthLowpassFilter::ButterworthLowpassFilter(double period, double cutoff_freq, unsigned int order)
+  : BiquadFilter(period)
+{
+  if(order == 0)
+  {
+    std::stringstream msg;
+    msg << "Order should be larger than zero.";
+    throw ahl_filter::Exception("ButterworthLowpassFilter::ButterworthLowpassFilter", msg.str());
+  }
+
+  for(unsigned int k = 0; k < order / 2; ++k)
+  {
+    double q = 1.0 / (2.0 * sin(M_PI * (2.0 * k + 1.0) / (2.0 * order)));
+    this->addSection(BiquadDesign(BiquadDesign::LOWPASS, cutoff_freq, q));
+  }
+
+  if(order % 2 == 1)
+  {
+    this->addSection(BiquadDesign(BiquadDesign::FIRST_ORDER_LOWPASS, cutoff_freq));
+  }
+}
+
+ButterworthHighpassFilter::ButterworthHighpassFilter(double period, double cutoff_freq, unsigned int order)
+  : BiquadFilter(period)
+{
+  if(order == 0)
+  {
+    std::stringstream msg;
+    msg << "Order should be larger than zero.";
+    throw ahl_filter::Exception("ButterworthHighpassFilter::ButterworthHighpassFilter", msg.str());
+  }
+
+  for(unsigned int k = 0; k < order / 2; ++k)
+  {
+    double q = 1.0 / (2.0 * sin(M_PI * (2.0 * k + 1.0) / (2.0 * order)));
+    this->addSection(BiquadDesign(BiquadDesign::HIGHPASS, cutoff_freq, q));
+  }
+
+  if(order % 2 == 1)
+  {
+    this->addSection(BiquadDesign(BiquadDesign::FIRST_ORDER_HIGHPASS, cutoff_freq));
+  }
+}
+
+NotchFilter::NotchFilter(double period, double center_freq, double q)
+  : BiquadFilter(period)
+{
+  if(q <= 0.0)
+  {
+    std::stringstream msg;
+    msg << "Quality factor should be larger than zero.";
+    throw ahl_filter::Exception("NotchFilter::NotchFilter", msg.str());
+  }
+
+  this->addSection(BiquadDesign(BiquadDesign::NOTCH, center_freq, q));
+}
@@ -0,0 +1,92 @@
+#include "ahl_digital_filter/exception.hpp"
+#include "ahl_digital_filter/filter_bank.hpp"
+#include "ahl_digital_filter/biquad_filter.hpp"
+#include "ahl_digital_filter/pseudo_differentiator.hpp"
+#include "ahl_digital_filter/savitzky_golay_differentiator.hpp"
+#include "ahl_digital_filter/fixed_lag_smoother.hpp"
+
+using namespace ahl_filter;
+
+FilterBank::FilterBank(double period)
+  : period_(period)
+{
+  if(period_ <= 0.0)
+  {
+    std::stringstream msg;
+    msg << "Period should be larger than zero.";
+    throw ahl_filter::Exception("FilterBank::FilterBank", msg.str());
+  }
+}
+
+void FilterBank::addFilter(const FilterParam& param)
+{
+  if(param.type == filter::LOWPASS)
+  {
+    filter_.push_back(DigitalFilterPtr(new ButterworthLowpassFilter(period_, param.frequency, param.order)));
+  }
+  else if(param.type == filter::HIGHPASS)
+  {
+    filter_.push_back(DigitalFilterPtr(new ButterworthHighpassFilter(period_, param.frequency, param.order)));
+  }
+  else if(param.type == filter::NOTCH)
+  {
+    filter_.push_back(DigitalFilterPtr(new NotchFilter(period_, param.frequency, param.q)));
+  }
+  else
+  {
+    std::stringstream msg;
+    msg << "Unknown filter type : " << param.type;
+    throw ahl_filter::Exception("FilterBank::addFilter", msg.str());
+  }
+}
+
+void FilterBank::addFilter(const DigitalFilterPtr& filter)
+{
+  filter_.push_back(filter);
+}
+
+void FilterBank::init(const Eigen::VectorXd& x)
+{
+  Eigen::VectorXd y = x;
+  for(unsigned int i = 0; i < filter_.size(); ++i)
+  {
+    filter_[i]->init(y);
+    filter_[i]->apply(y);
+  }
+}
+
+void FilterBank::apply(Eigen::VectorXd& x)
+{
+  for(unsigned int i = 0; i < filter_.size(); ++i)
+  {
+    filter_[i]->apply(x);
+  }
+}
+
+void FilterBank::apply(Eigen::VectorXd& x, double time)
+{
+  for(unsigned int i = 0; i < filter_.size(); ++i)
+  {
+    filter_[i]->apply(x, time);
+  }
+}
+
+DifferentiatorPtr FilterBank::createDifferentiator(double period, const DifferentiatorParam& param)
+{
+  if(param.type == differentiator::PSEUDO)
+  {
+    return DifferentiatorPtr(new PseudoDifferentiator(period, param.cutoff_frequency));
+  }
+  else if(param.type == differentiator::SAVITZKY_GOLAY)
+  {
+    return DifferentiatorPtr(new SavitzkyGolayDifferentiator(period, param.window_size, param.polynomial_order));
+  }
+  else if(param.type == differentiator::FIXED_LAG_SMOOTHER)
+  {
+    return DifferentiatorPtr(new FixedLagSmoother(period, param.window_size, param.lag, param.polynomial_order));
+  }
+
+  std::stringstream msg;
+  msg << "Unknown differentiator type : " << param.type;
+  throw ahl_filter::Exception("FilterBank::createDifferentiator", msg.str());
+}
@@ -0,0 +1,140 @@
+#include "ahl_digital_filter/exception.hpp"
+#include "ahl_digital_filter/fixed_lag_smoother.hpp"
+
+using namespace ahl_filter;
+
+FixedLagSmoother::FixedLagSmoother(double period, unsigned int window_size, unsigned int lag, unsigned int polynomial_order)
+  : period_(period), lag_(lag), head_(0), initialized_(false), last_time_(0.0)
+{
+  if(period_ <= 0.0)
+  {
+    std::stringstream msg;
+    msg << "Period should be larger than zero.";
+    throw ahl_filter::Exception("FixedLagSmoother::FixedLagSmoother", msg.str());
+  }
+
+  if(polynomial_order < 2 || window_size <= polynomial_order || lag >= window_size)
+  {
+    std::stringstream msg;
+    msg << "Window size should be larger than polynomial order and lag, and polynomial order should be larger than one." << std::endl
+        << "  window_size      : " << window_size << std::endl
+        << "  lag              : " << lag << std::endl
+        << "  polynomial_order : " << polynomial_order;
+    throw ahl_filter::Exception("FixedLagSmoother::FixedLagSmoother", msg.str());
+  }
+
+  time_   = Eigen::VectorXd::Zero(window_size);
+  A_      = Eigen::MatrixXd::Zero(window_size, polynomial_order + 1);
+  AtA_    = Eigen::MatrixXd::Zero(polynomial_order + 1, polynomial_order + 1);
+  coeff_  = Eigen::MatrixXd::Zero(polynomial_order + 1, window_size);
+  ldlt_   = Eigen::LDLT<Eigen::MatrixXd>(polynomial_order + 1);
+}
+
+void FixedLagSmoother::init(const Eigen::VectorXd& q, const Eigen::VectorXd& dq)
+{
+  if(q.rows() != dq.rows())
+  {
+    std::stringstream msg;
+    msg << "q.rows() != dq.rows()" << std::endl
+        << "  q.rows  : " << q.rows() << std::endl
+        << "  dq.rows : " << dq.rows();
+
+    throw ahl_filter::Exception("FixedLagSmoother::init", msg.str());
+  }
+
+  const unsigned int n = time_.rows();
+
+  // The time stamp of q is unknown until the first apply(), so keep q
+  // and dq in the window and set their time stamps there.
+  // As in the ring walk, the j-th latest sample lives in col((head_ + n - j) % n).
+  history_.resize(q.rows(), n);
+  for(unsigned int j = 0; j < n; ++j)
+  {
+    history_.col((n - j) % n) = q - (j * period_) * dq;
+  }
+
+  dq_ = dq;
+  ddq_ = Eigen::VectorXd::Zero(q.rows());
+  head_ = 0;
+  initialized_ = false;
+}
+
+void FixedLagSmoother::apply(const Eigen::VectorXd& q)
+{
+  this->apply(q, initialized_ ? last_time_ + period_ : 0.0);
+}
+
+void FixedLagSmoother::apply(const Eigen::VectorXd& q, double time)
+{
+  if(q.rows() != history_.rows())
+  {
+    std::stringstream msg;
+    msg << "q.rows() != number of channels" << std::endl
+        << "  q.rows   : " << q.rows() << std::endl
+        << "  channels : " << history_.rows();
+
+    throw ahl_filter::Exception("FixedLagSmoother::apply", msg.str());
+  }
+
+  const unsigned int n = time_.rows();
+
+  if(!initialized_)
+  {
+    // history_.col((n - j) % n) was extrapolated back from init() by j periods.
+    // Regard the sample given to init() as one period before q, which
+    // replaces the oldest extrapolated sample.
+    for(unsigned int j = 1; j < n; ++j)
+    {
+      time_[(n + 1 - j) % n] = time - j * period_;
+    }
+    initialized_ = true;
+  }
+  else if(time <= last_time_)
+  {
+    return;
+  }
+
+  head_ = (head_ + 1) % n;
+
+  history_.col(head_) = q;
+  time_[head_] = time;
+  last_time_ = time;
+
+  this->computeWeights();
+
+  dq_.setZero();
+  ddq_.setZero();
+  for(unsigned int j = 0; j < n; ++j)
+  {
+    const unsigned int idx = (head_ + n - j) % n;
+    dq_  += coeff_.coeff(1, j) * history_.col(idx);
+    ddq_ += coeff_.coeff(2, j) * history_.col(idx);
+  }
+}
+
+void FixedLagSmoother::computeWeights()
+{
+  const unsigned int n = time_.rows();
+  const double t0 = time_[(head_ + n - lag_) % n];
+
+  // Time is normalized by the nominal period to keep A^T A well conditioned
+  for(unsigned int j = 0; j < n; ++j)
+  {
+    double t = (time_[(head_ + n - j) % n] - t0) / period_;
+    double tk = 1.0;
+    for(unsigned int k = 0; k < A_.cols(); ++k)
+    {
+      A_.coeffRef(j, k) = tk;
+      tk *= t;
+    }
+  }
+
+  AtA_.noalias() = A_.transpose() * A_;
+  ldlt_.compute(AtA_);
+  coeff_ = ldlt_.solve(A_.transpose());
+
+  // Rows of coeff_ give the polynomial coefficients, so the derivatives at t0 are
+  // c1 / period and 2 c2 / period^2
+  coeff_.row(1) /= period_;
+  coeff_.row(2) *= 2.0 / (period_ * period_);
+}
@@ -4,7 +4,7 @@
 using namespace ahl_filter;
 
 PseudoDifferentiator::PseudoDifferentiator(double period, double cutoff_freq)
-  : period_(period)
+  : period_(period), pre_time_(-1.0)
 {
   if(period_ <= 0.0)
   {
@@ -38,14 +38,32 @@ void PseudoDifferentiator::init(const Eigen::VectorXd& q, const Eigen::VectorXd&
     throw ahl_filter::Exception("PseudoDifferentiator::init", msg.str());
   }
 
-  q_ = pre_q_ = q;
-  dq_ = pre_dq_ = dq;
+  pre_q_ = q;
+  dq_ = dq;
+  pre_time_ = -1.0;
 }
 
 void PseudoDifferentiator::apply(const Eigen::VectorXd& q)
 {
-  dq_ = coeff1_ * (q - pre_q_) + coeff2_ * pre_dq_;
+  // dq_ holds the previous derivative, so update it in place
+  dq_ = coeff1_ * (q - pre_q_) + coeff2_ * dq_;
+  pre_q_ = q;
+}
+
+void PseudoDifferentiator::apply(const Eigen::VectorXd& q, double time)
+{
+  // The first sample after init() has no previous time stamp
+  double h = (pre_time_ < 0.0) ? period_ : time - pre_time_;
+  if(h <= 0.0)
+  {
+    return;
+  }
+
+  // Discretization of s / (T s + 1) for the actual step h
+  double coeff2 = exp(-h / T_);
+  double coeff1 = (1.0 - coeff2) / h;
 
+  dq_ = coeff1 * (q - pre_q_) + coeff2 * dq_;
   pre_q_ = q;
-  pre_dq_ = dq_;
+  pre_time_ = time;
 }
@@ -0,0 +1,88 @@
+#include "ahl_digital_filter/exception.hpp"
+#include "ahl_digital_filter/savitzky_golay_differentiator.hpp"
+
+using namespace ahl_filter;
+
+SavitzkyGolayDifferentiator::SavitzkyGolayDifferentiator(double period, unsigned int window_size, unsigned int polynomial_order)
+  : head_(0), period_(period)
+{
+  if(period_ <= 0.0)
+  {
+    std::stringstream msg;
+    msg << "Period should be larger than zero.";
+    throw ahl_filter::Exception("SavitzkyGolayDifferentiator::SavitzkyGolayDifferentiator", msg.str());
+  }
+
+  if(polynomial_order < 1 || window_size <= polynomial_order)
+  {
+    std::stringstream msg;
+    msg << "Window size should be larger than polynomial order, and polynomial order should be larger than zero." << std::endl
+        << "  window_size      : " << window_size << std::endl
+        << "  polynomial_order : " << polynomial_order;
+    throw ahl_filter::Exception("SavitzkyGolayDifferentiator::SavitzkyGolayDifferentiator", msg.str());
+  }
+
+  // Least squares fit of c0 + c1 t + ... on t = 0, -1, ..., -(window_size - 1) samples.
+  // The derivative at t = 0 is c1, so coeff_ is the second row of the pseudo inverse.
+  Eigen::MatrixXd A(window_size, polynomial_order + 1);
+  for(unsigned int j = 0; j < window_size; ++j)
+  {
+    double t = -static_cast<double>(j);
+    double tk = 1.0;
+    for(unsigned int k = 0; k <= polynomial_order; ++k)
+    {
+      A.coeffRef(j, k) = tk;
+      tk *= t;
+    }
+  }
+
+  Eigen::MatrixXd pinv = (A.transpose() * A).ldlt().solve(A.transpose());
+  coeff_ = pinv.row(1).transpose() / period_;
+}
+
+void SavitzkyGolayDifferentiator::init(const Eigen::VectorXd& q, const Eigen::VectorXd& dq)
+{
+  if(q.rows() != dq.rows())
+  {
+    std::stringstream msg;
+    msg << "q.rows() != dq.rows()" << std::endl
+        << "  q.rows  : " << q.rows() << std::endl
+        << "  dq.rows : " << dq.rows();
+
+    throw ahl_filter::Exception("SavitzkyGolayDifferentiator::init", msg.str());
+  }
+
+  history_.resize(q.rows(), coeff_.rows());
+  head_ = 0;
+
+  // Fill the window as if the signal had been moving at dq
+  for(unsigned int j = 0; j < coeff_.rows(); ++j)
+  {
+    history_.col((coeff_.rows() - j) % coeff_.rows()) = q - (j * period_) * dq;
+  }
+
+  dq_ = dq;
+}
+
+void SavitzkyGolayDifferentiator::apply(const Eigen::VectorXd& q)
+{
+  if(q.rows() != history_.rows())
+  {
+    std::stringstream msg;
+    msg << "q.rows() != number of channels" << std::endl
+        << "  q.rows   : " << q.rows() << std::endl
+        << "  channels : " << history_.rows();
+
+    throw ahl_filter::Exception("SavitzkyGolayDifferentiator::apply", msg.str());
+  }
+
+  const unsigned int n = coeff_.rows();
+  head_ = (head_ + 1) % n;
+  history_.col(head_) = q;
+
+  dq_.setZero();
+  for(unsigned int j = 0; j < n; ++j)
+  {
+    dq_ += coeff_[j] * history_.col((head_ + n - j) % n);
+  }
+}
@@ -0,0 +1,245 @@
+#include <iostream>
+#include <iomanip>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+#include <algorithm>
+#include "ahl_digital_filter/differentiator.hpp"
+#include "ahl_digital_filter/pseudo_differentiator.hpp"
+#include "ahl_digital_filter/savitzky_golay_differentiator.hpp"
+#include "ahl_digital_filter/fixed_lag_smoother.hpp"
+
+// Compares joint velocity errors of differentiators when the sampling period jitters.
+// Sample k is taken at t[k] = t[k - 1] + period * (1 + jitter * u), where u ~ U(-1, 1).
+
+static const double PERIOD     = 0.001;
+static const double CUTOFF     = 30.0;
+static const double FREQUENCY  = 2.0;
+static const unsigned int DOF  = 7;
+static const unsigned int ITERATIONS = 20000;
+static const unsigned int WINDOW = 15;
+static const unsigned int LAG    = 7;
+
+struct Method
+{
+  std::string name;
+  ahl_filter::DifferentiatorPtr differentiator;
+  bool use_time;
+  unsigned int lag;
+  double dq_error;
+  double ddq_error;
+};
+
+double position(unsigned int i, double t)
+{
+  return sin(2.0 * M_PI * FREQUENCY * t + i);
+}
+
+double velocity(unsigned int i, double t)
+{
+  return 2.0 * M_PI * FREQUENCY * cos(2.0 * M_PI * FREQUENCY * t + i);
+}
+
+double acceleration(unsigned int i, double t)
+{
+  return -4.0 * M_PI * M_PI * FREQUENCY * FREQUENCY * sin(2.0 * M_PI * FREQUENCY * t + i);
+}
+
+void run(double jitter)
+{
+  using namespace ahl_filter;
+  std::srand(0);
+
+  std::vector<Method> method;
+  Method m;
+  m.dq_error = m.ddq_error = 0.0;
+
+  m.name = "pseudo";
+  m.differentiator = DifferentiatorPtr(new PseudoDifferentiator(PERIOD, CUTOFF));
+  m.use_time = false;
+  m.lag = 0;
+  method.push_back(m);
+
+  m.name = "pseudo (time stamp)";
+  m.differentiator = DifferentiatorPtr(new PseudoDifferentiator(PERIOD, CUTOFF));
+  m.use_time = true;
+  method.push_back(m);
+
+  m.name = "savitzky_golay";
+  m.differentiator = DifferentiatorPtr(new SavitzkyGolayDifferentiator(PERIOD, WINDOW, 2));
+  m.use_time = false;
+  method.push_back(m);
+
+  m.name = "fixed_lag_smoother lag 0";
+  m.differentiator = DifferentiatorPtr(new FixedLagSmoother(PERIOD, WINDOW, 0));
+  m.use_time = true;
+  method.push_back(m);
+
+  m.name = "fixed_lag_smoother lag 7";
+  m.differentiator = DifferentiatorPtr(new FixedLagSmoother(PERIOD, WINDOW, LAG));
+  m.lag = LAG;
+  method.push_back(m);
+
+  Eigen::VectorXd q(DOF), dq(DOF), ddq(DOF);
+  for(unsigned int i = 0; i < DOF; ++i)
+  {
+    q[i] = position(i, 0.0);
+    dq[i] = velocity(i, 0.0);
+  }
+  for(unsigned int k = 0; k < method.size(); ++k)
+  {
+    method[k].differentiator->init(q, dq);
+  }
+
+  std::vector<double> t(ITERATIONS + 1, 0.0);
+  unsigned int samples = 0;
+
+  for(unsigned int n = 1; n <= ITERATIONS; ++n)
+  {
+    double u = 2.0 * std::rand() / RAND_MAX - 1.0;
+    t[n] = t[n - 1] + PERIOD * (1.0 + jitter * u);
+
+    for(unsigned int i = 0; i < DOF; ++i)
+    {
+      q[i] = position(i, t[n]);
+    }
+
+    for(unsigned int k = 0; k < method.size(); ++k)
+    {
+      if(method[k].use_time)
+        method[k].differentiator->apply(q, t[n]);
+      else
+        method[k].differentiator->apply(q);
+    }
+
+    // Skip the transient after init()
+    if(n < 1000)
+      continue;
+
+    ++samples;
+    for(unsigned int k = 0; k < method.size(); ++k)
+    {
+      double te = t[n - method[k].lag];
+      method[k].differentiator->copyDerivativeValueTo(dq);
+      method[k].differentiator->copySecondDerivativeValueTo(ddq);
+
+      for(unsigned int i = 0; i < DOF; ++i)
+      {
+        double e = dq[i] - velocity(i, te);
+        method[k].dq_error += e * e;
+        e = ddq[i] - acceleration(i, te);
+        method[k].ddq_error += e * e;
+      }
+    }
+  }
+
+  std::cout << "jitter : " << jitter * 100.0 << " %" << std::endl;
+  for(unsigned int k = 0; k < method.size(); ++k)
+  {
+    std::cout << "  " << std::setw(26) << std::left << method[k].name
+              << " dq rms error : " << std::setw(12) << sqrt(method[k].dq_error / (samples * DOF));
+    if(method[k].name.find("fixed_lag_smoother") != std::string::npos)
+    {
+      std::cout << " ddq rms error : " << sqrt(method[k].ddq_error / (samples * DOF));
+    }
+    std::cout << std::endl;
+  }
+}
+
+// Compares the first WINDOW outputs of FixedLagSmoother after init() with a least-squares
+// fit over the same samples, including the ones init() extrapolated from q and dq.
+bool checkStartup(unsigned int lag, double jitter)
+{
+  using namespace ahl_filter;
+  std::srand(0);
+
+  FixedLagSmoother smoother(PERIOD, WINDOW, lag);
+
+  Eigen::VectorXd q0(DOF), dq0(DOF);
+  for(unsigned int i = 0; i < DOF; ++i)
+  {
+    q0[i] = position(i, 0.0);
+    dq0[i] = velocity(i, 0.0);
+  }
+  smoother.init(q0, dq0);
+
+  std::vector<double> t;
+  std::vector<Eigen::VectorXd> x;
+  Eigen::VectorXd q(DOF), dq(DOF), ddq(DOF);
+  double time = 0.0;
+  double max_error = 0.0;
+
+  for(unsigned int n = 1; n <= WINDOW; ++n)
+  {
+    double u = 2.0 * std::rand() / RAND_MAX - 1.0;
+    time += PERIOD * (1.0 + jitter * u);
+
+    for(unsigned int i = 0; i < DOF; ++i)
+    {
+      q[i] = position(i, time);
+    }
+
+    if(n == 1)
+    {
+      // init() is regarded as one period before the first sample
+      for(unsigned int j = WINDOW - 2; j + 1 > 0; --j)
+      {
+        t.push_back(time - (j + 1) * PERIOD);
+        x.push_back(q0 - (j * PERIOD) * dq0);
+      }
+    }
+    t.push_back(time);
+    x.push_back(q);
+
+    smoother.apply(q, time);
+    smoother.copyDerivativeValueTo(dq);
+    smoother.copySecondDerivativeValueTo(ddq);
+
+    const unsigned int first = t.size() - WINDOW;
+    const double t0 = t[t.size() - 1 - lag];
+    Eigen::MatrixXd A(WINDOW, 3);
+    Eigen::MatrixXd y(WINDOW, DOF);
+    for(unsigned int j = 0; j < WINDOW; ++j)
+    {
+      double s = (t[first + j] - t0) / PERIOD;
+      A(j, 0) = 1.0;
+      A(j, 1) = s;
+      A(j, 2) = s * s;
+      y.row(j) = x[first + j].transpose();
+    }
+    Eigen::MatrixXd c = A.colPivHouseholderQr().solve(y);
+
+    for(unsigned int i = 0; i < DOF; ++i)
+    {
+      double dq_ref = c(1, i) / PERIOD;
+      double ddq_ref = 2.0 * c(2, i) / (PERIOD * PERIOD);
+      max_error = std::max(max_error, fabs(dq[i] - dq_ref) / (1.0 + fabs(dq_ref)));
+      max_error = std::max(max_error, fabs(ddq[i] - ddq_ref) / (1.0 + fabs(ddq_ref)));
+    }
+  }
+
+  bool ok = max_error < 1e-6;
+  std::cout << "  fixed_lag_smoother lag " << lag << " startup, jitter " << jitter * 100.0 << " % : "
+            << (ok ? "ok" : "failed") << " (max relative error " << max_error << ")" << std::endl;
+  return ok;
+}
+
+int main(int argc, char** argv)
+{
+  const double jitter[] = { 0.0, 0.1, 0.2, 0.3 };
+
+  bool ok = true;
+  std::cout << "startup after init()" << std::endl;
+  for(unsigned int i = 0; i < sizeof(jitter) / sizeof(jitter[0]); ++i)
+  {
+    ok = checkStartup(0, jitter[i]) && ok;
+    ok = checkStartup(LAG, jitter[i]) && ok;
+  }
+
+  for(unsigned int i = 0; i < sizeof(jitter) / sizeof(jitter[0]); ++i)
+  {
+    run(jitter[i]);
+  }
+
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,174 @@
+/*********************************************************************
+ *
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2015, Daichi Yoshikawa
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the Daichi Yoshikawa nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Author: Daichi Yoshikawa
+ *
+ *********************************************************************/
+
+#ifndef __KALMAN_FILTER_BASE_POSE_MODEL_HPP
+#define __KALMAN_FILTER_BASE_POSE_MODEL_HPP
+
+#include <cmath>
+#include "kalman_filter/nonlinear_model.hpp"
+
+namespace kf
+{
+
+  /*
+    Planar pose of an omnidirectional base, e.g. a mecanum wheeled base.
+    State   : [x, y, yaw, vx, vy, wz], where the pose is in the world frame
+              and the velocity is in the base frame.
+    Control : [ax, ay], linear acceleration of the base measured by an IMU.
+    Velocity is expressed in the rotating base frame, so it is integrated with
+    the Coriolis term, i.e. dv/dt = a - w x v.
+  */
+  class BasePoseModel : public ProcessModelBase<6, 2>
+  {
+  public:
+    enum { X = 0, Y, YAW, VX, VY, WZ };
+
+    BasePoseModel(double period = 0.01)
+      : period_(period) {}
+
+    void setPeriod(double period)
+    {
+      period_ = period;
+    }
+
+    double getPeriod() const
+    {
+      return period_;
+    }
+
+    void operator()(const StateVector& x, const CtrlVector& u, StateVector& x_next) const
+    {
+      const double c = std::cos(x[YAW]);
+      const double s = std::sin(x[YAW]);
+
+      x_next[X]   = x[X] + (c * x[VX] - s * x[VY]) * period_;
+      x_next[Y]   = x[Y] + (s * x[VX] + c * x[VY]) * period_;
+      x_next[YAW] = x[YAW] + x[WZ] * period_;
+      x_next[VX]  = x[VX] + (u[0] + x[WZ] * x[VY]) * period_;
+      x_next[VY]  = x[VY] + (u[1] - x[WZ] * x[VX]) * period_;
+      x_next[WZ]  = x[WZ];
+    }
+
+    void jacobian(const StateVector& x, const CtrlVector& u, StateMatrix& F) const
+    {
+      const double c = std::cos(x[YAW]);
+      const double s = std::sin(x[YAW]);
+
+      F.setIdentity();
+      F(X, YAW) = -(s * x[VX] + c * x[VY]) * period_;
+      F(X, VX)  =  c * period_;
+      F(X, VY)  = -s * period_;
+      F(Y, YAW) =  (c * x[VX] - s * x[VY]) * period_;
+      F(Y, VX)  =  s * period_;
+      F(Y, VY)  =  c * period_;
+      F(YAW, WZ) = period_;
+      F(VX, VY)  =  x[WZ] * period_;
+      F(VX, WZ)  =  x[VY] * period_;
+      F(VY, VX)  = -x[WZ] * period_;
+      F(VY, WZ)  = -x[VX] * period_;
+    }
+
+    void normalize(StateVector& x) const
+    {
+      x[YAW] = std::atan2(std::sin(x[YAW]), std::cos(x[YAW]));
+    }
+
+    void difference(const StateVector& a, const StateVector& b, StateVector& d) const
+    {
+      d = a - b;
+      d[YAW] = std::atan2(std::sin(d[YAW]), std::cos(d[YAW]));
+    }
+
+    template<int Ns>
+    void mean(const Eigen::Matrix<double, 6, Ns>& X, const Eigen::Matrix<double, Ns, 1>& w, StateVector& x) const
+    {
+      x.noalias() = X * w;
+
+      double s = 0.0;
+      double c = 0.0;
+      for(int i = 0; i < Ns; ++i)
+      {
+        s += w[i] * std::sin(X(YAW, i));
+        c += w[i] * std::cos(X(YAW, i));
+      }
+      x[YAW] = std::atan2(s, c);
+    }
+
+  private:
+    double period_;
+  };
+
+  /*
+    Base velocity [vx, vy, wz] computed from wheel velocities.
+  */
+  class WheelOdometryModel : public MsrModelBase<6, 3>
+  {
+  public:
+    void operator()(const StateVector& x, MsrVector& z) const
+    {
+      z = x.tail<3>();
+    }
+
+    void jacobian(const StateVector& x, MsrMatrix& H) const
+    {
+      H.setZero();
+      H.rightCols<3>().setIdentity();
+    }
+  };
+
+  /*
+    Yaw rate measured by a gyroscope.
+  */
+  class GyroModel : public MsrModelBase<6, 1>
+  {
+  public:
+    void operator()(const StateVector& x, MsrVector& z) const
+    {
+      z[0] = x[BasePoseModel::WZ];
+    }
+
+    void jacobian(const StateVector& x, MsrMatrix& H) const
+    {
+      H.setZero();
+      H(0, BasePoseModel::WZ) = 1.0;
+    }
+  };
+
+}
+
+#endif /* __KALMAN_FILTER_BASE_POSE_MODEL_HPP */
@@ -39,32 +39,138 @@
 #ifndef __KALMAN_FILTER_EXTENDED_KALMAN_FILTER_HPP
 #define __KALMAN_FILTER_EXTENDED_KALMAN_FILTER_HPP
 
-#include <boost/shared_ptr.hpp>
+#include <sstream>
 #include <Eigen/Dense>
 
-#include "kalman_filter/normal_distribution.hpp"
+#include "kalman_filter/exception.hpp"
+#include "kalman_filter/nonlinear_model.hpp"
 
 namespace kf
 {
 
+  /*
+    Extended Kalman filter with fixed size matrices.
+    ProcessModel is derived from ProcessModelBase<Nx, Nu> and provides the analytic Jacobian.
+    Measurement models are passed to correct(), so sensors with different dimensions
+    and rates can be fused into the same state.
+  */
+  template<int Nx, int Nu, class ProcessModel>
   class ExtendedKalmanFilter
   {
   public:
-    void setRandomVariables(const NormalDistributionPtr& state,
-                            const NormalDistributionPtr& uncertainty,
-                            const NormalDistributionPtr& msr_noise);
-    void setModel(
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+    typedef Eigen::Matrix<double, Nx, 1> StateVector;
+    typedef Eigen::Matrix<double, Nu, 1> CtrlVector;
+    typedef Eigen::Matrix<double, Nx, Nx> StateMatrix;
+
+    ExtendedKalmanFilter(const ProcessModel& process_model = ProcessModel())
+      : process_model_(process_model)
+    {
+      mean_.setZero();
+      variance_.setIdentity();
+      uncertainty_.setZero();
+      I_.setIdentity();
+    }
+
+    void setRandomVariables(const StateVector& mean, const StateMatrix& variance,
+                            const StateMatrix& uncertainty_variance)
+    {
+      mean_        = mean;
+      variance_    = variance;
+      uncertainty_ = uncertainty_variance;
+    }
+
+    ProcessModel& getProcessModel()
+    {
+      return process_model_;
+    }
+
+    void predict(const CtrlVector& ctrl_data)
+    {
+      process_model_.jacobian(mean_, ctrl_data, F_);
+      process_model_(mean_, ctrl_data, predicted_mean_);
+      process_model_.normalize(predicted_mean_);
+      mean_ = predicted_mean_;
+
+      FP_.noalias() = F_ * variance_;
+      variance_ = uncertainty_;
+      variance_.noalias() += FP_ * F_.transpose();
+    }
+
+    template<class MsrModel>
+    void correct(const MsrModel& msr_model,
+                 const typename MsrModel::MsrVector& msr_data,
+                 const typename MsrModel::MsrCovariance& msr_noise_variance)
+    {
+      typedef Eigen::Matrix<double, MsrModel::MsrDim, 1> MsrVector;
+      typedef Eigen::Matrix<double, MsrModel::MsrDim, Nx> MsrMatrix;
+      typedef Eigen::Matrix<double, MsrModel::MsrDim, MsrModel::MsrDim> MsrCovariance;
+      typedef Eigen::Matrix<double, Nx, MsrModel::MsrDim> GainMatrix;
+
+      MsrMatrix H;
+      MsrVector predicted_msr;
+      msr_model.jacobian(mean_, H);
+      msr_model(mean_, predicted_msr);
+
+      // S = H P H^T + R and K^T = S^-1 (H P), as S and P are symmetric
+      MsrMatrix HP;
+      HP.noalias() = H * variance_;
+      MsrCovariance S = msr_noise_variance;
+      S.noalias() += HP * H.transpose();
+
+      Eigen::LDLT<MsrCovariance> ldlt(S);
+      if(ldlt.info() != Eigen::Success)
+      {
+        std::stringstream msg;
+        msg << "Failed to factorize the innovation covariance." << std::endl
+            << "          S : " << std::endl << S;
+
+        throw kf::Exception("ExtendedKalmanFilter::correct", msg.str());
+      }
+      MsrMatrix KT = ldlt.solve(HP);
+      GainMatrix K = KT.transpose();
+
+      MsrVector innovation;
+      msr_model.difference(msr_data, predicted_msr, innovation);
+      mean_.noalias() += K * innovation;
+      process_model_.normalize(mean_);
+
+      // Joseph form : P = (I - K H) P (I - K H)^T + K R K^T
+      StateMatrix IKH = I_;
+      IKH.noalias() -= K * H;
+      FP_.noalias() = IKH * variance_;
+      variance_.noalias() = FP_ * IKH.transpose();
+      GainMatrix KR;
+      KR.noalias() = K * msr_noise_variance;
+      variance_.noalias() += KR * K.transpose();
+      variance_ = 0.5 * (variance_ + variance_.transpose()).eval();
+    }
+
+    const StateVector& getMean() const
+    {
+      return mean_;
+    }
+
+    const StateMatrix& getVariance() const
+    {
+      return variance_;
+    }
 
   private:
+    ProcessModel process_model_;
 
+    StateVector mean_;
+    StateMatrix variance_;
+    StateMatrix uncertainty_;
+    StateMatrix I_;
 
-    NormalDistributionPtr state_;
-    NormalDistributionPtr predicted_state_;
-    NormalDistributionPtr uncertainty_;
-    NormalDistributionPtr msr_noise_;
+    // work space of predict() and correct()
+    StateVector predicted_mean_;
+    StateMatrix F_;
+    StateMatrix FP_;
   };
 
-  typedef boost::shared_ptr<ExtendedKalmanFilter> ExtendedKalmanFilterPtr;
 }
 
 #endif /* __KALMAN_FILTER_EXTENDED_KALMAN_FILTER_HPP */
@@ -0,0 +1,210 @@
+/*********************************************************************
+ *
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2015, Daichi Yoshikawa
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the Daichi Yoshikawa nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Author: Daichi Yoshikawa
+ *
+ *********************************************************************/
+
+#ifndef __KALMAN_FILTER_FIXED_KALMAN_FILTER_HPP
+#define __KALMAN_FILTER_FIXED_KALMAN_FILTER_HPP
+
+#include <sstream>
+#include <Eigen/Dense>
+
+#include "kalman_filter/exception.hpp"
+
+namespace kf
+{
+
+  /*
+    Linear Kalman filter whose dimensions are known at compile time.
+    Nx : dimension of state
+    Nu : dimension of control data
+    Nz : dimension of measured data
+
+    All matrices are fixed size and are members of the filter, so estimate() never allocates.
+    The innovation covariance is factorized by LDLT instead of being inverted and
+    the covariance is updated in Joseph form, which keeps it symmetric positive semi-definite.
+  */
+  template<int Nx, int Nu, int Nz>
+  class FixedKalmanFilter
+  {
+  public:
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+    typedef Eigen::Matrix<double, Nx, 1> StateVector;
+    typedef Eigen::Matrix<double, Nu, 1> CtrlVector;
+    typedef Eigen::Matrix<double, Nz, 1> MsrVector;
+    typedef Eigen::Matrix<double, Nx, Nx> StateMatrix;
+    typedef Eigen::Matrix<double, Nx, Nu> CtrlMatrix;
+    typedef Eigen::Matrix<double, Nz, Nx> MsrMatrix;
+    typedef Eigen::Matrix<double, Nz, Nz> MsrCovariance;
+    typedef Eigen::Matrix<double, Nx, Nz> GainMatrix;
+
+    FixedKalmanFilter()
+    {
+      mean_.setZero();
+      variance_.setIdentity();
+      predicted_mean_.setZero();
+      predicted_variance_.setIdentity();
+      uncertainty_.setZero();
+      msr_noise_.setIdentity();
+      A_.setIdentity();
+      B_.setZero();
+      C_.setZero();
+      I_.setIdentity();
+    }
+
+    void setRandomVariables(const StateVector& mean, const StateMatrix& variance,
+                            const StateMatrix& uncertainty_variance,
+                            const MsrCovariance& msr_noise_variance)
+    {
+      mean_        = mean;
+      variance_    = variance;
+      uncertainty_ = uncertainty_variance;
+      msr_noise_   = msr_noise_variance;
+
+      predicted_mean_     = mean_;
+      predicted_variance_ = variance_;
+    }
+
+    void setLinearModel(const StateMatrix& coeff_of_mean,
+                        const CtrlMatrix& coeff_of_ctrl_data,
+                        const MsrMatrix& coeff_of_msr_data)
+    {
+      A_ = coeff_of_mean;
+      B_ = coeff_of_ctrl_data;
+      C_ = coeff_of_msr_data;
+    }
+
+    void predict(const CtrlVector& ctrl_data)
+    {
+      predicted_mean_.noalias() = A_ * mean_;
+      predicted_mean_.noalias() += B_ * ctrl_data;
+
+      AP_.noalias() = A_ * variance_;
+      predicted_variance_ = uncertainty_;
+      predicted_variance_.noalias() += AP_ * A_.transpose();
+    }
+
+    void correct(const MsrVector& msr_data)
+    {
+      // S = C P C^T + R and K^T = S^-1 (C P), as S and P are symmetric
+      CP_.noalias() = C_ * predicted_variance_;
+      S_ = msr_noise_;
+      S_.noalias() += CP_ * C_.transpose();
+
+      ldlt_.compute(S_);
+      if(ldlt_.info() != Eigen::Success)
+      {
+        std::stringstream msg;
+        msg << "Failed to factorize the innovation covariance." << std::endl
+            << "          S : " << std::endl << S_;
+
+        throw kf::Exception("FixedKalmanFilter::correct", msg.str());
+      }
+      KT_ = ldlt_.solve(CP_);
+      K_ = KT_.transpose();
+
+      innovation_ = msr_data;
+      innovation_.noalias() -= C_ * predicted_mean_;
+      mean_ = predicted_mean_;
+      mean_.noalias() += K_ * innovation_;
+
+      // Joseph form : P = (I - K C) P (I - K C)^T + K R K^T
+      IKC_ = I_;
+      IKC_.noalias() -= K_ * C_;
+      AP_.noalias() = IKC_ * predicted_variance_;
+      variance_.noalias() = AP_ * IKC_.transpose();
+      KR_.noalias() = K_ * msr_noise_;
+      variance_.noalias() += KR_ * K_.transpose();
+
+      // removes the asymmetry caused by rounding errors
+      variance_ = 0.5 * (variance_ + variance_.transpose()).eval();
+    }
+
+    void estimate(const CtrlVector& ctrl_data, const MsrVector& msr_data)
+    {
+      this->predict(ctrl_data);
+      this->correct(msr_data);
+    }
+
+    const StateVector& getMean() const
+    {
+      return mean_;
+    }
+
+    const StateMatrix& getVariance() const
+    {
+      return variance_;
+    }
+
+    const StateVector& getPredictedMean() const
+    {
+      return predicted_mean_;
+    }
+
+    const StateMatrix& getPredictedVariance() const
+    {
+      return predicted_variance_;
+    }
+
+  private:
+    StateVector mean_;
+    StateMatrix variance_;
+    StateVector predicted_mean_;
+    StateMatrix predicted_variance_;
+    StateMatrix uncertainty_;
+    MsrCovariance msr_noise_;
+
+    StateMatrix A_;
+    CtrlMatrix B_;
+    MsrMatrix C_;
+    StateMatrix I_;
+
+    // work space of estimate()
+    StateMatrix AP_;
+    MsrMatrix CP_;
+    MsrCovariance S_;
+    Eigen::LDLT<MsrCovariance> ldlt_;
+    MsrMatrix KT_;
+    GainMatrix K_;
+    GainMatrix KR_;
+    StateMatrix IKC_;
+    MsrVector innovation_;
+  };
+
+}
+
+#endif /* __KALMAN_FILTER_FIXED_KALMAN_FILTER_HPP */
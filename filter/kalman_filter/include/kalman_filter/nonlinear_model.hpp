@@ -0,0 +1,118 @@
+/*********************************************************************
+ *
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2015, Daichi Yoshikawa
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the Daichi Yoshikawa nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Author: Daichi Yoshikawa
+ *
+ *********************************************************************/
+
+#ifndef __KALMAN_FILTER_NONLINEAR_MODEL_HPP
+#define __KALMAN_FILTER_NONLINEAR_MODEL_HPP
+
+#include <Eigen/Dense>
+
+namespace kf
+{
+
+  /*
+    Base of process models for ExtendedKalmanFilter and UnscentedKalmanFilter.
+    Derived models have to implement
+      void operator()(const StateVector& x, const CtrlVector& u, StateVector& x_next) const;
+    and, only for the ExtendedKalmanFilter,
+      void jacobian(const StateVector& x, const CtrlVector& u, StateMatrix& F) const;
+
+    The other functions can be hidden by derived models whose state contains angles.
+    The filters call them through the derived type, so no virtual call is involved.
+  */
+  template<int Nx, int Nu>
+  class ProcessModelBase
+  {
+  public:
+    enum { StateDim = Nx, CtrlDim = Nu };
+
+    typedef Eigen::Matrix<double, Nx, 1> StateVector;
+    typedef Eigen::Matrix<double, Nu, 1> CtrlVector;
+    typedef Eigen::Matrix<double, Nx, Nx> StateMatrix;
+
+    // called after the state has been changed, e.g. to wrap angles
+    void normalize(StateVector& x) const {}
+
+    // d = a - b
+    void difference(const StateVector& a, const StateVector& b, StateVector& d) const
+    {
+      d = a - b;
+    }
+
+    // weighted mean of the columns of X
+    template<int Ns>
+    void mean(const Eigen::Matrix<double, Nx, Ns>& X, const Eigen::Matrix<double, Ns, 1>& w, StateVector& x) const
+    {
+      x.noalias() = X * w;
+    }
+  };
+
+  /*
+    Base of measurement models.
+    Derived models have to implement
+      void operator()(const StateVector& x, MsrVector& z) const;
+    and, only for the ExtendedKalmanFilter,
+      void jacobian(const StateVector& x, MsrMatrix& H) const;
+  */
+  template<int Nx, int Nz>
+  class MsrModelBase
+  {
+  public:
+    enum { StateDim = Nx, MsrDim = Nz };
+
+    typedef Eigen::Matrix<double, Nx, 1> StateVector;
+    typedef Eigen::Matrix<double, Nz, 1> MsrVector;
+    typedef Eigen::Matrix<double, Nz, Nx> MsrMatrix;
+    typedef Eigen::Matrix<double, Nz, Nz> MsrCovariance;
+
+    // d = a - b
+    void difference(const MsrVector& a, const MsrVector& b, MsrVector& d) const
+    {
+      d = a - b;
+    }
+
+    // weighted mean of the columns of Z
+    template<int Ns>
+    void mean(const Eigen::Matrix<double, Nz, Ns>& Z, const Eigen::Matrix<double, Ns, 1>& w, MsrVector& z) const
+    {
+      z.noalias() = Z * w;
+    }
+  };
+
+}
+
+#endif /* __KALMAN_FILTER_NONLINEAR_MODEL_HPP */
@@ -0,0 +1,270 @@
+/*********************************************************************
+ *
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2015, Daichi Yoshikawa
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the Daichi Yoshikawa nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Author: Daichi Yoshikawa
+ *
+ *********************************************************************/
+
+#ifndef __KALMAN_FILTER_UNSCENTED_KALMAN_FILTER_HPP
+#define __KALMAN_FILTER_UNSCENTED_KALMAN_FILTER_HPP
+
+#include <cmath>
+#include <sstream>
+#include <Eigen/Dense>
+
+#include "kalman_filter/exception.hpp"
+#include "kalman_filter/nonlinear_model.hpp"
+
+namespace kf
+{
+
+  /*
+    Unscented Kalman filter with fixed size matrices.
+    The 2 * Nx + 1 sigma points are stored as the columns of a single matrix,
+    so the mean and the covariance are computed as matrix products.
+    Weights depend only on alpha, beta and kappa and are computed in setParameters().
+    The covariance is corrected in Joseph form with the statistically linearized
+    measurement matrix H = Pxz^T P^-1, which keeps it symmetric positive semi-definite
+    even when the weight of the central sigma point is negative.
+  */
+  template<int Nx, int Nu, class ProcessModel>
+  class UnscentedKalmanFilter
+  {
+  public:
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+    enum { Ns = 2 * Nx + 1 };
+
+    typedef Eigen::Matrix<double, Nx, 1> StateVector;
+    typedef Eigen::Matrix<double, Nu, 1> CtrlVector;
+    typedef Eigen::Matrix<double, Nx, Nx> StateMatrix;
+    typedef Eigen::Matrix<double, Nx, Ns> SigmaMatrix;
+    typedef Eigen::Matrix<double, Ns, 1> WeightVector;
+
+    UnscentedKalmanFilter(const ProcessModel& process_model = ProcessModel())
+      : process_model_(process_model)
+    {
+      mean_.setZero();
+      variance_.setIdentity();
+      uncertainty_.setZero();
+      this->setParameters();
+    }
+
+    // alpha = 1e-3 keeps the sigma points close to the mean, so that wrapped angles and
+    // other local nonlinearities of the models are sampled where the linearization holds.
+    // It makes wc[0] close to -1 / alpha^2 though, so the weighted sums alone can lose
+    // positive definiteness. Use alpha closer to 1 if predict() reports that.
+    void setParameters(double alpha = 1e-3, double beta = 2.0, double kappa = 0.0)
+    {
+      double lambda = alpha * alpha * (Nx + kappa) - Nx;
+      gamma_ = std::sqrt(Nx + lambda);
+
+      wm_.setConstant(0.5 / (Nx + lambda));
+      wc_ = wm_;
+      wm_[0] = lambda / (Nx + lambda);
+      wc_[0] = wm_[0] + 1.0 - alpha * alpha + beta;
+    }
+
+    void setRandomVariables(const StateVector& mean, const StateMatrix& variance,
+                            const StateMatrix& uncertainty_variance)
+    {
+      mean_        = mean;
+      variance_    = variance;
+      uncertainty_ = uncertainty_variance;
+    }
+
+    ProcessModel& getProcessModel()
+    {
+      return process_model_;
+    }
+
+    void predict(const CtrlVector& ctrl_data)
+    {
+      this->computeSigmaPoints("UnscentedKalmanFilter::predict");
+
+      StateVector x;
+      for(int i = 0; i < Ns; ++i)
+      {
+        x = sigma_.col(i);
+        process_model_(x, ctrl_data, predicted_mean_);
+        process_model_.normalize(predicted_mean_);
+        sigma_.col(i) = predicted_mean_;
+      }
+
+      process_model_.mean(sigma_, wm_, mean_);
+      process_model_.normalize(mean_);
+
+      for(int i = 0; i < Ns; ++i)
+      {
+        x = sigma_.col(i);
+        process_model_.difference(x, mean_, predicted_mean_);
+        dx_.col(i) = predicted_mean_;
+      }
+
+      variance_ = uncertainty_;
+      variance_.noalias() += dx_ * wc_.asDiagonal() * dx_.transpose();
+    }
+
+    template<class MsrModel>
+    void correct(const MsrModel& msr_model,
+                 const typename MsrModel::MsrVector& msr_data,
+                 const typename MsrModel::MsrCovariance& msr_noise_variance)
+    {
+      typedef Eigen::Matrix<double, MsrModel::MsrDim, 1> MsrVector;
+      typedef Eigen::Matrix<double, MsrModel::MsrDim, MsrModel::MsrDim> MsrCovariance;
+      typedef Eigen::Matrix<double, MsrModel::MsrDim, Ns> MsrSigmaMatrix;
+      typedef Eigen::Matrix<double, Nx, MsrModel::MsrDim> GainMatrix;
+
+      this->computeSigmaPoints("UnscentedKalmanFilter::correct");
+
+      MsrSigmaMatrix Z;
+      MsrVector z;
+      StateVector x;
+      for(int i = 0; i < Ns; ++i)
+      {
+        x = sigma_.col(i);
+        msr_model(x, z);
+        Z.col(i) = z;
+      }
+
+      MsrVector predicted_msr;
+      msr_model.mean(Z, wm_, predicted_msr);
+
+      MsrSigmaMatrix dz;
+      for(int i = 0; i < Ns; ++i)
+      {
+        msr_model.difference(Z.col(i), predicted_msr, z);
+        dz.col(i) = z;
+
+        x = sigma_.col(i);
+        process_model_.difference(x, mean_, predicted_mean_);
+        dx_.col(i) = predicted_mean_;
+      }
+
+      MsrCovariance S = msr_noise_variance;
+      S.noalias() += dz * wc_.asDiagonal() * dz.transpose();
+      GainMatrix Pxz;
+      Pxz.noalias() = dx_ * wc_.asDiagonal() * dz.transpose();
+
+      // K = Pxz S^-1, solved as K^T = S^-1 Pxz^T since S is symmetric
+      Eigen::LDLT<MsrCovariance> ldlt(S);
+      if(ldlt.info() != Eigen::Success)
+      {
+        std::stringstream msg;
+        msg << "Failed to factorize the innovation covariance." << std::endl
+            << "          S : " << std::endl << S;
+
+        throw kf::Exception("UnscentedKalmanFilter::correct", msg.str());
+      }
+      GainMatrix K = ldlt.solve(Pxz.transpose()).transpose();
+
+      MsrVector innovation;
+      msr_model.difference(msr_data, predicted_msr, innovation);
+      mean_.noalias() += K * innovation;
+      process_model_.normalize(mean_);
+
+      // Joseph form : P = (I - K H) P (I - K H)^T + K R K^T, where H^T = P^-1 Pxz
+      // is solved with the factorization of P made for the sigma points
+      Eigen::Matrix<double, MsrModel::MsrDim, Nx> H = llt_.solve(Pxz).transpose();
+      StateMatrix IKH = StateMatrix::Identity();
+      IKH.noalias() -= K * H;
+      StateMatrix AP;
+      AP.noalias() = IKH * variance_;
+      variance_.noalias() = AP * IKH.transpose();
+      GainMatrix KR;
+      KR.noalias() = K * msr_noise_variance;
+      variance_.noalias() += KR * K.transpose();
+
+      // removes the asymmetry caused by rounding errors
+      variance_ = 0.5 * (variance_ + variance_.transpose()).eval();
+    }
+
+    const StateVector& getMean() const
+    {
+      return mean_;
+    }
+
+    const StateMatrix& getVariance() const
+    {
+      return variance_;
+    }
+
+  private:
+    void computeSigmaPoints(const std::string& src)
+    {
+      llt_.compute(variance_);
+      if(llt_.info() != Eigen::Success)
+      {
+        std::stringstream msg;
+        msg << "Variance is not positive definite." << std::endl
+            << "          P : " << std::endl << variance_;
+
+        throw kf::Exception(src, msg.str());
+      }
+      sqrt_variance_ = gamma_ * llt_.matrixL().toDenseMatrix();
+
+      sigma_.col(0) = mean_;
+      for(int i = 0; i < Nx; ++i)
+      {
+        predicted_mean_ = mean_ + sqrt_variance_.col(i);
+        process_model_.normalize(predicted_mean_);
+        sigma_.col(1 + i) = predicted_mean_;
+
+        predicted_mean_ = mean_ - sqrt_variance_.col(i);
+        process_model_.normalize(predicted_mean_);
+        sigma_.col(1 + Nx + i) = predicted_mean_;
+      }
+    }
+
+    ProcessModel process_model_;
+
+    StateVector mean_;
+    StateMatrix variance_;
+    StateMatrix uncertainty_;
+
+    double gamma_;
+    WeightVector wm_;
+    WeightVector wc_;
+
+    // work space of predict() and correct()
+    Eigen::LLT<StateMatrix> llt_;
+    StateVector predicted_mean_;
+    StateMatrix sqrt_variance_;
+    SigmaMatrix sigma_;
+    SigmaMatrix dx_;
+  };
+
+}
+
+#endif /* __KALMAN_FILTER_UNSCENTED_KALMAN_FILTER_HPP */
@@ -40,11 +40,16 @@ void KalmanFilter::estimate(const Eigen::MatrixXd& ctrl_data, const Eigen::Matri
   Eigen::MatrixXd variance = A_ * state_->getVariance() * A_.transpose() + uncertainty_->getVariance();
   predicted_state_->set(mean, variance);
 
-  Eigen::MatrixXd kalman_gain = variance * C_.transpose() * (C_ * variance * C_.transpose() + msr_noise_->getVariance()).inverse();
+  // K^T = S^-1 (C P) is solved by LDLT, as S and P are symmetric
+  Eigen::MatrixXd innovation_variance = C_ * variance * C_.transpose() + msr_noise_->getVariance();
+  Eigen::MatrixXd kalman_gain = innovation_variance.ldlt().solve(C_ * variance).transpose();
 
   Eigen::MatrixXd I = Eigen::MatrixXd::Identity(variance.rows(), variance.cols());
   mean = mean + kalman_gain * (msr_data - C_ * mean);
-  variance = (I - kalman_gain * C_) * variance;
+
+  // Joseph form keeps the variance symmetric positive semi-definite
+  Eigen::MatrixXd IKC = I - kalman_gain * C_;
+  variance = IKC * variance * IKC.transpose() + kalman_gain * msr_noise_->getVariance() * kalman_gain.transpose();
 
   state->set(mean, variance);
   state_ = state;
@@ -0,0 +1,154 @@
+#include <iostream>
+#include <fstream>
+#include <ctime>
+#include <cmath>
+
+#include <ros/ros.h>
+
+#include "kalman_filter/extended_kalman_filter.hpp"
+#include "kalman_filter/unscented_kalman_filter.hpp"
+#include "kalman_filter/base_pose_model.hpp"
+#include "kalman_filter/exception.hpp"
+
+static const double SAMPLING_TIME = 0.01;
+static const double RADIUS        = 1.0;
+static const double SPEED         = 0.5;
+static const double ITERATIONS    = 3000;
+
+static const double ACC_NOISE     = 0.05;
+static const double ODOM_NOISE    = 0.02;
+static const double GYRO_NOISE    = 0.01;
+
+double gaussian(double sigma)
+{
+  double u1 = (std::rand() + 1.0) / (RAND_MAX + 2.0);
+  double u2 = (std::rand() + 1.0) / (RAND_MAX + 2.0);
+  return sigma * std::sqrt(-2.0 * std::log(u1)) * std::cos(2.0 * M_PI * u2);
+}
+
+void updateTrueState(unsigned int idx, kf::BasePoseModel::StateVector& x)
+{
+  double wz = SPEED / RADIUS;
+  double yaw = wz * SAMPLING_TIME * idx;
+
+  x << RADIUS * std::sin(yaw), RADIUS * (1.0 - std::cos(yaw)), std::atan2(std::sin(yaw), std::cos(yaw)),
+       SPEED, 0.0, wz;
+}
+
+int main(int argc, char** argv)
+{
+  std::srand(static_cast<unsigned int>(std::time(NULL)));
+
+  try
+  {
+    ros::init(argc, argv, "base_pose_test");
+    ros::NodeHandle nh;
+
+    std::ofstream ofs1("ekf_state.txt");
+    if(ofs1.fail())
+    {
+      ROS_ERROR_STREAM("Could not open file.");
+      return -1;
+    }
+
+    std::ofstream ofs2("ukf_state.txt");
+    if(ofs2.fail())
+    {
+      ROS_ERROR_STREAM("Could not open file.");
+      return -1;
+    }
+
+    using namespace kf;
+    typedef ExtendedKalmanFilter<6, 2, BasePoseModel> BasePoseEKF;
+    typedef UnscentedKalmanFilter<6, 2, BasePoseModel> BasePoseUKF;
+
+    BasePoseModel model(SAMPLING_TIME);
+    BasePoseEKF ekf(model);
+    BasePoseUKF ukf(model);
+
+    BasePoseModel::StateVector init_mean;
+    BasePoseModel::StateMatrix init_variance;
+    BasePoseModel::StateMatrix uncertainty_variance;
+
+    init_mean.setZero();
+    init_variance = 0.01 * BasePoseModel::StateMatrix::Identity();
+    uncertainty_variance.setZero();
+    uncertainty_variance.diagonal() << 1e-6, 1e-6, 1e-6, 1e-4, 1e-4, 1e-4;
+
+    ekf.setRandomVariables(init_mean, init_variance, uncertainty_variance);
+    ukf.setRandomVariables(init_mean, init_variance, uncertainty_variance);
+
+    WheelOdometryModel odometry;
+    WheelOdometryModel::MsrCovariance odom_variance
+      = ODOM_NOISE * ODOM_NOISE * WheelOdometryModel::MsrCovariance::Identity();
+
+    GyroModel gyro;
+    GyroModel::MsrCovariance gyro_variance;
+    gyro_variance << GYRO_NOISE * GYRO_NOISE;
+
+    BasePoseModel::StateVector x;
+    BasePoseModel::StateVector ekf_error;
+    BasePoseModel::StateVector ukf_error;
+    ekf_error.setZero();
+    ukf_error.setZero();
+
+    for(unsigned int i = 1; i < ITERATIONS; ++i)
+    {
+      ::updateTrueState(i, x);
+
+      BasePoseModel::CtrlVector u;
+      u << ::gaussian(ACC_NOISE), SPEED * x[BasePoseModel::WZ] + ::gaussian(ACC_NOISE);
+
+      WheelOdometryModel::MsrVector z_odom;
+      z_odom << x[BasePoseModel::VX] + ::gaussian(ODOM_NOISE),
+                x[BasePoseModel::VY] + ::gaussian(ODOM_NOISE),
+                x[BasePoseModel::WZ] + ::gaussian(ODOM_NOISE);
+
+      GyroModel::MsrVector z_gyro;
+      z_gyro << x[BasePoseModel::WZ] + ::gaussian(GYRO_NOISE);
+
+      ekf.predict(u);
+      ekf.correct(odometry, z_odom, odom_variance);
+      ekf.correct(gyro, z_gyro, gyro_variance);
+
+      ukf.predict(u);
+      ukf.correct(odometry, z_odom, odom_variance);
+      ukf.correct(gyro, z_gyro, gyro_variance);
+
+      BasePoseModel::StateVector d;
+      model.difference(ekf.getMean(), x, d);
+      ekf_error += d.cwiseProduct(d);
+      model.difference(ukf.getMean(), x, d);
+      ukf_error += d.cwiseProduct(d);
+
+      for(unsigned int j = 0; j < ekf.getMean().rows(); ++j)
+      {
+        ofs1 << ekf.getMean().coeff(j) << ", ";
+      }
+      ofs1 << std::endl;
+
+      for(unsigned int j = 0; j < ukf.getMean().rows(); ++j)
+      {
+        ofs2 << ukf.getMean().coeff(j) << ", ";
+      }
+      ofs2 << std::endl;
+    }
+
+    std::cout << "EKF RMS error : " << (ekf_error / ITERATIONS).cwiseSqrt().transpose() << std::endl;
+    std::cout << "UKF RMS error : " << (ukf_error / ITERATIONS).cwiseSqrt().transpose() << std::endl;
+  }
+  catch(kf::Exception& e)
+  {
+    ROS_ERROR_STREAM(e.what());
+  }
+  catch(std::exception& e)
+  {
+    ROS_ERROR_STREAM(e.what());
+  }
+  catch(...)
+  {
+    ROS_ERROR_STREAM("Unknown exception was thrown.");
+  }
+
+  return 0;
+}
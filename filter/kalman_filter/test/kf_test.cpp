@@ -5,6 +5,7 @@
 #include <ros/ros.h>
 
 #include "kalman_filter/kalman_filter.hpp"
+#include "kalman_filter/fixed_kalman_filter.hpp"
 #include "kalman_filter/normal_distribution.hpp"
 #include "kalman_filter/exception.hpp"
 
@@ -92,6 +93,13 @@ int main(int argc, char** argv)
       return -1;
     }
 
+    std::ofstream ofs3("fixed_state.txt");
+    if(ofs3.fail())
+    {
+      ROS_ERROR_STREAM("Could not open file.");
+      return -1;
+    }
+
     using namespace kf;
     KalmanFilterPtr kalman_filter = KalmanFilterPtr(new KalmanFilter());
 
@@ -125,6 +133,11 @@ int main(int argc, char** argv)
 
     kalman_filter->setLinearModel(A, B, C);
 
+    typedef FixedKalmanFilter<2, 2, 2> FixedKalmanFilter2;
+    FixedKalmanFilter2 fixed_kalman_filter;
+    fixed_kalman_filter.setRandomVariables(init_mean, init_variance, uncertainty_variance, msr_noise_variance);
+    fixed_kalman_filter.setLinearModel(A, B, C);
+
     for(unsigned int i = 0; i < ITERATIONS; ++i)
     {
       Eigen::MatrixXd u;
@@ -133,6 +146,7 @@ int main(int argc, char** argv)
 
       ::updateCtrlDataAndMsrData(i, u, z);
       kalman_filter->estimate(u, z, state);
+      fixed_kalman_filter.estimate(u, z);
 
       for(unsigned int i = 0; i < kalman_filter->getPredictedState()->getMean().rows(); ++i)
       {
@@ -145,6 +159,12 @@ int main(int argc, char** argv)
         ofs2 << kalman_filter->getState()->getMean().coeff(i) << ", ";
       }
       ofs2 << std::endl;
+
+      for(unsigned int i = 0; i < fixed_kalman_filter.getMean().rows(); ++i)
+      {
+        ofs3 << fixed_kalman_filter.getMean().coeff(i) << ", ";
+      }
+      ofs3 << std::endl;
     }
   }
   catch(kf::Exception& e)
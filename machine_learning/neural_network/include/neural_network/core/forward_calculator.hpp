@@ -54,9 +54,14 @@ namespace nn
   public:
     ForwardCalculator(const ActivationPtr& activation);
     void calculate(const Eigen::MatrixXd& input, std::vector<LayerPtr>& layer);
+    // Each column of input is one sample. Layer outputs are kept in buffers
+    // which are reused while the batch size stays the same, and reallocated
+    // whenever it changes.
+    void calculate(const Eigen::MatrixXd& input, const std::vector<LayerPtr>& layer, Eigen::MatrixXd& output);
 
   private:
     ActivationPtr activation_;
+    std::vector<Eigen::MatrixXd> batch_neuron_;
   };
 
   typedef boost::shared_ptr<ForwardCalculator> ForwardCalculatorPtr;
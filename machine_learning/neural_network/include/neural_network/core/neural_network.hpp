@@ -67,6 +67,15 @@ namespace nn
     }
 
     Eigen::MatrixXd getOutput(Eigen::MatrixXd& input);
+    // Batched version of getOutput. Each column of input is one sample and
+    // the same column of output is its result. No allocation is done once
+    // output and internal buffers have been sized for the batch.
+    void getOutput(const Eigen::MatrixXd& input, Eigen::MatrixXd& output);
+
+    bool initialized() const
+    {
+      return initialized_;
+    }
 
   private:
     void save(const std::string& yaml);
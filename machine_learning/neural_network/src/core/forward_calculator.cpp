@@ -63,3 +63,50 @@ void ForwardCalculator::calculate(const Eigen::MatrixXd& input, std::vector<Laye
     }
   }
 }
+
+void ForwardCalculator::calculate(const Eigen::MatrixXd& input, const std::vector<LayerPtr>& layer, Eigen::MatrixXd& output)
+{
+  const unsigned int batch_size = input.cols();
+  const unsigned int input_rows = layer[0]->getNeuronSize() - 1;
+
+  if(input.rows() != input_rows)
+  {
+    std::stringstream msg;
+    msg << "Input size is not correct." << std::endl
+        << "        input rows : " << input.rows() << std::endl
+        << "        layer size : " << input_rows;
+    throw nn::Exception("ForwardCalculator::calculate", msg.str());
+  }
+
+  if(batch_neuron_.size() != layer.size())
+  {
+    batch_neuron_.resize(layer.size());
+  }
+
+  const Eigen::MatrixXd* pre = &input;
+
+  for(unsigned int i = 1; i < layer.size(); ++i)
+  {
+    const Eigen::MatrixXd& w = layer[i]->getPre()->getW();
+    const unsigned int pre_rows = w.cols() - 1; // the last column is bias
+    Eigen::MatrixXd& neuron = (i == layer.size() - 1) ? output : batch_neuron_[i];
+
+    neuron.resize(w.rows(), batch_size);
+    neuron.noalias() = w.leftCols(pre_rows) * (*pre);
+    neuron.colwise() += w.col(pre_rows);
+
+    double* data = neuron.data();
+    const unsigned int size = neuron.size();
+    for(unsigned int j = 0; j < size; ++j)
+    {
+      data[j] = activation_->getOutput(data[j]);
+    }
+
+    pre = &neuron;
+  }
+
+  if(layer.size() == 1)
+  {
+    output = input;
+  }
+}
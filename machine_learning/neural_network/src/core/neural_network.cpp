@@ -140,6 +140,20 @@ Eigen::MatrixXd NeuralNetwork::getOutput(Eigen::MatrixXd& input)
   return layer_[layer_.size() - 1]->getNeuron().block(0, 0, layer_[layer_.size() - 1]->getNeuron().rows() - 1, 1);
 }
 
+void NeuralNetwork::getOutput(const Eigen::MatrixXd& input, Eigen::MatrixXd& output)
+{
+  if(initialized_ == false)
+  {
+    std::stringstream msg;
+    msg << "NeuralNetwork is not initialized." << std::endl
+        << "        Please call NeuralNetwork::init(const ConfigPtr& config).";
+
+    throw nn::Exception("NeuralNetwork::getOutput", msg.str());
+  }
+
+  forward_calculator_->calculate(input, layer_, output);
+}
+
 void NeuralNetwork::save(const std::string& yaml)
 {
   std::ofstream ofs(yaml.c_str());
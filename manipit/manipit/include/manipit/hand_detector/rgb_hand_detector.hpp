@@ -39,6 +39,7 @@
 #ifndef __MANIPIT_HAND_DETECTOR_RGB_HAND_DETECTOR_HPP
 #define __MANIPIT_HAND_DETECTOR_RGB_HAND_DETECTOR_HPP
 
+#include <cv_wrapper/hsv_mask.hpp>
 #include "manipit/hand_detector/hand_detector.hpp"
 
 namespace manipit
@@ -47,10 +48,12 @@ namespace manipit
   class RGBHandDetector : public HandDetector
   {
   public:
+    RGBHandDetector();
 
     virtual bool detect(const cv::Mat& rgb, const cv::Mat& depth, cv::Rect& hand_roi);
 
   private:
+    cv_wrapper::HSVMaskPtr mask_;
 
   };
 
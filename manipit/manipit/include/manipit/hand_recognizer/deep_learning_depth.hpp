@@ -51,9 +51,23 @@ namespace manipit
     DeepLearningDepth();
   private:
     bool recognizePose(const cv::Mat& rgb, const cv::Mat& depth, geometry_msgs::PoseStamped& pose);
+    // All rois are packed into the columns of one input matrix and evaluated by one forward calculation.
+    bool recognizePoses(const cv::Mat& rgb, const cv::Mat& depth,
+                        const std::vector<cv::Rect>& rois, std::vector<geometry_msgs::PoseStamped>& poses);
+    void setInput(const cv::Mat& depth, unsigned int idx);
+    void getPose(unsigned int idx, geometry_msgs::PoseStamped& pose);
 
     nn::ConfigPtr config_;
     nn::NeuralNetworkPtr nn_;
+
+    int img_size_;
+    double hand_size_;
+    cv::Mat resized_;
+    Eigen::MatrixXd input_;
+    Eigen::MatrixXd output_;
+
+    std::vector<cv::Rect> single_roi_;
+    std::vector<geometry_msgs::PoseStamped> single_pose_;
   };
 
 }
@@ -59,6 +59,22 @@ namespace manipit
     virtual ~HandRecognizer() {}
 
     virtual bool recognizePose(const cv::Mat& rgb, const cv::Mat& depth, geometry_msgs::PoseStamped& pose) { return false; }
+
+    // Evaluate several candidate regions (e.g. ROIs at different scales) of the same frame.
+    // poses[i] is the result for rois[i].
+    virtual bool recognizePoses(const cv::Mat& rgb, const cv::Mat& depth,
+                                const std::vector<cv::Rect>& rois, std::vector<geometry_msgs::PoseStamped>& poses)
+    {
+      poses.resize(rois.size());
+
+      for(unsigned int i = 0; i < rois.size(); ++i)
+      {
+        if(!this->recognizePose(rgb(rois[i]), depth(rois[i]), poses[i]))
+          return false;
+      }
+
+      return true;
+    }
   };
 
   typedef boost::shared_ptr<HandRecognizer> HandRecognizerPtr;
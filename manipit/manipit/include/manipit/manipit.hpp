@@ -40,6 +40,7 @@
 #define __MANIPIT_MANIPIT_HPP
 
 #include <boost/shared_ptr.hpp>
+#include <boost/thread.hpp>
 #include <opencv2/opencv.hpp>
 
 #include <ros/ros.h>
@@ -61,6 +62,7 @@ namespace manipit
   {
   public:
     Manipit();
+    ~Manipit();
 
   private:
     void receivedImages(const sensor_msgs::ImageConstPtr& msg_rgb,
@@ -68,6 +70,16 @@ namespace manipit
     void received(bool& received_image);
     void publishTransform();
 
+    // pipeline mode : the callback only stores the latest frame and the worker processes it
+    void storeLatestImages(const sensor_msgs::ImageConstPtr& msg_rgb,
+                           const sensor_msgs::ImageConstPtr& msg_depth);
+    void processLatestImages();
+    void resizeAndBlur(const cv::Mat& src_rgb, const cv::Mat& src_depth, const cv::Rect& search_region);
+    cv::Rect getSearchRegion() const;
+    bool recognize(const cv::Rect& search_region);
+    void updateVisualization();
+    void visualizationTimerCB(const ros::TimerEvent&);
+
     typedef message_filters::sync_policies::ApproximateTime<sensor_msgs::Image, sensor_msgs::Image> ApproximateTime;
     typedef message_filters::Synchronizer<ApproximateTime> Synchronizer;
     typedef boost::shared_ptr<Synchronizer> SynchronizerPtr;
@@ -89,9 +101,26 @@ namespace manipit
     HandRecognizerPtr recognizer_;
 
     geometry_msgs::PoseStamped pose_;
+    cv::Rect hand_roi_;
+    bool hand_detected_;
 
     ros::Publisher pub_pose_;
 
+    bool pipeline_;
+    bool visualize_;
+
+    boost::thread worker_;
+    boost::mutex latest_mutex_;
+    boost::condition_variable latest_cond_;
+    sensor_msgs::ImageConstPtr latest_rgb_;
+    sensor_msgs::ImageConstPtr latest_depth_;
+    bool exit_worker_;
+
+    boost::mutex visualization_mutex_;
+    cv::Mat visualized_rgb_;
+    cv::Mat visualized_depth_;
+    ros::Timer visualization_timer_;
+
     bool publish_transform_;
     std::string parent_frame_id_;
   };
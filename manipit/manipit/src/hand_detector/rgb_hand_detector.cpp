@@ -1,23 +1,35 @@
 #include <cv_wrapper/utils.hpp>
 #include <cv_wrapper/hsv_mask.hpp>
 #include <cv_wrapper/hsv_mask_param.hpp>
+#include <cv_wrapper/rect.hpp>
 #include "manipit/hand_detector/rgb_hand_detector.hpp"
 
 using namespace manipit;
 
-bool RGBHandDetector::detect(const cv::Mat& rgb, const cv::Mat& depth, cv::Rect& hand_roi)
+RGBHandDetector::RGBHandDetector()
 {
   using namespace cv_wrapper;
-  HSVMask mask(rgb.rows, rgb.cols);
+  mask_ = HSVMaskPtr(new HSVMask(240, 320));
+
   HSVMaskParamPtr skin = HSVMaskParamPtr(new HSVMaskParam(0, 30, 50, 255, 50, 255));
-  mask.add(skin);
+  mask_->add(skin);
+}
+
+bool RGBHandDetector::detect(const cv::Mat& rgb, const cv::Mat& depth, cv::Rect& hand_roi)
+{
+  mask_->getMaskFromBGR(rgb, true, 2, 2);
+
+  cv::Mat mask = mask_->get();
+  if(cv::countNonZero(mask) == 0)
+    return false;
 
-  std::vector<cv::Mat> hsv;
-  convertRGBToHSV(rgb, hsv);
+  cv_wrapper::Rect rect;
+  rect.bound(mask, 0, false);
 
-  mask.getMask(hsv, true, 2, 2);
+  if(rect.isZero())
+    return false;
 
-  cv::imshow("mask", mask.get());
+  hand_roi = rect.getRect();
 
   return true;
 }
@@ -1,9 +1,12 @@
+#include <limits>
+#include <algorithm>
 #include <ros/ros.h>
 #include "manipit/hand_recognizer/deep_learning_depth.hpp"
 
 using namespace manipit;
 
 DeepLearningDepth::DeepLearningDepth()
+  : single_roi_(1), single_pose_(1)
 {
   ros::NodeHandle local_nh("deep_learning_depth");
 
@@ -12,6 +15,10 @@ DeepLearningDepth::DeepLearningDepth()
 
   std::string config_path;
   local_nh.param<std::string>("deep_learning_depth/config_path", config_path, "");
+  local_nh.param<int>("deep_learning_depth/img_size", img_size_, 32);
+  local_nh.param<double>("deep_learning_depth/hand_size", hand_size_, 0.2);
+
+  resized_.create(img_size_, img_size_, CV_32FC1);
 
   //config_->init(config_path);
   //nn_->init(config_);
@@ -19,5 +26,83 @@ DeepLearningDepth::DeepLearningDepth()
 
 bool DeepLearningDepth::recognizePose(const cv::Mat& rgb, const cv::Mat& depth, geometry_msgs::PoseStamped& pose)
 {
+  single_roi_[0] = cv::Rect(0, 0, depth.cols, depth.rows);
+
+  if(!this->recognizePoses(rgb, depth, single_roi_, single_pose_))
+    return false;
+
+  pose.pose = single_pose_[0].pose;
   return true;
 }
+
+bool DeepLearningDepth::recognizePoses(const cv::Mat& rgb, const cv::Mat& depth,
+                                       const std::vector<cv::Rect>& rois, std::vector<geometry_msgs::PoseStamped>& poses)
+{
+  if(!nn_->initialized())
+    return false;
+
+  input_.resize(img_size_ * img_size_, rois.size());
+  for(unsigned int i = 0; i < rois.size(); ++i)
+  {
+    this->setInput(depth(rois[i]), i);
+  }
+
+  nn_->getOutput(input_, output_);
+  if(output_.rows() < 7 || output_.cols() != static_cast<int>(rois.size()))
+  {
+    ROS_ERROR_STREAM_THROTTLE(1.0, "Output of neural network is not [x, y, z, qx, qy, qz, qw] per roi.");
+    return false;
+  }
+
+  poses.resize(rois.size());
+  for(unsigned int i = 0; i < rois.size(); ++i)
+  {
+    this->getPose(i, poses[i]);
+  }
+
+  return true;
+}
+
+// Depth is normalized by the nearest valid point and the hand size as in train_with_cg.
+void DeepLearningDepth::setInput(const cv::Mat& depth, unsigned int idx)
+{
+  cv::resize(depth, resized_, resized_.size(), 0, 0, cv::INTER_NEAREST);
+
+  float min = std::numeric_limits<float>::max();
+  for(int y = 0; y < resized_.rows; ++y)
+  {
+    const float* ptr = resized_.ptr<float>(y);
+    for(int x = 0; x < resized_.cols; ++x)
+    {
+      if(ptr[x] > 0.0 && ptr[x] < min)
+        min = ptr[x];
+    }
+  }
+
+  double* col = input_.col(idx).data();
+  for(int y = 0; y < resized_.rows; ++y)
+  {
+    const float* ptr = resized_.ptr<float>(y);
+    for(int x = 0; x < resized_.cols; ++x)
+    {
+      double value = 0.0;
+      if(ptr[x] > 0.0) // NaN is also rejected here
+      {
+        value = std::min((ptr[x] - min) / hand_size_, 1.0);
+      }
+      col[y * resized_.cols + x] = value;
+    }
+  }
+}
+
+// output : [x, y, z, qx, qy, qz, qw]
+void DeepLearningDepth::getPose(unsigned int idx, geometry_msgs::PoseStamped& pose)
+{
+  pose.pose.position.x    = output_.coeff(0, idx);
+  pose.pose.position.y    = output_.coeff(1, idx);
+  pose.pose.position.z    = output_.coeff(2, idx);
+  pose.pose.orientation.x = output_.coeff(3, idx);
+  pose.pose.orientation.y = output_.coeff(4, idx);
+  pose.pose.orientation.z = output_.coeff(5, idx);
+  pose.pose.orientation.w = output_.coeff(6, idx);
+}
@@ -9,7 +9,7 @@
 using namespace manipit;
 
 Manipit::Manipit()
-  : received_rgb_(false), received_depth_(false)
+  : received_rgb_(false), received_depth_(false), hand_detected_(false), exit_worker_(false)
 {
   ros::NodeHandle nh;
   ros::NodeHandle local_nh("~");
@@ -21,6 +21,8 @@ Manipit::Manipit()
   local_nh.param<bool>("publish_transform", publish_transform_, true);
   local_nh.param<std::string>("frame_id/parent", parent_frame_id_, "world");
   local_nh.param<std::string>("frame_id/child", pose_.header.frame_id, "hand");
+  local_nh.param<bool>("pipeline", pipeline_, false);
+  local_nh.param<bool>("visualize", visualize_, true);
 
   sub_rgb_.subscribe(it, "/camera/rgb/image_rect_color", 1, transport);
   sub_depth_.subscribe(it, "/camera/depth/image_rect", 1, transport);
@@ -35,8 +37,6 @@ Manipit::Manipit()
   sync_.reset(
     new Synchronizer(ApproximateTime(queue_size), sub_rgb_, sub_depth_));
 
-  sync_->registerCallback(boost::bind(&Manipit::receivedImages, this, _1, _2));
-
   rgb_.create(240, 320, CV_8UC3);
   depth_.create(rgb_.rows, rgb_.cols, CV_32FC1);
 
@@ -44,6 +44,35 @@ Manipit::Manipit()
   recognizer_ = HandRecognizerPtr(new DeepLearningDepth());
 
   pub_pose_ = nh.advertise<geometry_msgs::PoseStamped>("manipit/hand/pose", 10);
+
+  if(pipeline_)
+  {
+    sync_->registerCallback(boost::bind(&Manipit::storeLatestImages, this, _1, _2));
+    worker_ = boost::thread(&Manipit::processLatestImages, this);
+
+    if(visualize_)
+    {
+      visualization_timer_ = nh.createTimer(ros::Duration(0.033333), &Manipit::visualizationTimerCB, this);
+    }
+  }
+  else
+  {
+    sync_->registerCallback(boost::bind(&Manipit::receivedImages, this, _1, _2));
+  }
+}
+
+Manipit::~Manipit()
+{
+  {
+    boost::mutex::scoped_lock lock(latest_mutex_);
+    exit_worker_ = true;
+  }
+  latest_cond_.notify_all();
+
+  if(worker_.joinable())
+  {
+    worker_.join();
+  }
 }
 
 void Manipit::receivedImages(const sensor_msgs::ImageConstPtr& msg_rgb,
@@ -57,18 +86,154 @@ void Manipit::receivedImages(const sensor_msgs::ImageConstPtr& msg_rgb,
 
   cv::medianBlur(rgb_, rgb_, 5);
 
-  cv::Rect hand_roi;
-
-  if(!detector_->detect(rgb_, depth_, hand_roi))
+  if(!this->recognize(cv::Rect(0, 0, rgb_.cols, rgb_.rows)))
   {
     ROS_INFO_STREAM("Hand was not detected.");
     return;
   }
 
-  cv::Mat rgb_roi   = rgb_(hand_roi);
-  cv::Mat depth_roi = depth_(hand_roi);
+  if(!visualize_)
+    return;
 
-  recognizer_->recognizePose(rgb_roi, depth_roi, pose_);
+  cv::imshow("rgb", rgb_);
+  cv::imshow("depth", depth_);
+  if(cv::waitKey(2) == 27)
+  {
+    exit(0);
+  }
+}
+
+void Manipit::storeLatestImages(const sensor_msgs::ImageConstPtr& msg_rgb,
+                                const sensor_msgs::ImageConstPtr& msg_depth)
+{
+  {
+    boost::mutex::scoped_lock lock(latest_mutex_);
+    latest_rgb_   = msg_rgb;
+    latest_depth_ = msg_depth;
+  }
+  latest_cond_.notify_one();
+}
+
+void Manipit::processLatestImages()
+{
+  while(true)
+  {
+    sensor_msgs::ImageConstPtr msg_rgb;
+    sensor_msgs::ImageConstPtr msg_depth;
+
+    {
+      boost::mutex::scoped_lock lock(latest_mutex_);
+      while(!exit_worker_ && !latest_rgb_)
+      {
+        latest_cond_.wait(lock);
+      }
+
+      if(exit_worker_)
+        return;
+
+      // Older frames were overwritten in storeLatestImages.
+      msg_rgb.swap(latest_rgb_);
+      msg_depth.swap(latest_depth_);
+    }
+
+    try
+    {
+      cv_bridge::CvImageConstPtr rgb_ptr   = cv_bridge::toCvShare(msg_rgb, sensor_msgs::image_encodings::BGR8);
+      cv_bridge::CvImageConstPtr depth_ptr = cv_bridge::toCvShare(msg_depth, sensor_msgs::image_encodings::TYPE_32FC1);
+
+      cv::Rect search_region = this->getSearchRegion();
+      this->resizeAndBlur(rgb_ptr->image, depth_ptr->image, search_region);
+
+      if(!this->recognize(search_region))
+      {
+        ROS_DEBUG_STREAM("Hand was not detected.");
+      }
+
+      if(visualize_)
+      {
+        this->updateVisualization();
+      }
+    }
+    catch(cv_bridge::Exception& e)
+    {
+      ROS_ERROR_STREAM(e.what());
+    }
+    catch(cv::Exception& e)
+    {
+      ROS_ERROR_STREAM(e.what());
+    }
+  }
+}
+
+// Maps a region of the working images onto a source image of a different size.
+static cv::Rect scaleRegion(const cv::Rect& region, const cv::Size& working, const cv::Size& src)
+{
+  const double scale_x = static_cast<double>(src.width) / working.width;
+  const double scale_y = static_cast<double>(src.height) / working.height;
+
+  cv::Rect src_region(
+    cvFloor(region.x * scale_x), cvFloor(region.y * scale_y),
+    cvCeil(region.width * scale_x), cvCeil(region.height * scale_y));
+
+  return src_region & cv::Rect(0, 0, src.width, src.height);
+}
+
+// Only the search region is resized from the shared source images and blurred.
+void Manipit::resizeAndBlur(const cv::Mat& src_rgb, const cv::Mat& src_depth, const cv::Rect& search_region)
+{
+  // RGB and depth images may come at different resolutions.
+  const cv::Rect rgb_region   = scaleRegion(search_region, rgb_.size(), src_rgb.size());
+  const cv::Rect depth_region = scaleRegion(search_region, depth_.size(), src_depth.size());
+
+  cv::Mat rgb_search   = rgb_(search_region);
+  cv::Mat depth_search = depth_(search_region);
+
+  cv::resize(src_rgb(rgb_region), rgb_search, rgb_search.size());
+  cv::resize(src_depth(depth_region), depth_search, depth_search.size());
+
+  cv::medianBlur(rgb_search, rgb_search, 5);
+}
+
+// The hand is searched around the last detected region, or in the whole image if it was lost.
+cv::Rect Manipit::getSearchRegion() const
+{
+  cv::Rect whole(0, 0, rgb_.cols, rgb_.rows);
+
+  if(!hand_detected_)
+    return whole;
+
+  cv::Rect search_region(
+    hand_roi_.x - hand_roi_.width / 2, hand_roi_.y - hand_roi_.height / 2,
+    hand_roi_.width * 2, hand_roi_.height * 2);
+
+  search_region &= whole;
+  if(search_region.area() == 0)
+    return whole;
+
+  return search_region;
+}
+
+bool Manipit::recognize(const cv::Rect& search_region)
+{
+  cv::Mat rgb_search   = rgb_(search_region);
+  cv::Mat depth_search = depth_(search_region);
+
+  cv::Rect hand_roi;
+
+  hand_detected_ = detector_->detect(rgb_search, depth_search, hand_roi);
+  if(!hand_detected_)
+    return false;
+
+  hand_roi_ = hand_roi + search_region.tl();
+
+  cv::Mat rgb_roi   = rgb_(hand_roi_);
+  cv::Mat depth_roi = depth_(hand_roi_);
+
+  if(!recognizer_->recognizePose(rgb_roi, depth_roi, pose_))
+  {
+    ROS_DEBUG_STREAM("Hand pose was not recognized.");
+    return true;
+  }
 
   pub_pose_.publish(pose_);
 
@@ -77,8 +242,31 @@ void Manipit::receivedImages(const sensor_msgs::ImageConstPtr& msg_rgb,
     publishTransform();
   }
 
-  cv::imshow("rgb", rgb_);
-  cv::imshow("depth", depth_);
+  return true;
+}
+
+void Manipit::updateVisualization()
+{
+  boost::mutex::scoped_lock lock(visualization_mutex_);
+
+  rgb_.copyTo(visualized_rgb_);
+  depth_.copyTo(visualized_depth_);
+
+  if(hand_detected_)
+  {
+    cv::rectangle(visualized_rgb_, hand_roi_, cv::Scalar(0, 0, 255));
+  }
+}
+
+void Manipit::visualizationTimerCB(const ros::TimerEvent&)
+{
+  boost::mutex::scoped_lock lock(visualization_mutex_);
+
+  if(visualized_rgb_.empty())
+    return;
+
+  cv::imshow("rgb", visualized_rgb_);
+  cv::imshow("depth", visualized_depth_);
   if(cv::waitKey(2) == 27)
   {
     exit(0);
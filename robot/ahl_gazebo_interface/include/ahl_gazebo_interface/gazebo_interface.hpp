@@ -51,10 +51,11 @@
 #include <boost/thread.hpp>
 #include <Eigen/Dense>
 #include <ros/ros.h>
-#include <gazebo_msgs/AddJoint.h>
+#include <gazebo_msgs/AddJointBlock.h>
 #include <gazebo_msgs/StartTimer.h>
 #include <gazebo_msgs/LinkStates.h>
-#include <ahl_utils/shared_memory.hpp>
+#include <ahl_utils/lock_step.hpp>
+#include <ahl_utils/joint_block.hpp>
 
 namespace ahl_gazebo_if
 {
@@ -63,6 +64,7 @@ namespace ahl_gazebo_if
   static const std::string TOPIC_SUB_LINK_STATES  = "/gazebo/set_link_states";
 
   /// This class enables to communicate with gazebo simulator through ahl_utils::shared memory.
+  /// All registered joints are exchanged with gazebo at once through a single ahl_utils::JointBlock.
   class GazeboInterface
   {
   public:
@@ -71,7 +73,7 @@ namespace ahl_gazebo_if
     /// Destructor
     ~GazeboInterface();
 
-    /// Register joint name to get joint angle or apply torque
+    /// Register joint name to get joint angle or apply torque. Joints are sent to gazebo when connect is called.
     /// @param name Name of joint you'd like to use (mostly like pr2::shoulder_pan)
     /// @param effort_time Defines how long you'd like to apply effort to the joint when you call applyJointEfforts.
     void addJoint(const std::string& name, double effort_time = 0.010);
@@ -79,8 +81,18 @@ namespace ahl_gazebo_if
     /// This is unnecessary. 
     void setDuration(double duration);
 
-    /// Initialize and connect the communication with gazebo simulator
-    void connect();
+    /// Initialize and connect the communication with gazebo simulator. Registers all joints as a single block.
+    /// @param lock_step Step gazebo in lock-step with this controller. Gazebo then waits for applyJointEfforts after every physics step.
+    /// @param timeout Gazebo stops waiting for the controller once it did not answer for this long [s]
+    void connect(bool lock_step = false, double timeout = 1.0);
+
+    /// Block until gazebo has written the joint states of the next physics step. Only for lock-step mode.
+    /// @param timeout Maximum time to wait [s]
+    /// @return true : new joint states are available, false : timed out
+    bool waitJointStates(double timeout = 1.0);
+
+    /// Get simulation time of the joint states received by waitJointStates
+    double getSimulationTime();
 
     /// Check gazebo simulator has already written some value in shared memory.
     /// @return true : already written, false : not written yet
@@ -107,14 +119,23 @@ namespace ahl_gazebo_if
     /// @return Joint state vector representing joint angles or displacements
     const Eigen::VectorXd& getJointStates();
 
+    /// Get joint angles, joint velocities and the simulation time they were sampled at, all from the same physics step
+    /// @param q Joint angles/displacements
+    /// @param dq Joint velocities reported by gazebo
+    /// @param time Simulation time [s]
+    void getJointStates(Eigen::VectorXd& q, Eigen::VectorXd& dq, double& time);
+
+    /// Get joint angles, joint velocities, efforts gazebo applied in the last physics step and the simulation time
+    /// @param q Joint angles/displacements
+    /// @param dq Joint velocities reported by gazebo
+    /// @param tau Efforts applied to the joints in the last physics step
+    /// @param time Simulation time [s]
+    void getJointStates(Eigen::VectorXd& q, Eigen::VectorXd& dq, Eigen::VectorXd& tau, double& time);
+
   private:
     /// Mutex
     boost::mutex mutex_;
 
-    /// Key : Joint name
-    /// Value : Torque value 
-    std::map<std::string, double> joint_map_;
-
     /// Key : Joint name
     /// Value : Joint index representing the registration order
     std::map<std::string, int> joint_to_idx_;
@@ -122,12 +143,24 @@ namespace ahl_gazebo_if
     /// Joint name list
     std::vector<std::string> joint_list_;
 
+    /// Effort time of the block, the longest one passed to addJoint
+    double effort_time_;
+
     /// Number of registered joint
     unsigned int joint_num_;
 
     /// Joint angle/displacement vector
     Eigen::VectorXd q_;
 
+    /// Joint velocity vector
+    Eigen::VectorXd dq_;
+
+    /// Efforts gazebo applied in the last physics step
+    Eigen::VectorXd tau_applied_;
+
+    /// Simulation time of q_ and dq_
+    double time_;
+
     /// Unnecessary variable
     ros::Duration duration_;
 
@@ -144,16 +177,14 @@ namespace ahl_gazebo_if
     /// ROS service client to call service server provided by gazebo_ros to start writing joint angles/displacements
     ros::ServiceClient client_start_timer_;
 
-    /// ROS service client to call service server provided by gazebo_ros to register joint to use
-    ros::ServiceClient client_add_joint_;
+    /// ROS service client to call service server provided by gazebo_ros to register joints to use
+    ros::ServiceClient client_add_joint_block_;
 
-    /// Key : Joint name
-    /// Value : Torque to apply
-    std::map<std::string, ahl_utils::SharedMemory<double>::Ptr > joint_effort_;
+    /// Joint angles, velocities and torques shared with gazebo
+    ahl_utils::JointBlock::Ptr joint_block_;
 
-    /// Key : Joint name
-    /// Value : Joint angle/displacement
-    std::map<std::string, ahl_utils::SharedMemory<double>::Ptr > joint_state_;
+    /// Step synchronization with gazebo, only used in lock-step mode
+    ahl_utils::LockStep::Ptr lock_step_;
   };
 
   typedef boost::shared_ptr<GazeboInterface> GazeboInterfacePtr;
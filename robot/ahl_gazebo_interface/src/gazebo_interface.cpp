@@ -36,14 +36,24 @@
  *
  *********************************************************************/
 
+#include <algorithm>
 #include "ahl_gazebo_interface/gazebo_interface.hpp"
 #include "ahl_gazebo_interface/exception.hpp"
 
 using namespace ahl_gazebo_if;
 
+namespace
+{
+  // Each interface in a process gets its own joint block
+  unsigned int joint_block_count = 0;
+}
+
 GazeboInterface::GazeboInterface()
-  : duration_(ros::Duration(0.1)),
-    subscribed_joint_states_(true)
+  : effort_time_(0.0),
+    joint_num_(0),
+    time_(0.0),
+    duration_(ros::Duration(0.1)),
+    subscribed_joint_states_(false)
 {
   ros::NodeHandle local_nh("~");
   std::string name;
@@ -52,37 +62,40 @@ GazeboInterface::GazeboInterface()
 
   ros::NodeHandle nh;
   client_start_timer_ = nh.serviceClient<gazebo_msgs::StartTimer>("/gazebo/start_timer");
-  client_add_joint_   = nh.serviceClient<gazebo_msgs::AddJoint>("/gazebo/add_joint");
+  client_add_joint_block_ = nh.serviceClient<gazebo_msgs::AddJointBlock>("/gazebo/add_joint_block");
 }
 
 GazeboInterface::~GazeboInterface()
 {
-  this->applyJointEfforts(Eigen::VectorXd::Zero(joint_list_.size()));
+  if(joint_block_)
+  {
+    this->applyJointEfforts(Eigen::VectorXd::Zero(joint_list_.size()));
+  }
+
+  if(lock_step_)
+  {
+    lock_step_->detach();
+  }
 }
 
 void GazeboInterface::addJoint(const std::string& name, double effort_time)
 {
-  joint_map_[name] = 0.0;
+  if(joint_block_)
+  {
+    std::stringstream msg;
+    msg << "Could not add joint : " << name << std::endl
+        << "  Joints have to be added before connect is called.";
+    throw ahl_gazebo_if::Exception("GazeboInterface::addJoint", msg.str());
+  }
 
   if(joint_to_idx_.find(name) == joint_to_idx_.end())
   {
     unsigned int size = joint_to_idx_.size();
     joint_to_idx_[name] = size;
     joint_list_.push_back(name);
-
-    joint_effort_[name] = ahl_utils::SharedMemory<double>::Ptr(new ahl_utils::SharedMemory<double>(name + "::effort"));
-    joint_state_[name]  = ahl_utils::SharedMemory<double>::Ptr(new ahl_utils::SharedMemory<double>(name + "::state"));
-
-    gazebo_msgs::AddJoint srv;
-    srv.request.name = name;
-    srv.request.effort_time = effort_time;
-    if(!client_add_joint_.call(srv))
-    {
-      std::stringstream msg;
-      msg << "Could not add joint : " << name;
-      throw ahl_gazebo_if::Exception("GazeboInterface::addJoint", msg.str());
-    }
   }
+
+  effort_time_ = std::max(effort_time_, effort_time);
 }
 
 void GazeboInterface::setDuration(double duration)
@@ -90,24 +103,86 @@ void GazeboInterface::setDuration(double duration)
   duration_ = ros::Duration(duration);
 }
 
-void GazeboInterface::connect()
+void GazeboInterface::connect(bool lock_step, double timeout)
 {
-  joint_num_ = joint_map_.size();
-  q_ = Eigen::VectorXd::Zero(joint_num_);
+  joint_num_ = joint_list_.size();
+  q_  = Eigen::VectorXd::Zero(joint_num_);
+  dq_ = Eigen::VectorXd::Zero(joint_num_);
+  tau_applied_ = Eigen::VectorXd::Zero(joint_num_);
+
+  std::string block_name = "ahl_joints" + ros::this_node::getName();
+  std::replace(block_name.begin(), block_name.end(), '/', '_');
+  std::stringstream ss;
+  ss << block_name << "_" << joint_block_count++;
+  block_name = ss.str();
+
+  gazebo_msgs::AddJointBlock add_joint_block;
+  add_joint_block.request.name = block_name;
+  add_joint_block.request.joints = joint_list_;
+  add_joint_block.request.effort_time = effort_time_;
+  if(!client_add_joint_block_.call(add_joint_block) || !add_joint_block.response.success)
+  {
+    std::stringstream msg;
+    msg << "Could not add joint block : " << block_name << std::endl
+        << "  " << add_joint_block.response.status_message;
+    throw ahl_gazebo_if::Exception("GazeboInterface::connect", msg.str());
+  }
+
+  joint_block_ = ahl_utils::JointBlock::Ptr(new ahl_utils::JointBlock(block_name, joint_num_));
 
   gazebo_msgs::StartTimer srv;
+  srv.request.lock_step = lock_step;
+  srv.request.lock_step_timeout = timeout;
   if(!client_start_timer_.call(srv))
   {
     throw ahl_gazebo_if::Exception("GazeboInterface::connect", "Could not start timer.");
   }
 
+  if(lock_step)
+  {
+    lock_step_ = ahl_utils::LockStep::Ptr(new ahl_utils::LockStep("ahl_lock_step"));
+    lock_step_->attach();
+  }
+
   ros::NodeHandle nh;
   pub_link_states_ = nh.advertise<gazebo_msgs::LinkStates>("/gazebo/set_link_states", 1);
 }
 
+bool GazeboInterface::waitJointStates(double timeout)
+{
+  if(!lock_step_)
+  {
+    throw ahl_gazebo_if::Exception("GazeboInterface::waitJointStates", "Not connected in lock-step mode.");
+  }
+
+  // gazebo detaches the controller if it missed a step
+  if(!lock_step_->isAttached())
+  {
+    lock_step_->attach();
+  }
+
+  return lock_step_->waitStates(timeout);
+}
+
+double GazeboInterface::getSimulationTime()
+{
+  if(!lock_step_)
+  {
+    throw ahl_gazebo_if::Exception("GazeboInterface::getSimulationTime", "Not connected in lock-step mode.");
+  }
+
+  return lock_step_->getTime();
+}
+
 bool GazeboInterface::subscribed()
 {
   boost::mutex::scoped_lock lock(mutex_);
+
+  if(!subscribed_joint_states_ && joint_block_ && joint_num_ > 0)
+  {
+    subscribed_joint_states_ = joint_block_->readStates(q_.data(), dq_.data(), tau_applied_.data(), time_);
+  }
+
   return subscribed_joint_states_;
 }
 
@@ -123,16 +198,19 @@ void GazeboInterface::applyJointEfforts(const Eigen::VectorXd& tau)
     throw ahl_gazebo_if::Exception("ahl_gazebo_if::GazeboInterface::applyJointEfforts", msg.str());
   }
 
-  for(unsigned int i = 0; i < joint_list_.size(); ++i)
+  if(!joint_block_)
   {
-    if(joint_to_idx_.find(joint_list_[i]) == joint_to_idx_.end())
-    {
-      std::stringstream msg;
-      msg << joint_list_[i] << " was not found in joint_to_idx_.";
-      throw ahl_gazebo_if::Exception("ahl_gazebo_if::GazeboInterface::applyJointEffots", msg.str());
-    }
+    throw ahl_gazebo_if::Exception("ahl_gazebo_if::GazeboInterface::applyJointEfforts", "Not connected.");
+  }
 
-    joint_effort_[joint_list_[i]]->write(tau[i]);
+  if(joint_num_ > 0)
+  {
+    joint_block_->writeEfforts(tau.data());
+  }
+
+  if(lock_step_)
+  {
+    lock_step_->notifyEfforts();
   }
 }
 
@@ -217,18 +295,53 @@ void GazeboInterface::rotateLink(const std::vector<Eigen::Quaternion<double> >&
 
 const Eigen::VectorXd& GazeboInterface::getJointStates()
 {
-  for(unsigned int i = 0; i < joint_list_.size(); ++i)
+  if(!joint_block_)
   {
-    if(joint_to_idx_.find(joint_list_[i]) == joint_to_idx_.end())
-    {
-      std::stringstream msg;
-      msg << joint_list_[i] << " was not found in joint_to_idx_.";
-      throw ahl_gazebo_if::Exception("ahl_gazebo_if::GazeboInterface::getJointStates", msg.str());
-    }
-
-    joint_state_[joint_list_[i]]->read(q_[i]);
+    throw ahl_gazebo_if::Exception("ahl_gazebo_if::GazeboInterface::getJointStates", "Not connected.");
   }
 
   boost::mutex::scoped_lock lock(mutex_);
+  if(joint_num_ > 0)
+  {
+    joint_block_->readStates(q_.data(), dq_.data(), tau_applied_.data(), time_);
+  }
+
   return q_;
 }
+
+void GazeboInterface::getJointStates(Eigen::VectorXd& q, Eigen::VectorXd& dq, double& time)
+{
+  if(!joint_block_)
+  {
+    throw ahl_gazebo_if::Exception("ahl_gazebo_if::GazeboInterface::getJointStates", "Not connected.");
+  }
+
+  boost::mutex::scoped_lock lock(mutex_);
+  if(joint_num_ > 0)
+  {
+    joint_block_->readStates(q_.data(), dq_.data(), tau_applied_.data(), time_);
+  }
+
+  q    = q_;
+  dq   = dq_;
+  time = time_;
+}
+
+void GazeboInterface::getJointStates(Eigen::VectorXd& q, Eigen::VectorXd& dq, Eigen::VectorXd& tau, double& time)
+{
+  if(!joint_block_)
+  {
+    throw ahl_gazebo_if::Exception("ahl_gazebo_if::GazeboInterface::getJointStates", "Not connected.");
+  }
+
+  boost::mutex::scoped_lock lock(mutex_);
+  if(joint_num_ > 0)
+  {
+    joint_block_->readStates(q_.data(), dq_.data(), tau_applied_.data(), time_);
+  }
+
+  q    = q_;
+  dq   = dq_;
+  tau  = tau_applied_;
+  time = time_;
+}
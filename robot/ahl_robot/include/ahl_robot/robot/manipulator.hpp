@@ -43,6 +43,7 @@
 #include <vector>
 #include <Eigen/StdVector>
 #include <ahl_digital_filter/differentiator.hpp>
+#include <ahl_digital_filter/filter_bank.hpp>
 #include "ahl_robot/definition.hpp"
 #include "ahl_robot/robot/link.hpp"
 
@@ -71,7 +72,16 @@ namespace ahl_robot
     }
     void setDifferentiatorCutoffFrequency(double cutoff_frequency)
     {
-      cutoff_frequency_ = cutoff_frequency;
+      differentiator_param_.cutoff_frequency = cutoff_frequency;
+    }
+    void setDifferentiatorParam(const ahl_filter::DifferentiatorParam& param)
+    {
+      differentiator_param_ = param;
+    }
+    // Filters applied in series to the joint velocity estimated by the differentiator
+    void addVelocityFilter(const ahl_filter::FilterParam& param)
+    {
+      velocity_filter_param_.push_back(param);
     }
 
     void setMobilityType(mobility::Type type);
@@ -98,6 +108,7 @@ namespace ahl_robot
     Eigen::VectorXd q; // Generalized coordinates
     Eigen::VectorXd pre_q; // Generalized coordinates
     Eigen::VectorXd dq; // Velocity of generalized coordinates
+    Eigen::VectorXd ddq; // Acceleration of generalized coordinates, only estimated by fixed_lag_smoother
 
     Eigen::Vector3d xp;  // xyz position
     Eigen::Quaternion<double> xr;  // Quaternion
@@ -119,8 +130,10 @@ namespace ahl_robot
     VectorVector3d Pin_; // End-effector position w.r.t i-th link w.r.t link
 
     ahl_filter::DifferentiatorPtr differentiator_;
+    ahl_filter::FilterBankPtr velocity_filter_;
     double update_rate_;
-    double cutoff_frequency_;
+    ahl_filter::DifferentiatorParam differentiator_param_;
+    std::vector<ahl_filter::FilterParam> velocity_filter_param_;
     bool updated_joint_;
 
     mobility::Type mobility_type_;
@@ -80,6 +80,15 @@ namespace ahl_robot
     static const std::string DIFFERENTIATOR                  = "differentiator";
     static const std::string DIFFERENTIATOR_UPDATE_RATE      = "update_rate";
     static const std::string DIFFERENTIATOR_CUTOFF_FREQUENCY = "cutoff_frequency";
+    static const std::string DIFFERENTIATOR_TYPE             = "type";
+    static const std::string DIFFERENTIATOR_WINDOW_SIZE      = "window_size";
+    static const std::string DIFFERENTIATOR_POLYNOMIAL_ORDER = "polynomial_order";
+    static const std::string DIFFERENTIATOR_LAG              = "lag";
+    static const std::string DIFFERENTIATOR_FILTERS          = "filters";
+    static const std::string FILTER_TYPE                     = "type";
+    static const std::string FILTER_FREQUENCY                = "frequency";
+    static const std::string FILTER_ORDER                    = "order";
+    static const std::string FILTER_Q                        = "q";
     static const std::string MOBILITY                        = "mobility";
     static const std::string MOBILITY_UPDATE_RATE            = "update_rate";
     static const std::string MOBILITY_TYPE                   = "type";
@@ -148,6 +148,8 @@ namespace ahl_robot
 
     // API for whole body control
     void update(const Eigen::VectorXd& q);
+    // Use measured velocities instead of differentiating q
+    void update(const Eigen::VectorXd& q, const Eigen::VectorXd& dq);
     void computeBasicJacobian();
     void computeMassMatrix();
 
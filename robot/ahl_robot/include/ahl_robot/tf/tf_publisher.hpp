@@ -45,35 +45,120 @@
 #ifndef __AHL_ROBOT_TF_PUBLISHER_HPP
 #define __AHL_ROBOT_TF_PUBLISHER_HPP
 
+#include <map>
+#include <vector>
 #include <boost/shared_ptr.hpp>
+#include <boost/thread.hpp>
 #include <geometry_msgs/TransformStamped.h>
-#include <tf2/LinearMath/Quaternion.h>
 #include <tf2_ros/transform_broadcaster.h>
+#include <tf2_ros/static_transform_broadcaster.h>
 #include "ahl_robot/robot/robot.hpp"
 
 namespace ahl_robot
 {
 
   /// Publish tf depending on the state of ahl_robot::Robot
+  /// All moving frames of a cycle are sent as a single tf2_msgs::TFMessage.
+  /// Fixed joints and frames at center of mass are sent once as static transforms.
   class TfPublisher
   {
   public:
     /// Constructor
     TfPublisher();
+    /// Destructor
+    ~TfPublisher();
 
-    /// Publish tf
+    /// Publish tf. While the publisher thread is running, it only stores the frames for the next cycle.
     /// \param robot Shared pointer of robot of which you'd like to see the frames
     /// \param publish_com If true, it publishes frames attached to center of mass of each link
     void publish(const RobotPtr& robot, bool publish_com = true);
+
+    /// Publish the latest frames stored by publish from a thread of its own
+    /// \param rate Publish rate [Hz]
+    void start(double rate);
+
+    /// Stop the publisher thread
+    void stop();
+
+    /// Frames which moved less than these since they were last sent are skipped
+    /// \param translation Tolerance of translation [m]
+    /// \param rotation Tolerance of each element of rotation matrix
+    void setTolerance(double translation, double rotation)
+    {
+      tolerance_translation_ = translation;
+      tolerance_rotation_    = rotation;
+    }
+
+    /// Frames are sent at least once in this period even if they didn't move, so that tf listeners don't have to extrapolate.
+    /// \param period Period [s]
+    void setKeepAlivePeriod(double period)
+    {
+      keep_alive_period_ = ros::Duration(period);
+    }
+
   private:
-    /// Publish tf
+    /// Frame of one link, shared by all manipulators of which it is a part
+    struct Frame
+    {
+      std::string parent;
+      Eigen::Matrix4d T;
+      Eigen::Matrix4d T_sent;
+      ros::Time sent;
+
+      EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+    };
+
+    typedef boost::shared_ptr<Frame> FramePtr;
+
+    /// Store frames of manipulator
     /// \param mnp Shared pointer of manipulator of which you'd like to see the frames
-    /// \param current Current time
     /// \publish_com If true, it publishes frames attached to center of mass of each link
-    void publish(const ManipulatorPtr& mnp, const ros::Time& current, bool publish_com);
+    void store(const ManipulatorPtr& mnp, bool publish_com);
+
+    /// Send frames which moved or have to be kept alive
+    /// \param current Current time
+    void send(const ros::Time& current);
+
+    /// Loop of the publisher thread
+    void run(double rate);
+
+    /// Convert transformation matrix to tf
+    void convert(const Eigen::Matrix4d& T, geometry_msgs::TransformStamped& tf_stamped);
 
     //! Singleton of transform broadcaster
     tf2_ros::TransformBroadcaster& transformBroadcaster();
+
+    //! Singleton of static transform broadcaster
+    tf2_ros::StaticTransformBroadcaster& staticTransformBroadcaster();
+
+    /// Mutex for frames_ and static_frames_
+    boost::mutex mutex_;
+
+    /// Key : Child frame name
+    /// Value : Moving frame
+    std::map<std::string, FramePtr> frames_;
+
+    /// Frames to be sent as static transforms
+    std::vector<geometry_msgs::TransformStamped> static_frames_;
+
+    /// Child frame names which were already added to static_frames_
+    std::map<std::string, bool> static_frame_names_;
+
+    /// Number of static frames already sent
+    unsigned int static_frames_sent_;
+
+    /// Serializes send(), which can be called from publish() and the publishing thread
+    boost::mutex send_mutex_;
+
+    /// Transforms to send in the current cycle, reused between cycles. Guarded by send_mutex_
+    std::vector<geometry_msgs::TransformStamped> transforms_;
+
+    double tolerance_translation_;
+    double tolerance_rotation_;
+    ros::Duration keep_alive_period_;
+
+    boost::thread thread_;
+    bool running_;
   };
 
   typedef boost::shared_ptr<TfPublisher> TfPublisherPtr;
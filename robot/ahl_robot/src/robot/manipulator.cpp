@@ -37,7 +37,6 @@
  *********************************************************************/
 
 #include <ros/ros.h>
-#include <ahl_digital_filter/pseudo_differentiator.hpp>
 #include "ahl_robot/definition.hpp"
 #include "ahl_robot/exception.hpp"
 #include "ahl_robot/robot/manipulator.hpp"
@@ -75,6 +74,7 @@ void Manipulator::init(unsigned int init_dof, const Eigen::VectorXd& init_q)
   q     = Eigen::VectorXd::Zero(dof);
   pre_q = Eigen::VectorXd::Zero(dof);
   dq    = Eigen::VectorXd::Zero(dof);
+  ddq   = Eigen::VectorXd::Zero(dof);
 
   T_abs.resize(dof + 1);
   for(unsigned int i = 0; i < T_abs.size(); ++i)
@@ -94,9 +94,15 @@ void Manipulator::init(unsigned int init_dof, const Eigen::VectorXd& init_q)
 
   q = init_q;
 
-  differentiator_ = ahl_filter::DifferentiatorPtr(
-    new ahl_filter::PseudoDifferentiator(update_rate_, cutoff_frequency_));
+  differentiator_ = ahl_filter::FilterBank::createDifferentiator(update_rate_, differentiator_param_);
   differentiator_->init(this->q, this->dq);
+
+  velocity_filter_ = ahl_filter::FilterBankPtr(new ahl_filter::FilterBank(update_rate_));
+  for(unsigned int i = 0; i < velocity_filter_param_.size(); ++i)
+  {
+    velocity_filter_->addFilter(velocity_filter_param_[i]);
+  }
+  velocity_filter_->init(this->dq);
   this->computeForwardKinematics();
 
   pre_q  = q;
@@ -476,7 +482,13 @@ void Manipulator::computeVelocity()
 {
   if(updated_joint_)
   {
-    differentiator_->apply(this->q);
+    // Discretize with the time of this update instead of update_rate_,
+    // since the period of the control loop jitters.
+    double time = time_ * 0.001;
+
+    differentiator_->apply(this->q, time);
     differentiator_->copyDerivativeValueTo(this->dq);
+    differentiator_->copySecondDerivativeValueTo(this->ddq);
+    velocity_filter_->apply(this->dq, time);
   }
 }
@@ -39,6 +39,7 @@
 #include <set>
 #include <algorithm>
 #include <yaml-cpp/yaml.h>
+#include <ahl_digital_filter/filter_bank.hpp>
 #include "ahl_robot/robot/parser.hpp"
 #include "ahl_robot/utils/math.hpp"
 #include "ahl_robot/definition.hpp"
@@ -114,10 +115,64 @@ void Parser::loadManipulator(const RobotPtr& robot)
   this->checkTag(node_, yaml_tag::DIFFERENTIATOR, func);
   YAML::Node node_dif = node_[yaml_tag::DIFFERENTIATOR];
   this->checkTag(node_dif, yaml_tag::DIFFERENTIATOR_UPDATE_RATE, func);
-  this->checkTag(node_dif, yaml_tag::DIFFERENTIATOR_CUTOFF_FREQUENCY, func);
 
   double update_rate = node_dif[yaml_tag::DIFFERENTIATOR_UPDATE_RATE].as<double>();
-  double cutoff_frequency = node_dif[yaml_tag::DIFFERENTIATOR_CUTOFF_FREQUENCY].as<double>();
+
+  ahl_filter::DifferentiatorParam dif_param;
+  if(node_dif[yaml_tag::DIFFERENTIATOR_TYPE])
+  {
+    dif_param.type = node_dif[yaml_tag::DIFFERENTIATOR_TYPE].as<std::string>();
+  }
+
+  if(dif_param.type == ahl_filter::differentiator::SAVITZKY_GOLAY)
+  {
+    this->checkTag(node_dif, yaml_tag::DIFFERENTIATOR_WINDOW_SIZE, func);
+    this->checkTag(node_dif, yaml_tag::DIFFERENTIATOR_POLYNOMIAL_ORDER, func);
+    dif_param.window_size = node_dif[yaml_tag::DIFFERENTIATOR_WINDOW_SIZE].as<unsigned int>();
+    dif_param.polynomial_order = node_dif[yaml_tag::DIFFERENTIATOR_POLYNOMIAL_ORDER].as<unsigned int>();
+  }
+  else if(dif_param.type == ahl_filter::differentiator::FIXED_LAG_SMOOTHER)
+  {
+    this->checkTag(node_dif, yaml_tag::DIFFERENTIATOR_WINDOW_SIZE, func);
+    this->checkTag(node_dif, yaml_tag::DIFFERENTIATOR_LAG, func);
+    dif_param.window_size = node_dif[yaml_tag::DIFFERENTIATOR_WINDOW_SIZE].as<unsigned int>();
+    dif_param.lag = node_dif[yaml_tag::DIFFERENTIATOR_LAG].as<unsigned int>();
+    if(node_dif[yaml_tag::DIFFERENTIATOR_POLYNOMIAL_ORDER])
+    {
+      dif_param.polynomial_order = node_dif[yaml_tag::DIFFERENTIATOR_POLYNOMIAL_ORDER].as<unsigned int>();
+    }
+  }
+  else
+  {
+    this->checkTag(node_dif, yaml_tag::DIFFERENTIATOR_CUTOFF_FREQUENCY, func);
+    dif_param.cutoff_frequency = node_dif[yaml_tag::DIFFERENTIATOR_CUTOFF_FREQUENCY].as<double>();
+  }
+
+  std::vector<ahl_filter::FilterParam> filter_param;
+  if(node_dif[yaml_tag::DIFFERENTIATOR_FILTERS])
+  {
+    YAML::Node node_filters = node_dif[yaml_tag::DIFFERENTIATOR_FILTERS];
+    for(unsigned int i = 0; i < node_filters.size(); ++i)
+    {
+      ahl_filter::FilterParam param;
+
+      this->checkTag(node_filters[i], yaml_tag::FILTER_TYPE, func);
+      this->checkTag(node_filters[i], yaml_tag::FILTER_FREQUENCY, func);
+      param.type = node_filters[i][yaml_tag::FILTER_TYPE].as<std::string>();
+      param.frequency = node_filters[i][yaml_tag::FILTER_FREQUENCY].as<double>();
+
+      if(node_filters[i][yaml_tag::FILTER_ORDER])
+      {
+        param.order = node_filters[i][yaml_tag::FILTER_ORDER].as<unsigned int>();
+      }
+      if(node_filters[i][yaml_tag::FILTER_Q])
+      {
+        param.q = node_filters[i][yaml_tag::FILTER_Q].as<double>();
+      }
+
+      filter_param.push_back(param);
+    }
+  }
 
   this->checkTag(node_, yaml_tag::MANIPULATORS, func);
 
@@ -126,7 +181,11 @@ void Parser::loadManipulator(const RobotPtr& robot)
     ManipulatorPtr mnp = ManipulatorPtr(new Manipulator());
 
     mnp->setDifferentiatorUpdateRate(update_rate);
-    mnp->setDifferentiatorCutoffFrequency(cutoff_frequency);
+    mnp->setDifferentiatorParam(dif_param);
+    for(unsigned int j = 0; j < filter_param.size(); ++j)
+    {
+      mnp->addVelocityFilter(filter_param[j]);
+    }
 
     this->checkTag(node_[yaml_tag::MANIPULATORS][i], yaml_tag::MNP_NAME, func);
     this->checkTag(node_[yaml_tag::MANIPULATORS][i], yaml_tag::LINKS, func);
@@ -278,6 +278,47 @@ void Robot::update(const Eigen::VectorXd& q)
   }
 }
 
+void Robot::update(const Eigen::VectorXd& q, const Eigen::VectorXd& dq)
+{
+  if(q.rows() != dof_ || dq.rows() != dof_)
+  {
+    std::stringstream msg;
+    msg << "q.rows() != dof_ || dq.rows() != dof_" << std::endl
+        << "  q.rows  : " << q.rows() << std::endl
+        << "  dq.rows : " << dq.rows() << std::endl
+        << "  dof     : " << dof_;
+    throw ahl_robot::Exception("ahl_robot::Robot::update", msg.str());
+  }
+
+  unsigned int macro_dof = macro_manipulator_dof_;
+  int idx_offset = macro_dof;
+
+  for(unsigned int i = 0; i < mnp_name_.size(); ++i)
+  {
+    if(mnp_.find(mnp_name_[i]) == mnp_.end())
+    {
+      std::stringstream msg;
+      msg << "Could not find manipulator : " << mnp_name_[i];
+      throw ahl_robot::Exception("ahl_robot::Robot::update", msg.str());
+    }
+
+    ManipulatorPtr mnp = mnp_[mnp_name_[i]];
+
+    Eigen::VectorXd q_mnp  = Eigen::VectorXd::Zero(mnp->dof);
+    Eigen::VectorXd dq_mnp = Eigen::VectorXd::Zero(mnp->dof);
+    unsigned int mini_dof = mnp->dof - macro_dof;
+
+    q_mnp.block(0, 0, macro_dof, 1)  = q.block(0, 0, macro_dof, 1);
+    dq_mnp.block(0, 0, macro_dof, 1) = dq.block(0, 0, macro_dof, 1);
+    q_mnp.block(macro_dof, 0, mini_dof, 1)  = q.block(idx_offset, 0, mini_dof, 1);
+    dq_mnp.block(macro_dof, 0, mini_dof, 1) = dq.block(idx_offset, 0, mini_dof, 1);
+
+    idx_offset += mini_dof;
+
+    mnp->update(q_mnp, dq_mnp);
+  }
+}
+
 void Robot::computeBasicJacobian()
 {
   for(unsigned int i = 0; i < mnp_name_.size(); ++i)
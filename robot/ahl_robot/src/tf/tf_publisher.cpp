@@ -43,22 +43,76 @@
 using namespace ahl_robot;
 
 TfPublisher::TfPublisher()
+  : static_frames_sent_(0),
+    tolerance_translation_(1e-5),
+    tolerance_rotation_(1e-5),
+    keep_alive_period_(ros::Duration(1.0)),
+    running_(false)
 {
 }
 
+TfPublisher::~TfPublisher()
+{
+  this->stop();
+}
+
 void TfPublisher::publish(const RobotPtr& robot, bool publish_com)
 {
-  ros::Time current = ros::Time::now();
+  bool running;
+
+  {
+    boost::mutex::scoped_lock lock(mutex_);
+
+    std::vector<std::string>::const_iterator it;
+    for(it = robot->getManipulatorName().begin(); it != robot->getManipulatorName().end(); ++it)
+    {
+      ManipulatorPtr mnp = robot->getManipulator(*it);
+      this->store(mnp, publish_com);
+    }
+
+    running = running_;
+  }
+
+  if(!running)
+  {
+    this->send(ros::Time::now());
+  }
+}
+
+void TfPublisher::start(double rate)
+{
+  if(rate <= 0.0)
+  {
+    std::stringstream msg;
+    msg << "rate should be positive." << std::endl
+        << "  rate : " << rate;
+    throw ahl_robot::Exception("ahl_robot::TfPublisher::start", msg.str());
+  }
+
+  this->stop();
+
+  {
+    boost::mutex::scoped_lock lock(mutex_);
+    running_ = true;
+  }
+
+  thread_ = boost::thread(&TfPublisher::run, this, rate);
+}
+
+void TfPublisher::stop()
+{
+  {
+    boost::mutex::scoped_lock lock(mutex_);
+    running_ = false;
+  }
 
-  std::vector<std::string>::const_iterator it;
-  for(it = robot->getManipulatorName().begin(); it != robot->getManipulatorName().end(); ++it)
+  if(thread_.joinable())
   {
-    ManipulatorPtr mnp = robot->getManipulator(*it);
-    this->publish(mnp, current, publish_com);
+    thread_.join();
   }
 }
 
-void TfPublisher::publish(const ManipulatorPtr& mnp, const ros::Time& current, bool publish_com)
+void TfPublisher::store(const ManipulatorPtr& mnp, bool publish_com)
 {
   if(mnp->T.size() != mnp->link.size())
   {
@@ -66,54 +120,162 @@ void TfPublisher::publish(const ManipulatorPtr& mnp, const ros::Time& current, b
     msg << "mnp->T.size() != mnp->link.size()" << std::endl
         << "  mnp->T.size()    = " << mnp->T.size() << std::endl
         << "  mnp->link.size() = " << mnp->link.size();
-    throw ahl_robot::Exception("ahl_robot::TfPublisher::publish", msg.str());
+    throw ahl_robot::Exception("ahl_robot::TfPublisher::store", msg.str());
   }
 
   for(unsigned int i = 0; i < mnp->T.size(); ++i)
   {
-    geometry_msgs::TransformStamped tf_stamped;
     LinkPtr link = mnp->link[i];
 
-    tf_stamped.header.frame_id = link->parent;
-    tf_stamped.child_frame_id  = link->name;
-    tf_stamped.header.stamp    = current;
-
-    Eigen::Matrix3d R = mnp->T[i].block(0, 0, 3, 3);
-    Eigen::Quaterniond q(R);
+    // Transformation of fixed joint never changes, so it's sent only once.
+    if(link->joint_type == joint::FIXED)
+    {
+      if(static_frame_names_.find(link->name) == static_frame_names_.end())
+      {
+        geometry_msgs::TransformStamped tf_stamped;
+        tf_stamped.header.frame_id = link->parent;
+        tf_stamped.child_frame_id  = link->name;
+        this->convert(mnp->T[i], tf_stamped);
 
-    tf_stamped.transform.translation.x = mnp->T[i].coeff(0, 3);
-    tf_stamped.transform.translation.y = mnp->T[i].coeff(1, 3);
-    tf_stamped.transform.translation.z = mnp->T[i].coeff(2, 3);
+        static_frames_.push_back(tf_stamped);
+        static_frame_names_[link->name] = true;
+      }
+    }
+    else
+    {
+      std::map<std::string, FramePtr>::iterator it = frames_.find(link->name);
+      if(it == frames_.end())
+      {
+        FramePtr frame = FramePtr(new Frame());
+        frame->parent = link->parent;
+        frame->T_sent = Eigen::Matrix4d::Zero();
+        it = frames_.insert(std::make_pair(link->name, frame)).first;
+      }
 
-    tf_stamped.transform.rotation.x = q.x();
-    tf_stamped.transform.rotation.y = q.y();
-    tf_stamped.transform.rotation.z = q.z();
-    tf_stamped.transform.rotation.w = q.w();
-    transformBroadcaster().sendTransform(tf_stamped);
+      // Links of macro manipulator appear in every manipulator.
+      it->second->T = mnp->T[i];
+    }
 
     if(!publish_com)
       continue;
 
-    geometry_msgs::TransformStamped com_stamped;
-    com_stamped.header.frame_id = link->name;
-    com_stamped.child_frame_id  = link->name + "_com";
-    com_stamped.header.stamp    = current;
+    std::string com = link->name + "_com";
+    if(static_frame_names_.find(com) == static_frame_names_.end())
+    {
+      geometry_msgs::TransformStamped com_stamped;
+      com_stamped.header.frame_id = link->name;
+      com_stamped.child_frame_id  = com;
+
+      Eigen::Matrix4d T = Eigen::Matrix4d::Identity();
+      T.block(0, 3, 3, 1) = link->C;
+      this->convert(T, com_stamped);
+
+      static_frames_.push_back(com_stamped);
+      static_frame_names_[com] = true;
+    }
+  }
+}
+
+void TfPublisher::send(const ros::Time& current)
+{
+  // transforms_ is shared by all callers, and batches should be sent in order
+  boost::mutex::scoped_lock send_lock(send_mutex_);
+
+  std::vector<geometry_msgs::TransformStamped> static_frames;
+  transforms_.clear();
+
+  {
+    boost::mutex::scoped_lock lock(mutex_);
+
+    std::map<std::string, FramePtr>::iterator it;
+    for(it = frames_.begin(); it != frames_.end(); ++it)
+    {
+      Frame& frame = *(it->second);
+
+      double translation = (frame.T.block(0, 3, 3, 1) - frame.T_sent.block(0, 3, 3, 1)).norm();
+      double rotation    = (frame.T.block(0, 0, 3, 3) - frame.T_sent.block(0, 0, 3, 3)).cwiseAbs().maxCoeff();
+
+      if(translation < tolerance_translation_ &&
+         rotation < tolerance_rotation_ &&
+         current - frame.sent < keep_alive_period_)
+        continue;
+
+      geometry_msgs::TransformStamped tf_stamped;
+      tf_stamped.header.frame_id = frame.parent;
+      tf_stamped.header.stamp    = current;
+      tf_stamped.child_frame_id  = it->first;
+      this->convert(frame.T, tf_stamped);
+      transforms_.push_back(tf_stamped);
+
+      frame.T_sent = frame.T;
+      frame.sent   = current;
+    }
+
+    // /tf_static is latched, so late subscribers only get the last message.
+    // Every static frame is sent again whenever a new one is added.
+    if(static_frames_sent_ < static_frames_.size())
+    {
+      static_frames = static_frames_;
+      static_frames_sent_ = static_frames_.size();
+    }
+  }
+
+  if(!static_frames.empty())
+  {
+    for(unsigned int i = 0; i < static_frames.size(); ++i)
+    {
+      static_frames[i].header.stamp = current;
+    }
+
+    staticTransformBroadcaster().sendTransform(static_frames);
+  }
+
+  if(!transforms_.empty())
+  {
+    transformBroadcaster().sendTransform(transforms_);
+  }
+}
 
-    q = Eigen::Matrix3d::Identity();
+void TfPublisher::run(double rate)
+{
+  ros::Rate r(rate);
 
-    com_stamped.transform.translation.x = link->C.coeff(0);
-    com_stamped.transform.translation.y = link->C.coeff(1);
-    com_stamped.transform.translation.z = link->C.coeff(2);
+  while(ros::ok())
+  {
+    {
+      boost::mutex::scoped_lock lock(mutex_);
+      if(!running_)
+        break;
+    }
 
-    com_stamped.transform.rotation.x = q.x();
-    com_stamped.transform.rotation.y = q.y();
-    com_stamped.transform.rotation.z = q.z();
-    com_stamped.transform.rotation.w = q.w();
-    transformBroadcaster().sendTransform(com_stamped);
+    this->send(ros::Time::now());
+    r.sleep();
   }
 }
+
+void TfPublisher::convert(const Eigen::Matrix4d& T, geometry_msgs::TransformStamped& tf_stamped)
+{
+  Eigen::Matrix3d R = T.block(0, 0, 3, 3);
+  Eigen::Quaterniond q(R);
+
+  tf_stamped.transform.translation.x = T.coeff(0, 3);
+  tf_stamped.transform.translation.y = T.coeff(1, 3);
+  tf_stamped.transform.translation.z = T.coeff(2, 3);
+
+  tf_stamped.transform.rotation.x = q.x();
+  tf_stamped.transform.rotation.y = q.y();
+  tf_stamped.transform.rotation.z = q.z();
+  tf_stamped.transform.rotation.w = q.w();
+}
+
 tf2_ros::TransformBroadcaster& TfPublisher::transformBroadcaster()
 {
   static tf2_ros::TransformBroadcaster br;
   return br;
 }
+
+tf2_ros::StaticTransformBroadcaster& TfPublisher::staticTransformBroadcaster()
+{
+  static tf2_ros::StaticTransformBroadcaster br;
+  return br;
+}
@@ -56,6 +56,7 @@ namespace ahl_sample
     virtual void updateModel(const ros::TimerEvent&);
     virtual void control(const ros::TimerEvent&);
     void updateWheels(const ros::TimerEvent&);
+    void runLockStep();
 
     YouBotParamPtr param_;
 
@@ -65,9 +66,10 @@ namespace ahl_sample
     TaskPtr arm_orientation_control_;
     TaskPtr base_position_control_;
     TaskPtr base_orientation_control_;
-    GazeboInterfacePtr gazebo_interface_wheel_;
 
     ros::Timer timer_update_wheels_;
+    bool lock_step_;
+    boost::thread lock_step_thread_;
     Eigen::VectorXd q_base_;
     Eigen::VectorXd tau_base_;
   };
@@ -164,8 +164,10 @@ void PR2::control(const ros::TimerEvent&)
 
     if(gazebo_interface_->subscribed())
     {
-      Eigen::VectorXd q = gazebo_interface_->getJointStates();
-      robot_->update(q);
+      Eigen::VectorXd q, dq;
+      double time;
+      gazebo_interface_->getJointStates(q, dq, time);
+      robot_->update(q, dq);
       joint_updated_ = true;
     }
 
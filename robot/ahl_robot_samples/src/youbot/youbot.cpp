@@ -2,7 +2,15 @@
 
 using namespace ahl_sample;
 
+namespace
+{
+  // Wheels are registered after the joints of the robot model, in the same block
+  const unsigned int WHEEL_NUM = 4;
+  const char* WHEEL_NAME[WHEEL_NUM] = { "fl", "fr", "bl", "br" };
+}
+
 YouBot::YouBot()
+  : lock_step_(false)
 {
 
 }
@@ -13,6 +21,7 @@ void YouBot::init()
   std::string yaml = "";
 
   local_nh.param<std::string>("robot_config", yaml, "/home/daichi/Work/catkin_ws/src/ahl_ros_pkg/ahl_robot/ahl_robot_samples/yaml/youbot.yaml");
+  local_nh.param<bool>("lock_step", lock_step_, false);
 
   initRobot("youbot", yaml);
 
@@ -53,18 +62,12 @@ void YouBot::init()
   gazebo_interface_->addJoint("youbot::joint3");
   gazebo_interface_->addJoint("youbot::joint4");
   gazebo_interface_->addJoint("youbot::joint5");
-  gazebo_interface_->connect();
-
-  gazebo_interface_wheel_ = GazeboInterfacePtr(new GazeboInterface());
-  gazebo_interface_wheel_->addJoint("youbot::wheel_joint_fl");
-  gazebo_interface_wheel_->addJoint("youbot::wheel_joint_fr");
-  gazebo_interface_wheel_->addJoint("youbot::wheel_joint_bl");
-  gazebo_interface_wheel_->addJoint("youbot::wheel_joint_br");
-  gazebo_interface_wheel_->addLink("youbot", "wheel_link_fl");
-  gazebo_interface_wheel_->addLink("youbot", "wheel_link_fr");
-  gazebo_interface_wheel_->addLink("youbot", "wheel_link_bl");
-  gazebo_interface_wheel_->addLink("youbot", "wheel_link_br");
-  gazebo_interface_wheel_->connect();
+  for(unsigned int i = 0; i < WHEEL_NUM; ++i)
+  {
+    gazebo_interface_->addJoint(std::string("youbot::wheel_joint_") + WHEEL_NAME[i]);
+    gazebo_interface_->addLink("youbot", std::string("wheel_link_") + WHEEL_NAME[i]);
+  }
+  gazebo_interface_->connect(lock_step_);
 
   tf_pub_ = TfPublisherPtr(new TfPublisher());
 
@@ -79,12 +82,47 @@ void YouBot::run()
 {
   ros::NodeHandle nh;
 
-  timer_update_model_ = nh.createTimer(ros::Duration(0.01), &YouBot::updateModel, this);
-  timer_control_ = nh.createTimer(ros::Duration(0.001), &YouBot::control, this);
-  timer_update_wheels_ = nh.createTimer(ros::Duration(0.01), &YouBot::updateWheels, this);
+  if(lock_step_)
+  {
+    lock_step_thread_ = boost::thread(&YouBot::runLockStep, this);
+  }
+  else
+  {
+    timer_update_model_ = nh.createTimer(ros::Duration(0.01), &YouBot::updateModel, this);
+    timer_control_ = nh.createTimer(ros::Duration(0.001), &YouBot::control, this);
+    timer_update_wheels_ = nh.createTimer(ros::Duration(0.01), &YouBot::updateWheels, this);
+  }
 
   ros::MultiThreadedSpinner spinner;
   spinner.spin();
+
+  if(lock_step_)
+  {
+    lock_step_thread_.join();
+  }
+}
+
+void YouBot::runLockStep()
+{
+  // Control runs once per physics step and the model is updated every 10 ms
+  // of simulation time, so the results do not depend on the wall clock.
+  double next_model_update = 0.0;
+
+  while(ros::ok())
+  {
+    if(!gazebo_interface_->waitJointStates(1.0))
+      continue;
+
+    double time = gazebo_interface_->getSimulationTime();
+    if(time >= next_model_update)
+    {
+      updateModel(ros::TimerEvent());
+      updateWheels(ros::TimerEvent());
+      next_model_update = time + 0.01;
+    }
+
+    control(ros::TimerEvent());
+  }
 }
 
 void YouBot::updateModel(const ros::TimerEvent&)
@@ -144,14 +182,18 @@ void YouBot::updateModel(const ros::TimerEvent&)
 
 void YouBot::control(const ros::TimerEvent&)
 {
+  bool efforts_applied = false;
+
   try
   {
     boost::mutex::scoped_lock lock(mutex_);
 
     if(gazebo_interface_->subscribed())
     {
-      Eigen::VectorXd q = gazebo_interface_->getJointStates();
-      robot_->update(q);
+      Eigen::VectorXd q, dq;
+      double time;
+      gazebo_interface_->getJointStates(q, dq, time);
+      robot_->update(q.head(robot_->getDOF()), dq.head(robot_->getDOF()));
       joint_updated_ = true;
 
       q_base_ = q.block(0, 0, robot_->getMacroManipulatorDOF(), 1);
@@ -161,7 +203,12 @@ void YouBot::control(const ros::TimerEvent&)
 
     Eigen::VectorXd tau = Eigen::VectorXd::Zero(robot_->getDOF());
     controller_->computeGeneralizedForce(tau);
-    gazebo_interface_->applyJointEfforts(tau);
+
+    // wheels are rotated through their links, so they get no effort
+    Eigen::VectorXd tau_joints = Eigen::VectorXd::Zero(robot_->getDOF() + WHEEL_NUM);
+    tau_joints.head(robot_->getDOF()) = tau;
+    gazebo_interface_->applyJointEfforts(tau_joints);
+    efforts_applied = true;
 
     tau_base_ = tau.block(0, 0, robot_->getMacroManipulatorDOF(), 1);
   }
@@ -173,6 +220,24 @@ void YouBot::control(const ros::TimerEvent&)
   {
     ROS_ERROR_STREAM(e.what());
   }
+  catch(ahl_gazebo_if::Exception& e)
+  {
+    ROS_ERROR_STREAM(e.what());
+  }
+
+  // gazebo waits for efforts after every step in lock-step mode,
+  // so release the step with zero efforts whenever control bailed out
+  if(lock_step_ && !efforts_applied)
+  {
+    try
+    {
+      gazebo_interface_->applyJointEfforts(Eigen::VectorXd::Zero(robot_->getDOF() + WHEEL_NUM));
+    }
+    catch(ahl_gazebo_if::Exception& e)
+    {
+      ROS_ERROR_STREAM(e.what());
+    }
+  }
 }
 
 void YouBot::updateWheels(const ros::TimerEvent& e)
@@ -181,9 +246,13 @@ void YouBot::updateWheels(const ros::TimerEvent& e)
   {
     if(q_base_.rows() != robot_->getMacroManipulatorDOF()) return;
     if(tau_base_.rows() != robot_->getMacroManipulatorDOF()) return;
-    if(!gazebo_interface_wheel_->subscribed()) return;
+    if(!gazebo_interface_->subscribed()) return;
 
-    Eigen::VectorXd q = gazebo_interface_wheel_->getJointStates();
+    // copied under the lock of the interface, which control() reads at the same time
+    Eigen::VectorXd q_joints, dq_joints;
+    double time;
+    gazebo_interface_->getJointStates(q_joints, dq_joints, time);
+    Eigen::VectorXd q = q_joints.tail(WHEEL_NUM);
     robot_->updateWheel(q);
 
     Eigen::Vector3d base_pos;
@@ -218,7 +287,7 @@ void YouBot::updateWheels(const ros::TimerEvent& e)
       quat_d.push_back(quat);
     }
 
-    gazebo_interface_wheel_->rotateLink(quat_d);
+    gazebo_interface_->rotateLink(quat_d);
   }
   catch(ahl_robot::Exception& e)
   {
@@ -0,0 +1,105 @@
+/*
+ * Copyright 2012 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef GAZEBO_PLUGINS_IMAGE_SHM_RING_H
+#define GAZEBO_PLUGINS_IMAGE_SHM_RING_H
+
+#include <string>
+#include <stdint.h>
+#include <boost/shared_ptr.hpp>
+#include <boost/interprocess/shared_memory_object.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <sensor_msgs/Image.h>
+
+namespace gazebo
+{
+  /// \brief Layout of the shared memory.  The header is followed by
+  /// slot_count_ slots of slot_stride_ bytes, each of which is an
+  /// ImageShmSlot followed by up to data_capacity_ bytes of pixels.
+  struct ImageShmRingHeader
+  {
+    uint32_t magic_;
+    uint32_t slot_count_;
+    uint32_t slot_stride_;
+    uint32_t data_capacity_;
+    /// \brief Number of images written so far
+    volatile uint64_t write_count_;
+  };
+
+  struct ImageShmSlot
+  {
+    /// \brief Odd while the slot is being written
+    volatile uint64_t sequence_;
+    int32_t stamp_sec_;
+    int32_t stamp_nsec_;
+    uint32_t height_;
+    uint32_t width_;
+    uint32_t step_;
+    uint32_t data_size_;
+    uint8_t is_bigendian_;
+    char encoding_[32];
+    char frame_id_[128];
+  };
+
+  /// \brief Writes images to a ring of slots in shared memory, so that
+  /// processes on the same host can read them without ROS serialization.
+  /// The writer never waits for readers; a reader detects a slot that
+  /// was overwritten while being copied and drops that image.
+  class ImageShmRingWriter
+  {
+    /// \param[in] _name Name of the shared memory object
+    /// \param[in] _slot_count Number of images kept in the ring
+    /// \param[in] _data_capacity Maximum size of an image in bytes
+    public: ImageShmRingWriter(const std::string &_name,
+                               unsigned int _slot_count,
+                               unsigned int _data_capacity);
+
+    /// \brief Remove the shared memory object
+    public: ~ImageShmRingWriter();
+
+    /// \brief Copy an image into the next slot
+    /// \return false if the image is larger than the slots
+    public: bool Write(const sensor_msgs::Image &_image);
+
+    private: std::string name_;
+    private: boost::interprocess::shared_memory_object shm_;
+    private: boost::interprocess::mapped_region region_;
+    private: ImageShmRingHeader *header_;
+  };
+
+  /// \brief Reads the latest image written by ImageShmRingWriter.
+  class ImageShmRingReader
+  {
+    /// \brief Open an existing ring, throws
+    /// boost::interprocess::interprocess_exception if it does not exist
+    public: ImageShmRingReader(const std::string &_name);
+
+    /// \brief Copy the latest image if it is newer than the last one read
+    /// \return true if _image has been updated
+    public: bool Read(sensor_msgs::Image &_image);
+
+    private: boost::interprocess::shared_memory_object shm_;
+    private: boost::interprocess::mapped_region region_;
+    private: const ImageShmRingHeader *header_;
+    private: uint64_t read_count_;
+  };
+
+  /// \brief Name of the shared memory object for an image topic
+  std::string ImageShmRingName(const std::string &_topic);
+}
+
+#endif
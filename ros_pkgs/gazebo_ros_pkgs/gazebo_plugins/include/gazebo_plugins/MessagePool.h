@@ -0,0 +1,110 @@
+/*
+ * Copyright 2012 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef GAZEBO_PLUGINS_MESSAGE_POOL_H
+#define GAZEBO_PLUGINS_MESSAGE_POOL_H
+
+#include <vector>
+#include <boost/shared_ptr.hpp>
+#include <boost/weak_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+
+/// \brief A pool of recycled ROS messages.  Messages are handed out as
+/// shared pointers, which can be published for intra-process zero-copy
+/// delivery.  When the last subscriber releases a message it returns to
+/// the pool with its buffers still allocated, so filling the next frame
+/// of the same size does not allocate.  Templated on a ROS message type.
+template<class T>
+class MessagePool
+{
+  public:
+    typedef boost::shared_ptr<T> MessagePtr;
+
+  private:
+    /// \brief Free list, shared with the deleters of outstanding messages
+    /// so that messages released after the pool is gone are deleted.
+    struct FreeList
+    {
+      boost::mutex lock_;
+      std::vector<T*> messages_;
+      unsigned int capacity_;
+
+      ~FreeList()
+      {
+        for (unsigned int i = 0; i < this->messages_.size(); ++i)
+          delete this->messages_[i];
+      }
+    };
+
+    /// \brief Deleter of messages handed out by Allocate()
+    class Recycler
+    {
+      public:
+        Recycler(const boost::shared_ptr<FreeList>& free_list) :
+          free_list_(free_list) {}
+
+        void operator()(T* msg)
+        {
+          boost::shared_ptr<FreeList> free_list = this->free_list_.lock();
+          if (free_list)
+          {
+            boost::mutex::scoped_lock lock(free_list->lock_);
+            if (free_list->messages_.size() < free_list->capacity_)
+            {
+              free_list->messages_.push_back(msg);
+              return;
+            }
+          }
+          delete msg;
+        }
+
+      private:
+        boost::weak_ptr<FreeList> free_list_;
+    };
+
+    boost::shared_ptr<FreeList> free_list_;
+
+  public:
+    /// \param[in] capacity Maximum number of idle messages kept for reuse
+    MessagePool(unsigned int capacity = 4) :
+      free_list_(new FreeList)
+    {
+      this->free_list_->capacity_ = capacity;
+    }
+
+    /// \brief Get a message, reusing a released one if available.
+    /// Contents of a reused message are those of its previous use.
+    MessagePtr Allocate()
+    {
+      T* msg = NULL;
+      {
+        boost::mutex::scoped_lock lock(this->free_list_->lock_);
+        if (!this->free_list_->messages_.empty())
+        {
+          msg = this->free_list_->messages_.back();
+          this->free_list_->messages_.pop_back();
+        }
+      }
+
+      if (!msg)
+        msg = new T;
+
+      return MessagePtr(msg, Recycler(this->free_list_));
+    }
+};
+
+#endif
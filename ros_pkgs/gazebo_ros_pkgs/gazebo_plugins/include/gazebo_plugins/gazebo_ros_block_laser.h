@@ -40,6 +40,10 @@
 #include <boost/bind.hpp>
 #include <boost/thread.hpp>
 #include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/random/mersenne_twister.hpp>
+
+#include <vector>
 
 #include <sensor_msgs/PointCloud.h>
 
@@ -65,6 +69,31 @@ namespace gazebo
     /// \brief Put laser data to the ROS topic
     private: void PutLaserData(common::Time &_updateTime);
 
+    /// \brief Rebuild the interpolation tables if the ray layout changed
+    private: void UpdateInterpolationTables();
+
+    /// \brief Scratch buffers of one interpolation thread, one value per
+    /// ray or per output beam of the current row
+    private: struct RowBuffers
+    {
+      std::vector<float> ray_range;
+      std::vector<float> ray_retro;
+      std::vector<float> range_a;
+      std::vector<float> range_b;
+      std::vector<float> range;
+      std::vector<float> x;
+      std::vector<float> y;
+      std::vector<float> z;
+    };
+
+    /// \brief Interpolate the points of rows [_rowBegin, _rowEnd) into cloud_msg_
+    private: void InterpolateRows(int _rowBegin, int _rowEnd, unsigned int _seed,
+                                  RowBuffers &_buffers);
+
+    /// \brief Loop of a persistent interpolation thread, runs one block of
+    /// rows per scan
+    private: void WorkerThread(int _index);
+
     private: common::Time last_update_time_;
 
     /// \brief Keep track of number of connctions
@@ -94,8 +123,50 @@ namespace gazebo
     /// \brief Gaussian noise
     private: double gaussian_noise_;
 
-    /// \brief Gaussian noise generator
-    private: double GaussianKernel(double mu,double sigma);
+    /// \brief Seeds the noise generators of the interpolation threads
+    private: boost::mt19937 noise_seed_generator_;
+
+    /// \brief Number of threads the rows are interpolated on, including the
+    /// sensor update thread
+    private: int worker_threads_;
+
+    /// \brief Persistent interpolation threads, started in Load
+    private: boost::thread_group workers_;
+    private: std::vector<RowBuffers> row_buffers_;
+    private: std::vector<unsigned int> worker_seeds_;
+    private: boost::mutex work_mutex_;
+    private: boost::condition_variable work_cond_;
+    private: boost::condition_variable work_done_cond_;
+    private: unsigned int work_generation_;
+    private: int work_rows_;
+    private: int work_pending_;
+    private: bool work_stop_;
+
+    /// \brief Ray layout the interpolation tables were built for
+    private: int table_ray_count_;
+    private: int table_range_count_;
+    private: int table_vertical_ray_count_;
+    private: int table_vertical_range_count_;
+    private: double table_angles_[4];
+
+    /// \brief Per output beam: rays to interpolate between, weight of the
+    /// second ray and direction
+    private: std::vector<int> beam_ray_a_;
+    private: std::vector<int> beam_ray_b_;
+    private: std::vector<float> beam_weight_;
+    private: std::vector<float> beam_cos_;
+    private: std::vector<float> beam_sin_;
+
+    /// \brief Per output row: the same in vertical direction
+    private: std::vector<int> row_ray_a_;
+    private: std::vector<int> row_ray_b_;
+    private: std::vector<float> row_weight_;
+    private: std::vector<float> row_cos_;
+    private: std::vector<float> row_sin_;
+
+    /// \brief Clamped ranges and retro values of all rays of the last scan
+    private: std::vector<float> ranges_;
+    private: std::vector<float> retros_;
 
     /// \brief A mutex to lock access to fields that are used in message callbacks
     private: boost::mutex lock;
@@ -48,6 +48,8 @@
 #include <gazebo/sensors/SensorTypes.hh>
 #include <gazebo/plugins/CameraPlugin.hh>
 #include <gazebo_plugins/gazebo_ros_utils.h>
+#include <gazebo_plugins/MessagePool.h>
+#include <gazebo_plugins/ImageShmRing.h>
 
 namespace gazebo
 {
@@ -86,6 +88,7 @@ namespace gazebo
     protected: void PutCameraData(const unsigned char *_src);
     protected: void PutCameraData(const unsigned char *_src,
       common::Time &last_update_time);
+    private: void PutSharedMemoryImage(const sensor_msgs::Image &_image);
 
     /// \brief Keep track of number of image connections
     protected: boost::shared_ptr<int> image_connect_count_;
@@ -112,6 +115,26 @@ namespace gazebo
     /// \brief ROS image message
     protected: sensor_msgs::Image image_msg_;
 
+    /// \brief Publish images taken from image_pool_ as shared pointers
+    /// instead of image_msg_, so that nodelets in the same process
+    /// receive them without serialization.  Set by <zeroCopy>.
+    protected: bool zero_copy_;
+    protected: MessagePool<sensor_msgs::Image> image_pool_;
+    /// \brief Image published last in zero copy mode
+    protected: sensor_msgs::ImageConstPtr last_image_;
+
+    /// \brief Latest camera image, call with lock_ held
+    protected: const sensor_msgs::Image &GetLatestImage() const
+    {
+      return this->last_image_ ? *this->last_image_ : this->image_msg_;
+    }
+
+    /// \brief Images are also written to a shared memory ring of this many
+    /// slots for other processes on the host, 0 to disable.
+    /// Set by <sharedMemorySlots>.
+    private: int shm_ring_slots_;
+    private: boost::shared_ptr<ImageShmRingWriter> shm_ring_;
+
     /// \brief for setting ROS name space
     private: std::string robot_namespace_;
 
@@ -52,6 +52,8 @@
 // boost stuff
 #include <boost/thread/mutex.hpp>
 
+#include <vector>
+
 // camera stuff
 #include <gazebo_plugins/gazebo_ros_camera_utils.h>
 
@@ -113,6 +115,15 @@ namespace gazebo
                                   uint32_t rows_arg, uint32_t cols_arg,
                                   uint32_t step_arg, void* data_arg);
 
+    /// \brief Rebuild ray_x_ and ray_y_ if resolution or HFOV has changed
+    private: void UpdateRayTable(uint32_t rows_arg, uint32_t cols_arg);
+
+    /// \brief x / z of the ray through each column, and y / z through each row.
+    /// Projection is separable, so a point is (depth * ray_x_[i], depth * ray_y_[j], depth)
+    private: std::vector<float> ray_x_;
+    private: std::vector<float> ray_y_;
+    private: double ray_table_hfov_;
+
     /// \brief A pointer to the ROS node.  A node will be instantiated if it does not exist.
     private: ros::Publisher point_cloud_pub_;
     private: ros::Publisher depth_image_pub_;
@@ -121,6 +132,10 @@ namespace gazebo
     private: sensor_msgs::PointCloud2 point_cloud_msg_;
     private: sensor_msgs::Image depth_image_msg_;
 
+    /// \brief Messages published in zero copy mode
+    private: MessagePool<sensor_msgs::PointCloud2> point_cloud_pool_;
+    private: MessagePool<sensor_msgs::Image> depth_image_pool_;
+
     private: double point_cloud_cutoff_;
 
     /// \brief ROS image topic name
@@ -115,6 +115,10 @@ namespace gazebo
     private: sensor_msgs::PointCloud2 point_cloud_msg_;
     private: sensor_msgs::Image depth_image_msg_;
 
+    /// \brief Messages published in zero copy mode
+    private: MessagePool<sensor_msgs::PointCloud2> point_cloud_pool_;
+    private: MessagePool<sensor_msgs::Image> depth_image_pool_;
+
     private: double point_cloud_cutoff_;
 
     /// \brief ROS image topic name
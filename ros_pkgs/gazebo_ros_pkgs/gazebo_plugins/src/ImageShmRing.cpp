@@ -0,0 +1,180 @@
+/*
+ * Copyright 2012 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <cstring>
+#include <algorithm>
+#include <gazebo_plugins/ImageShmRing.h>
+
+namespace
+{
+  const uint32_t IMAGE_SHM_RING_MAGIC = 0x52494d47;  // "GMIR"
+
+  ////////////////////////////////////////////////////////////////////////////
+  // Slots are aligned to cache lines so that a writer and a reader of
+  // neighbouring slots do not share one
+  uint32_t SlotStride(uint32_t _data_capacity)
+  {
+    uint32_t size = sizeof(gazebo::ImageShmSlot) + _data_capacity;
+    return (size + 63) & ~63u;
+  }
+
+  gazebo::ImageShmSlot *Slot(const gazebo::ImageShmRingHeader *_header,
+                             uint64_t _count)
+  {
+    char *base = (char*)_header + ((sizeof(gazebo::ImageShmRingHeader) + 63) & ~63u);
+    return (gazebo::ImageShmSlot*)(base +
+      (_count % _header->slot_count_) * _header->slot_stride_);
+  }
+}
+
+namespace gazebo
+{
+////////////////////////////////////////////////////////////////////////////////
+// Create the ring
+ImageShmRingWriter::ImageShmRingWriter(const std::string &_name,
+    unsigned int _slot_count, unsigned int _data_capacity)
+  : name_(_name)
+{
+  using namespace boost::interprocess;
+
+  shared_memory_object::remove(this->name_.c_str());
+  shared_memory_object shm(create_only, this->name_.c_str(), read_write);
+  this->shm_.swap(shm);
+
+  uint32_t stride = SlotStride(_data_capacity);
+  this->shm_.truncate(((sizeof(ImageShmRingHeader) + 63) & ~63u) +
+                      static_cast<offset_t>(stride) * _slot_count);
+
+  mapped_region region(this->shm_, read_write);
+  this->region_.swap(region);
+  std::memset(this->region_.get_address(), 0, this->region_.get_size());
+
+  this->header_ = static_cast<ImageShmRingHeader*>(this->region_.get_address());
+  this->header_->slot_count_ = std::max(_slot_count, 1u);
+  this->header_->slot_stride_ = stride;
+  this->header_->data_capacity_ = _data_capacity;
+  this->header_->write_count_ = 0;
+  __sync_synchronize();
+  this->header_->magic_ = IMAGE_SHM_RING_MAGIC;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Destructor
+ImageShmRingWriter::~ImageShmRingWriter()
+{
+  boost::interprocess::shared_memory_object::remove(this->name_.c_str());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Copy an image into the next slot
+bool ImageShmRingWriter::Write(const sensor_msgs::Image &_image)
+{
+  if (_image.data.size() > this->header_->data_capacity_)
+    return false;
+
+  uint64_t count = this->header_->write_count_;
+  ImageShmSlot *slot = Slot(this->header_, count);
+
+  slot->sequence_ = 2 * count + 1;
+  __sync_synchronize();
+
+  slot->stamp_sec_ = _image.header.stamp.sec;
+  slot->stamp_nsec_ = _image.header.stamp.nsec;
+  slot->height_ = _image.height;
+  slot->width_ = _image.width;
+  slot->step_ = _image.step;
+  slot->is_bigendian_ = _image.is_bigendian;
+  slot->data_size_ = _image.data.size();
+  std::strncpy(slot->encoding_, _image.encoding.c_str(), sizeof(slot->encoding_) - 1);
+  std::strncpy(slot->frame_id_, _image.header.frame_id.c_str(), sizeof(slot->frame_id_) - 1);
+  if (!_image.data.empty())
+    std::memcpy(slot + 1, &_image.data[0], _image.data.size());
+
+  __sync_synchronize();
+  slot->sequence_ = 2 * count + 2;
+  __sync_synchronize();
+  this->header_->write_count_ = count + 1;
+
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Open the ring
+ImageShmRingReader::ImageShmRingReader(const std::string &_name)
+  : header_(NULL), read_count_(0)
+{
+  using namespace boost::interprocess;
+
+  shared_memory_object shm(open_only, _name.c_str(), read_only);
+  this->shm_.swap(shm);
+  mapped_region region(this->shm_, read_only);
+  this->region_.swap(region);
+
+  this->header_ = static_cast<const ImageShmRingHeader*>(this->region_.get_address());
+  if (this->header_->magic_ != IMAGE_SHM_RING_MAGIC)
+    throw interprocess_exception((_name + " is not an initialized image ring").c_str());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Copy the latest image
+bool ImageShmRingReader::Read(sensor_msgs::Image &_image)
+{
+  uint64_t count = this->header_->write_count_;
+  __sync_synchronize();
+  if (count == 0 || count == this->read_count_)
+    return false;
+
+  const ImageShmSlot *slot = Slot(this->header_, count - 1);
+  uint64_t sequence = slot->sequence_;
+  __sync_synchronize();
+  if (sequence != 2 * (count - 1) + 2)
+    return false;
+
+  _image.header.stamp.sec = slot->stamp_sec_;
+  _image.header.stamp.nsec = slot->stamp_nsec_;
+  _image.height = slot->height_;
+  _image.width = slot->width_;
+  _image.step = slot->step_;
+  _image.is_bigendian = slot->is_bigendian_;
+  _image.encoding.assign(slot->encoding_,
+    strnlen(slot->encoding_, sizeof(slot->encoding_)));
+  _image.header.frame_id.assign(slot->frame_id_,
+    strnlen(slot->frame_id_, sizeof(slot->frame_id_)));
+
+  uint32_t size = std::min(slot->data_size_, this->header_->data_capacity_);
+  _image.data.resize(size);
+  if (size > 0)
+    std::memcpy(&_image.data[0], slot + 1, size);
+
+  // The writer has come around to this slot while copying
+  __sync_synchronize();
+  if (slot->sequence_ != sequence)
+    return false;
+
+  this->read_count_ = count;
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Shared memory names cannot contain '/'
+std::string ImageShmRingName(const std::string &_topic)
+{
+  std::string name = "gazebo_ros" + _topic;
+  std::replace(name.begin(), name.end(), '/', '_');
+  return name;
+}
+}
@@ -22,6 +22,7 @@
 
 #include <algorithm>
 #include <assert.h>
+#include <ctime>
 
 #include <gazebo_plugins/gazebo_ros_block_laser.h>
 
@@ -38,8 +39,15 @@
 #include <geometry_msgs/Point32.h>
 #include <sensor_msgs/ChannelFloat32.h>
 
+#include <boost/random/normal_distribution.hpp>
+#include <boost/random/variate_generator.hpp>
+
 #include <tf/tf.h>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 #define EPSILON_DIFF 0.000001
 
 namespace gazebo
@@ -51,12 +59,31 @@ GZ_REGISTER_SENSOR_PLUGIN(GazeboRosBlockLaser)
 // Constructor
 GazeboRosBlockLaser::GazeboRosBlockLaser()
 {
+  this->worker_threads_ = 1;
+  this->work_generation_ = 0;
+  this->work_rows_ = 0;
+  this->work_pending_ = 0;
+  this->work_stop_ = false;
+  this->table_ray_count_ = 0;
+  this->table_range_count_ = 0;
+  this->table_vertical_ray_count_ = 0;
+  this->table_vertical_range_count_ = 0;
+  for (int k = 0; k < 4; ++k)
+    this->table_angles_[k] = 0;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 // Destructor
 GazeboRosBlockLaser::~GazeboRosBlockLaser()
 {
+  // stop the interpolation threads
+  {
+    boost::mutex::scoped_lock worklock(this->work_mutex_);
+    this->work_stop_ = true;
+  }
+  this->work_cond_.notify_all();
+  this->workers_.join_all();
+
   ////////////////////////////////////////////////////////////////////////////////
   // Finalize the controller / Custom Callback Queue
   this->laser_queue_.clear();
@@ -129,6 +156,22 @@ void GazeboRosBlockLaser::Load(sensors::SensorPtr _parent, sdf::ElementPtr _sdf)
 
   ROS_INFO("INFO: gazebo_ros_laser plugin should set minimum intensity to %f due to cutoff in hokuyo filters." , this->hokuyo_min_intensity_);
 
+  if (!_sdf->HasElement("workerThreads"))
+  {
+    this->worker_threads_ = std::max(1u, std::min(boost::thread::hardware_concurrency(), 4u));
+    ROS_INFO("Block laser plugin missing <workerThreads>, defaults to %d", this->worker_threads_);
+  }
+  else
+    this->worker_threads_ = std::max(1, _sdf->GetElement("workerThreads")->Get<int>());
+
+  this->noise_seed_generator_.seed(static_cast<unsigned int>(time(NULL)));
+
+  // the sensor update thread interpolates the first block of rows itself
+  this->row_buffers_.resize(this->worker_threads_);
+  this->worker_seeds_.resize(this->worker_threads_);
+  for (int t = 1; t < this->worker_threads_; ++t)
+    this->workers_.create_thread(boost::bind(&GazeboRosBlockLaser::WorkerThread, this, t));
+
   if (!_sdf->GetElement("updateRate"))
   {
     ROS_INFO("Block laser plugin missing <updateRate>, defaults to 0");
@@ -221,37 +264,28 @@ void GazeboRosBlockLaser::OnNewLaserScans()
 // Put laser data to the interface
 void GazeboRosBlockLaser::PutLaserData(common::Time &_updateTime)
 {
-  int i, hja, hjb;
-  int j, vja, vjb;
-  double vb, hb;
-  int    j1, j2, j3, j4; // four corners indices
-  double r1, r2, r3, r4, r; // four corner values + interpolated range
-  double intensity;
-
-  this->parent_ray_sensor_->SetActive(false);
+  // called from the sensor update, so the scan does not change underneath
+  this->UpdateInterpolationTables();
 
-  math::Angle maxAngle = this->parent_ray_sensor_->GetAngleMax();
-  math::Angle minAngle = this->parent_ray_sensor_->GetAngleMin();
+  if (this->table_range_count_ == 0 || this->table_vertical_range_count_ == 0)
+    return;
 
   double maxRange = this->parent_ray_sensor_->GetRangeMax();
   double minRange = this->parent_ray_sensor_->GetRangeMin();
-  int rayCount = this->parent_ray_sensor_->GetRayCount();
-  int rangeCount = this->parent_ray_sensor_->GetRangeCount();
-
-  int verticalRayCount = this->parent_ray_sensor_->GetVerticalRayCount();
-  int verticalRangeCount = this->parent_ray_sensor_->GetVerticalRangeCount();
-  math::Angle verticalMaxAngle = this->parent_ray_sensor_->GetVerticalAngleMax();
-  math::Angle verticalMinAngle = this->parent_ray_sensor_->GetVerticalAngleMin();
-
-  double yDiff = maxAngle.Radian() - minAngle.Radian();
-  double pDiff = verticalMaxAngle.Radian() - verticalMinAngle.Radian();
-
-
-  // set size of cloud message everytime!
-  //int r_size = rangeCount * verticalRangeCount;
-  this->cloud_msg_.points.clear();
-  this->cloud_msg_.channels.clear();
-  this->cloud_msg_.channels.push_back(sensor_msgs::ChannelFloat32());
+  int rayCount = this->table_ray_count_;
+  int rangeCount = this->table_range_count_;
+  int verticalRayCount = this->table_vertical_ray_count_;
+  int verticalRangeCount = this->table_vertical_range_count_;
+
+  // read every ray once instead of four times per point
+  int rays = rayCount * verticalRayCount;
+  this->ranges_.resize(rays);
+  this->retros_.resize(rays);
+  for (int k = 0; k < rays; ++k)
+  {
+    this->ranges_[k] = static_cast<float>(std::min(this->parent_ray_sensor_->GetLaserShape()->GetRange(k), maxRange-minRange));
+    this->retros_[k] = static_cast<float>(this->parent_ray_sensor_->GetLaserShape()->GetRetro(k));
+  }
 
   /***************************************************************/
   /*                                                             */
@@ -264,116 +298,278 @@ void GazeboRosBlockLaser::PutLaserData(common::Time &_updateTime)
   this->cloud_msg_.header.stamp.sec = _updateTime.sec;
   this->cloud_msg_.header.stamp.nsec = _updateTime.nsec;
 
-  for (j = 0; j<verticalRangeCount; j++)
+  // reuse the buffers of the last scan
+  this->cloud_msg_.points.resize(rangeCount * verticalRangeCount);
+  this->cloud_msg_.channels.resize(1);
+  this->cloud_msg_.channels[0].values.resize(rangeCount * verticalRangeCount);
+
+  // interpolate blocks of rows in parallel, each with its own noise generator
+  int threads = this->worker_threads_;
+  {
+    boost::mutex::scoped_lock worklock(this->work_mutex_);
+    for (int t = 0; t < threads; ++t)
+      this->worker_seeds_[t] = static_cast<unsigned int>(this->noise_seed_generator_());
+    this->work_rows_ = verticalRangeCount;
+    this->work_pending_ = threads - 1;
+    ++this->work_generation_;
+  }
+  this->work_cond_.notify_all();
+
+  this->InterpolateRows(0, verticalRangeCount / threads,
+    this->worker_seeds_[0], this->row_buffers_[0]);
+
+  {
+    boost::mutex::scoped_lock worklock(this->work_mutex_);
+    while (this->work_pending_ > 0)
+      this->work_done_cond_.wait(worklock);
+  }
+
+  // send data out via ros message
+  this->pub_.publish(this->cloud_msg_);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Rebuild the interpolation tables
+void GazeboRosBlockLaser::UpdateInterpolationTables()
+{
+  int rayCount = this->parent_ray_sensor_->GetRayCount();
+  int rangeCount = this->parent_ray_sensor_->GetRangeCount();
+  int verticalRayCount = this->parent_ray_sensor_->GetVerticalRayCount();
+  int verticalRangeCount = this->parent_ray_sensor_->GetVerticalRangeCount();
+
+  double angles[4] = {
+    this->parent_ray_sensor_->GetAngleMin().Radian(),
+    this->parent_ray_sensor_->GetAngleMax().Radian(),
+    this->parent_ray_sensor_->GetVerticalAngleMin().Radian(),
+    this->parent_ray_sensor_->GetVerticalAngleMax().Radian() };
+
+  if (rayCount == this->table_ray_count_ &&
+      rangeCount == this->table_range_count_ &&
+      verticalRayCount == this->table_vertical_ray_count_ &&
+      verticalRangeCount == this->table_vertical_range_count_ &&
+      std::equal(angles, angles + 4, this->table_angles_))
+    return;
+
+  this->table_ray_count_ = rayCount;
+  this->table_range_count_ = rangeCount;
+  this->table_vertical_ray_count_ = verticalRayCount;
+  this->table_vertical_range_count_ = verticalRangeCount;
+  std::copy(angles, angles + 4, this->table_angles_);
+
+  double yDiff = angles[1] - angles[0];
+  double pDiff = angles[3] - angles[2];
+
+  for (unsigned int t = 0; t < this->row_buffers_.size(); ++t)
+  {
+    RowBuffers &buffers = this->row_buffers_[t];
+    buffers.ray_range.resize(rayCount);
+    buffers.ray_retro.resize(rayCount);
+    buffers.range_a.resize(rangeCount);
+    buffers.range_b.resize(rangeCount);
+    buffers.range.resize(rangeCount);
+    buffers.x.resize(rangeCount);
+    buffers.y.resize(rangeCount);
+    buffers.z.resize(rangeCount);
+  }
+
+  this->beam_ray_a_.resize(rangeCount);
+  this->beam_ray_b_.resize(rangeCount);
+  this->beam_weight_.resize(rangeCount);
+  this->beam_cos_.resize(rangeCount);
+  this->beam_sin_.resize(rangeCount);
+
+  for (int i = 0; i < rangeCount; i++)
+  {
+    // Interpolate the range readings from the rays in horizontal direction
+    double hb = (rangeCount == 1)? 0 : (double) i * (rayCount - 1) / (rangeCount - 1);
+    int hja = (int) floor(hb);
+    int hjb = std::min(hja + 1, rayCount - 1);
+
+    assert(hja >= 0 && hja < rayCount);
+    assert(hjb >= 0 && hjb < rayCount);
+
+    // get angles of ray to get xyz for point
+    double yAngle = angles[0];
+    if (rayCount > 1)
+      yAngle += 0.5*(hja+hjb) * yDiff / (rayCount -1);
+
+    this->beam_ray_a_[i] = hja;
+    this->beam_ray_b_[i] = hjb;
+    this->beam_weight_[i] = hb - floor(hb); // fraction from min
+    this->beam_cos_[i] = cos(yAngle);
+    this->beam_sin_[i] = sin(yAngle);
+  }
+
+  this->row_ray_a_.resize(verticalRangeCount);
+  this->row_ray_b_.resize(verticalRangeCount);
+  this->row_weight_.resize(verticalRangeCount);
+  this->row_cos_.resize(verticalRangeCount);
+  this->row_sin_.resize(verticalRangeCount);
+
+  for (int j = 0; j < verticalRangeCount; j++)
   {
     // interpolating in vertical direction
-    vb = (verticalRangeCount == 1) ? 0 : (double) j * (verticalRayCount - 1) / (verticalRangeCount - 1);
-    vja = (int) floor(vb);
-    vjb = std::min(vja + 1, verticalRayCount - 1);
-    vb = vb - floor(vb); // fraction from min
+    double vb = (verticalRangeCount == 1) ? 0 : (double) j * (verticalRayCount - 1) / (verticalRangeCount - 1);
+    int vja = (int) floor(vb);
+    int vjb = std::min(vja + 1, verticalRayCount - 1);
 
     assert(vja >= 0 && vja < verticalRayCount);
     assert(vjb >= 0 && vjb < verticalRayCount);
 
-    for (i = 0; i<rangeCount; i++)
+    double pAngle = angles[2];
+    if (verticalRayCount > 1)
+      pAngle += 0.5*(vja+vjb) * pDiff / (verticalRayCount -1);
+
+    this->row_ray_a_[j] = vja;
+    this->row_ray_b_[j] = vjb;
+    this->row_weight_[j] = vb - floor(vb); // fraction from min
+    this->row_cos_[j] = cos(pAngle);
+    this->row_sin_[j] = sin(pAngle);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Interpolation thread, runs one block of rows for every scan
+void GazeboRosBlockLaser::WorkerThread(int _index)
+{
+  unsigned int generation = 0;
+
+  while (true)
+  {
+    int rows;
     {
-      // Interpolate the range readings from the rays in horizontal direction
-      hb = (rangeCount == 1)? 0 : (double) i * (rayCount - 1) / (rangeCount - 1);
-      hja = (int) floor(hb);
-      hjb = std::min(hja + 1, rayCount - 1);
-      hb = hb - floor(hb); // fraction from min
-
-      assert(hja >= 0 && hja < rayCount);
-      assert(hjb >= 0 && hjb < rayCount);
-
-      // indices of 4 corners
-      j1 = hja + vja * rayCount;
-      j2 = hjb + vja * rayCount;
-      j3 = hja + vjb * rayCount;
-      j4 = hjb + vjb * rayCount;
-      // range readings of 4 corners
-      r1 = std::min(this->parent_ray_sensor_->GetLaserShape()->GetRange(j1) , maxRange-minRange);
-      r2 = std::min(this->parent_ray_sensor_->GetLaserShape()->GetRange(j2) , maxRange-minRange);
-      r3 = std::min(this->parent_ray_sensor_->GetLaserShape()->GetRange(j3) , maxRange-minRange);
-      r4 = std::min(this->parent_ray_sensor_->GetLaserShape()->GetRange(j4) , maxRange-minRange);
-
-      // Range is linear interpolation if values are close,
-      // and min if they are very different
-      r = (1-vb)*((1 - hb) * r1 + hb * r2)
-         +   vb *((1 - hb) * r3 + hb * r4);
-
-      // Intensity is averaged
-      intensity = 0.25*(this->parent_ray_sensor_->GetLaserShape()->GetRetro(j1) +
-                        this->parent_ray_sensor_->GetLaserShape()->GetRetro(j2) +
-                        this->parent_ray_sensor_->GetLaserShape()->GetRetro(j3) +
-                        this->parent_ray_sensor_->GetLaserShape()->GetRetro(j4));
-
-      // std::cout << " block debug "
-      //           << "  ij("<<i<<","<<j<<")"
-      //           << "  j1234("<<j1<<","<<j2<<","<<j3<<","<<j4<<")"
-      //           << "  r1234("<<r1<<","<<r2<<","<<r3<<","<<r4<<")"
-      //           << std::endl;
-
-      // get angles of ray to get xyz for point
-      double yAngle = 0.5*(hja+hjb) * yDiff / (rayCount -1) + minAngle.Radian();
-      double pAngle = 0.5*(vja+vjb) * pDiff / (verticalRayCount -1) + verticalMinAngle.Radian();
-
-      /***************************************************************/
-      /*                                                             */
-      /*  point scan from laser                                      */
-      /*                                                             */
-      /***************************************************************/
-      //compare 2 doubles
-      double diffRange = maxRange - minRange;
-      double diff  = diffRange - r;
-      if (fabs(diff) < EPSILON_DIFF)
-      {
-        // no noise if at max range
-        geometry_msgs::Point32 point;
-        //pAngle is rotated by yAngle:
-        point.x = r * cos(pAngle) * cos(yAngle);
-        point.y = r * cos(pAngle) * sin(yAngle);
-        point.z = -r * sin(pAngle);
-
-        this->cloud_msg_.points.push_back(point); 
-      } 
-      else 
-      { 
-        geometry_msgs::Point32 point;
-        //pAngle is rotated by yAngle:
-        point.x = r * cos(pAngle) * cos(yAngle) + this->GaussianKernel(0,this->gaussian_noise_);
-        point.y = r * cos(pAngle) * sin(yAngle) + this->GaussianKernel(0,this->gaussian_noise_);
-        point.z = -r * sin(pAngle) + this->GaussianKernel(0,this->gaussian_noise_);
-        this->cloud_msg_.points.push_back(point); 
-      } // only 1 channel 
-
-      this->cloud_msg_.channels[0].values.push_back(intensity + this->GaussianKernel(0,this->gaussian_noise_)) ;
+      boost::mutex::scoped_lock worklock(this->work_mutex_);
+      while (!this->work_stop_ && this->work_generation_ == generation)
+        this->work_cond_.wait(worklock);
+      if (this->work_stop_)
+        return;
+      generation = this->work_generation_;
+      rows = this->work_rows_;
     }
+
+    int threads = this->worker_threads_;
+    this->InterpolateRows(_index * rows / threads, (_index + 1) * rows / threads,
+      this->worker_seeds_[_index], this->row_buffers_[_index]);
+
+    boost::mutex::scoped_lock worklock(this->work_mutex_);
+    if (--this->work_pending_ == 0)
+      this->work_done_cond_.notify_one();
   }
-  this->parent_ray_sensor_->SetActive(true);
+}
 
-  // send data out via ros message
-  this->pub_.publish(this->cloud_msg_);
+////////////////////////////////////////////////////////////////////////////////
+// Interpolate a block of rows
+void GazeboRosBlockLaser::InterpolateRows(int _rowBegin, int _rowEnd, unsigned int _seed,
+                                          RowBuffers &_buffers)
+{
+  int rayCount = this->table_ray_count_;
+  int rangeCount = this->table_range_count_;
+  float diffRange = static_cast<float>(this->parent_ray_sensor_->GetRangeMax() - this->parent_ray_sensor_->GetRangeMin());
+
+  boost::mt19937 engine(_seed);
+  boost::variate_generator<boost::mt19937&, boost::normal_distribution<double> >
+    noise(engine, boost::normal_distribution<double>(0.0, 1.0));
+  double sigma = this->gaussian_noise_;
+
+  const int *beamA = &this->beam_ray_a_[0];
+  const int *beamB = &this->beam_ray_b_[0];
+  const float *hb = &this->beam_weight_[0];
+  const float *yCos = &this->beam_cos_[0];
+  const float *ySin = &this->beam_sin_[0];
+
+  float *rayRange = &_buffers.ray_range[0];
+  float *rayRetro = &_buffers.ray_retro[0];
+  float *rangeA = &_buffers.range_a[0];
+  float *rangeB = &_buffers.range_b[0];
+  float *range = &_buffers.range[0];
+  float *x = &_buffers.x[0];
+  float *y = &_buffers.y[0];
+  float *z = &_buffers.z[0];
+
+  for (int j = _rowBegin; j < _rowEnd; j++)
+  {
+    float vb = this->row_weight_[j];
+    float pCos = this->row_cos_[j];
+    float pSin = this->row_sin_[j];
+
+    // interpolate the two rows of rays around this row in vertical direction
+    const float *rowRangeA = &this->ranges_[this->row_ray_a_[j] * rayCount];
+    const float *rowRangeB = &this->ranges_[this->row_ray_b_[j] * rayCount];
+    const float *rowRetroA = &this->retros_[this->row_ray_a_[j] * rayCount];
+    const float *rowRetroB = &this->retros_[this->row_ray_b_[j] * rayCount];
+    for (int k = 0; k < rayCount; k++)
+    {
+      rayRange[k] = rowRangeA[k] + vb * (rowRangeB[k] - rowRangeA[k]);
+      rayRetro[k] = rowRetroA[k] + rowRetroB[k];
+    }
+
+    geometry_msgs::Point32 *points = &this->cloud_msg_.points[j * rangeCount];
+    float *intensities = &this->cloud_msg_.channels[0].values[j * rangeCount];
 
+    // gather the two rays around every beam into contiguous arrays
+    for (int i = 0; i < rangeCount; i++)
+    {
+      rangeA[i] = rayRange[beamA[i]];
+      rangeB[i] = rayRange[beamB[i]];
+      // Intensity is averaged over the four corners, scaled below
+      intensities[i] = rayRetro[beamA[i]] + rayRetro[beamB[i]];
+    }
 
+    // Range is bilinear interpolation of the four corners,
+    // pAngle is rotated by yAngle
+    int i = 0;
+#if defined(__SSE2__)
+    const __m128 v_pCos = _mm_set1_ps(pCos);
+    const __m128 v_pSin = _mm_set1_ps(-pSin);
+    const __m128 v_quarter = _mm_set1_ps(0.25f);
 
-}
+    for (; i + 4 <= rangeCount; i += 4)
+    {
+      __m128 v_a = _mm_loadu_ps(rangeA + i);
+      __m128 v_b = _mm_loadu_ps(rangeB + i);
+      __m128 v_r = _mm_add_ps(v_a, _mm_mul_ps(_mm_loadu_ps(hb + i), _mm_sub_ps(v_b, v_a)));
+      __m128 v_rCos = _mm_mul_ps(v_r, v_pCos);
+      _mm_storeu_ps(range + i, v_r);
+      _mm_storeu_ps(x + i, _mm_mul_ps(v_rCos, _mm_loadu_ps(yCos + i)));
+      _mm_storeu_ps(y + i, _mm_mul_ps(v_rCos, _mm_loadu_ps(ySin + i)));
+      _mm_storeu_ps(z + i, _mm_mul_ps(v_r, v_pSin));
+      _mm_storeu_ps(intensities + i, _mm_mul_ps(_mm_loadu_ps(intensities + i), v_quarter));
+    }
+#endif
 
+    for (; i < rangeCount; i++)
+    {
+      float r = rangeA[i] + hb[i] * (rangeB[i] - rangeA[i]);
+      range[i] = r;
+      x[i] = r * pCos * yCos[i];
+      y[i] = r * pCos * ySin[i];
+      z[i] = -r * pSin;
+      intensities[i] *= 0.25f;
+    }
 
-//////////////////////////////////////////////////////////////////////////////
-// Utility for adding noise
-double GazeboRosBlockLaser::GaussianKernel(double mu,double sigma)
-{
-  // using Box-Muller transform to generate two independent standard normally disbributed normal variables
-  // see wikipedia
-  double U = (double)rand()/(double)RAND_MAX; // normalized uniform random variable
-  double V = (double)rand()/(double)RAND_MAX; // normalized uniform random variable
-  double X = sqrt(-2.0 * ::log(U)) * cos( 2.0*M_PI * V);
-  //double Y = sqrt(-2.0 * ::log(U)) * sin( 2.0*M_PI * V); // the other indep. normal variable
-  // we'll just use X
-  // scale to our mu and sigma
-  X = sigma * X + mu;
-  return X;
+    // the noise generator is sequential, so noise is added in a separate pass
+    if (sigma != 0)
+    {
+      for (i = 0; i < rangeCount; i++)
+      {
+        // no noise if at max range
+        if (fabs(diffRange - range[i]) >= EPSILON_DIFF)
+        {
+          x[i] += sigma * noise();
+          y[i] += sigma * noise();
+          z[i] += sigma * noise();
+        }
+        intensities[i] += sigma * noise();
+      }
+    }
+
+    for (i = 0; i < rangeCount; i++)
+    {
+      points[i].x = x[i];
+      points[i].y = y[i];
+      points[i].z = z[i];
+    }
+  }
 }
 
 // Custom Callback Queue
@@ -55,6 +55,8 @@ GazeboRosCameraUtils::GazeboRosCameraUtils()
   this->skip_ = 0;
   this->format_ = "";
   this->initialized_ = false;
+  this->zero_copy_ = false;
+  this->shm_ring_slots_ = 0;
 }
 
 void GazeboRosCameraUtils::configCallback(
@@ -231,6 +233,16 @@ void GazeboRosCameraUtils::Load(sensors::SensorPtr _parent,
   else
     this->distortion_t2_ = this->sdf->Get<double>("distortionT2");
 
+  if (!this->sdf->HasElement("zeroCopy"))
+    this->zero_copy_ = false;
+  else
+    this->zero_copy_ = this->sdf->Get<bool>("zeroCopy");
+
+  if (!this->sdf->HasElement("sharedMemorySlots"))
+    this->shm_ring_slots_ = 0;
+  else
+    this->shm_ring_slots_ = this->sdf->Get<int>("sharedMemorySlots");
+
   if ((this->distortion_k1_ != 0.0) || (this->distortion_k2_ != 0.0) ||
       (this->distortion_k3_ != 0.0) || (this->distortion_t1_ != 0.0) ||
       (this->distortion_t2_ != 0.0))
@@ -572,6 +584,26 @@ void GazeboRosCameraUtils::PutCameraData(const unsigned char *_src)
   /// don't bother if there are no subscribers
   if ((*this->image_connect_count_) > 0)
   {
+    if (this->zero_copy_)
+    {
+      // a recycled image already has a buffer of the right size
+      sensor_msgs::ImagePtr image = this->image_pool_.Allocate();
+      image->header.frame_id = this->frame_name_;
+      image->header.stamp.sec = this->sensor_update_time_.sec;
+      image->header.stamp.nsec = this->sensor_update_time_.nsec;
+      fillImage(*image, this->type_, this->height_, this->width_,
+          this->skip_*this->width_, reinterpret_cast<const void*>(_src));
+
+      {
+        boost::mutex::scoped_lock lock(this->lock_);
+        this->last_image_ = image;
+      }
+
+      this->PutSharedMemoryImage(*image);
+      this->image_pub_.publish(sensor_msgs::ImageConstPtr(image));
+      return;
+    }
+
     boost::mutex::scoped_lock lock(this->lock_);
 
     // copy data into image
@@ -583,11 +615,42 @@ void GazeboRosCameraUtils::PutCameraData(const unsigned char *_src)
     fillImage(this->image_msg_, this->type_, this->height_, this->width_,
         this->skip_*this->width_, reinterpret_cast<const void*>(_src));
 
+    this->PutSharedMemoryImage(this->image_msg_);
+
     // publish to ros
     this->image_pub_.publish(this->image_msg_);
   }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+// Write image to the shared memory ring
+void GazeboRosCameraUtils::PutSharedMemoryImage(const sensor_msgs::Image &_image)
+{
+  if (this->shm_ring_slots_ <= 0)
+    return;
+
+  // the ring is sized by the first image, as the format may not be known at load
+  if (!this->shm_ring_)
+  {
+    std::string name = ImageShmRingName(this->rosnode_->resolveName(this->image_topic_name_));
+    try
+    {
+      this->shm_ring_.reset(new ImageShmRingWriter(name, this->shm_ring_slots_, _image.data.size()));
+      ROS_INFO("Camera images are also written to shared memory [%s]", name.c_str());
+    }
+    catch (boost::interprocess::interprocess_exception &e)
+    {
+      ROS_ERROR("Failed to create shared memory [%s] : %s", name.c_str(), e.what());
+      this->shm_ring_slots_ = 0;
+      return;
+    }
+  }
+
+  if (!this->shm_ring_->Write(_image))
+    ROS_WARN_THROTTLE(1.0, "Image of %lu bytes does not fit in shared memory slots",
+                      (unsigned long)_image.data.size());
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // Put camera_ data to the interface
 void GazeboRosCameraUtils::PublishCameraInfo(common::Time &last_update_time)
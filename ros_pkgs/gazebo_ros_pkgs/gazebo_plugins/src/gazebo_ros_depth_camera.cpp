@@ -33,6 +33,11 @@
 
 #include <sensor_msgs/point_cloud2_iterator.h>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#include <xmmintrin.h>
+#endif
+
 #include <tf/tf.h>
 
 namespace gazebo
@@ -47,6 +52,7 @@ GazeboRosDepthCamera::GazeboRosDepthCamera()
   this->point_cloud_connect_count_ = 0;
   this->depth_info_connect_count_ = 0;
   this->last_depth_image_camera_info_update_time_ = common::Time(0);
+  this->ray_table_hfov_ = 0.0;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -277,8 +283,8 @@ void GazeboRosDepthCamera::OnNewRGBPointCloud(const float *_pcd,
         }
       }
 
-      this->point_cloud_pub_.publish(this->point_cloud_msg_);
       this->lock_.unlock();
+      this->point_cloud_pub_.publish(this->point_cloud_msg_);
     }
   }
 }
@@ -312,47 +318,91 @@ void GazeboRosDepthCamera::OnNewImageFrame(const unsigned char *_image,
 // Put camera data to the interface
 void GazeboRosDepthCamera::FillPointdCloud(const float *_src)
 {
+  sensor_msgs::PointCloud2Ptr pooled_msg;
+  if (this->zero_copy_)
+    pooled_msg = this->point_cloud_pool_.Allocate();
+  sensor_msgs::PointCloud2 &point_cloud_msg =
+    pooled_msg ? *pooled_msg : this->point_cloud_msg_;
+
   this->lock_.lock();
 
-  this->point_cloud_msg_.header.frame_id = this->frame_name_;
-  this->point_cloud_msg_.header.stamp.sec = this->depth_sensor_update_time_.sec;
-  this->point_cloud_msg_.header.stamp.nsec = this->depth_sensor_update_time_.nsec;
-  this->point_cloud_msg_.width = this->width;
-  this->point_cloud_msg_.height = this->height;
-  this->point_cloud_msg_.row_step = this->point_cloud_msg_.point_step * this->width;
+  point_cloud_msg.header.frame_id = this->frame_name_;
+  point_cloud_msg.header.stamp.sec = this->depth_sensor_update_time_.sec;
+  point_cloud_msg.header.stamp.nsec = this->depth_sensor_update_time_.nsec;
+  point_cloud_msg.width = this->width;
+  point_cloud_msg.height = this->height;
+  point_cloud_msg.row_step = point_cloud_msg.point_step * this->width;
 
   ///copy from depth to point cloud message
-  FillPointCloudHelper(this->point_cloud_msg_,
+  FillPointCloudHelper(point_cloud_msg,
                  this->height,
                  this->width,
                  this->skip_,
                  (void*)_src );
 
-  this->point_cloud_pub_.publish(this->point_cloud_msg_);
-
   this->lock_.unlock();
+
+  // point_cloud_msg_ is only written from the sensor thread,
+  // so serialization does not have to block the image callbacks
+  if (pooled_msg)
+    this->point_cloud_pub_.publish(sensor_msgs::PointCloud2ConstPtr(pooled_msg));
+  else
+    this->point_cloud_pub_.publish(this->point_cloud_msg_);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 // Put depth image data to the interface
 void GazeboRosDepthCamera::FillDepthImage(const float *_src)
 {
+  sensor_msgs::ImagePtr pooled_msg;
+  if (this->zero_copy_)
+    pooled_msg = this->depth_image_pool_.Allocate();
+  sensor_msgs::Image &depth_image_msg =
+    pooled_msg ? *pooled_msg : this->depth_image_msg_;
+
   this->lock_.lock();
   // copy data into image
-  this->depth_image_msg_.header.frame_id = this->frame_name_;
-  this->depth_image_msg_.header.stamp.sec = this->depth_sensor_update_time_.sec;
-  this->depth_image_msg_.header.stamp.nsec = this->depth_sensor_update_time_.nsec;
+  depth_image_msg.header.frame_id = this->frame_name_;
+  depth_image_msg.header.stamp.sec = this->depth_sensor_update_time_.sec;
+  depth_image_msg.header.stamp.nsec = this->depth_sensor_update_time_.nsec;
 
   ///copy from depth to depth image message
-  FillDepthImageHelper(this->depth_image_msg_,
+  FillDepthImageHelper(depth_image_msg,
                  this->height,
                  this->width,
                  this->skip_,
                  (void*)_src );
 
-  this->depth_image_pub_.publish(this->depth_image_msg_);
-
   this->lock_.unlock();
+
+  if (pooled_msg)
+    this->depth_image_pub_.publish(sensor_msgs::ImageConstPtr(pooled_msg));
+  else
+    this->depth_image_pub_.publish(this->depth_image_msg_);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Cache direction of rays through pixels
+void GazeboRosDepthCamera::UpdateRayTable(uint32_t rows_arg, uint32_t cols_arg)
+{
+  double hfov = this->parentSensor->GetDepthCamera()->GetHFOV().Radian();
+
+  if (this->ray_x_.size() == cols_arg && this->ray_y_.size() == rows_arg &&
+      this->ray_table_hfov_ == hfov)
+    return;
+
+  double fl = ((double)this->width) / (2.0 *tan(hfov/2.0));
+
+  // tan(atan2(i - cx, fl)) reduces to (i - cx) / fl
+  this->ray_x_.resize(cols_arg);
+  for (uint32_t i=0; i<cols_arg; i++)
+    this->ray_x_[i] = ((double)i - 0.5*(double)(cols_arg-1)) / fl;
+
+  this->ray_y_.resize(rows_arg);
+  for (uint32_t j=0; j<rows_arg; j++)
+    this->ray_y_[j] = ((double)j - 0.5*(double)(rows_arg-1)) / fl;
+
+  this->ray_table_hfov_ = hfov;
 }
 
 
@@ -366,76 +416,115 @@ bool GazeboRosDepthCamera::FillPointCloudHelper(
   pcd_modifier.setPointCloud2FieldsByString(2, "xyz", "rgb");
   pcd_modifier.resize(rows_arg*cols_arg);
 
-  sensor_msgs::PointCloud2Iterator<float> iter_x(point_cloud_msg_, "x");
-  sensor_msgs::PointCloud2Iterator<float> iter_y(point_cloud_msg_, "y");
-  sensor_msgs::PointCloud2Iterator<float> iter_z(point_cloud_msg_, "z");
-  sensor_msgs::PointCloud2Iterator<uint8_t> iter_rgb(point_cloud_msg_, "rgb");
-
-  point_cloud_msg.is_dense = true;
+  this->UpdateRayTable(rows_arg, cols_arg);
 
-  float* toCopyFrom = (float*)data_arg;
-  int index = 0;
+  // x, y and z are packed at the head of each point, followed by rgb
+  const uint32_t point_step = point_cloud_msg.point_step;
+  uint32_t rgb_offset = 0;
+  for (unsigned int f = 0; f < point_cloud_msg.fields.size(); f++)
+  {
+    if (point_cloud_msg.fields[f].name == "rgb")
+      rgb_offset = point_cloud_msg.fields[f].offset;
+  }
 
-  double hfov = this->parentSensor->GetDepthCamera()->GetHFOV().Radian();
-  double fl = ((double)this->width) / (2.0 *tan(hfov/2.0));
+  bool is_dense = true;
+  const float* toCopyFrom = (const float*)data_arg;
+  const float cutoff = this->point_cloud_cutoff_;
+  const float bad_point = std::numeric_limits<float>::quiet_NaN();
 
-  // convert depth to point cloud
+  // in optical frame
+  // hardcoded rotation rpy(-M_PI/2, 0, -M_PI/2) is built-in
+  // to urdf, where the *_optical_frame should have above relative
+  // rotation from the physical camera *_frame
   for (uint32_t j=0; j<rows_arg; j++)
   {
-    double pAngle;
-    if (rows_arg>1) pAngle = atan2( (double)j - 0.5*(double)(rows_arg-1), fl);
-    else            pAngle = 0.0;
+    const float* depth = toCopyFrom + j*cols_arg;
+    const float ray_y = this->ray_y_[j];
+    uint8_t* dest = &point_cloud_msg.data[0] + j*cols_arg*point_step;
+    uint32_t i = 0;
 
-    for (uint32_t i=0; i<cols_arg; i++, ++iter_x, ++iter_y, ++iter_z, ++iter_rgb)
+#if defined(__SSE2__)
+    const __m128 v_ray_y = _mm_set1_ps(ray_y);
+    const __m128 v_cutoff = _mm_set1_ps(cutoff);
+    const __m128 v_bad = _mm_set1_ps(bad_point);
+
+    for (; i + 4 <= cols_arg; i += 4)
     {
-      double yAngle;
-      if (cols_arg>1) yAngle = atan2( (double)i - 0.5*(double)(cols_arg-1), fl);
-      else            yAngle = 0.0;
-
-      double depth = toCopyFrom[index++];
-
-      // in optical frame
-      // hardcoded rotation rpy(-M_PI/2, 0, -M_PI/2) is built-in
-      // to urdf, where the *_optical_frame should have above relative
-      // rotation from the physical camera *_frame
-      *iter_x      = depth * tan(yAngle);
-      *iter_y      = depth * tan(pAngle);
-      if(depth > this->point_cloud_cutoff_)
+      __m128 v_z = _mm_loadu_ps(depth + i);
+      // false for NaN depth as well as points in the unseeable range
+      __m128 valid = _mm_cmpgt_ps(v_z, v_cutoff);
+      __m128 v_x = _mm_mul_ps(v_z, _mm_loadu_ps(&this->ray_x_[i]));
+      __m128 v_y = _mm_mul_ps(v_z, v_ray_y);
+
+      v_x = _mm_or_ps(_mm_and_ps(valid, v_x), _mm_andnot_ps(valid, v_bad));
+      v_y = _mm_or_ps(_mm_and_ps(valid, v_y), _mm_andnot_ps(valid, v_bad));
+      v_z = _mm_or_ps(_mm_and_ps(valid, v_z), _mm_andnot_ps(valid, v_bad));
+      if (_mm_movemask_ps(valid) != 0xf)
+        is_dense = false;
+
+      // Transpose into 4 points of (x, y, z, 0)
+      __m128 v_w = _mm_setzero_ps();
+      _MM_TRANSPOSE4_PS(v_x, v_y, v_z, v_w);
+      _mm_storeu_ps((float*)(dest + (i+0)*point_step), v_x);
+      _mm_storeu_ps((float*)(dest + (i+1)*point_step), v_y);
+      _mm_storeu_ps((float*)(dest + (i+2)*point_step), v_z);
+      _mm_storeu_ps((float*)(dest + (i+3)*point_step), v_w);
+    }
+#endif
+
+    for (; i<cols_arg; i++)
+    {
+      float* point = (float*)(dest + i*point_step);
+      if (depth[i] > cutoff)
       {
-        *iter_z    = depth;
+        point[0] = depth[i] * this->ray_x_[i];
+        point[1] = depth[i] * ray_y;
+        point[2] = depth[i];
       }
       else //point in the unseeable range
       {
-        *iter_x = *iter_y = *iter_z = std::numeric_limits<float>::quiet_NaN ();
-        point_cloud_msg.is_dense = false;
+        point[0] = point[1] = point[2] = bad_point;
+        is_dense = false;
       }
+    }
 
-      // put image color data for each point
-      uint8_t*  image_src = (uint8_t*)(&(this->image_msg_.data[0]));
-      if (this->image_msg_.data.size() == rows_arg*cols_arg*3)
+    // put image color data for each point
+    const sensor_msgs::Image& image = this->GetLatestImage();
+    const uint8_t* image_src = image.data.empty() ? NULL : &image.data[0];
+    uint8_t* rgb = dest + rgb_offset;
+
+    if (image.data.size() == rows_arg*cols_arg*3)
+    {
+      // color
+      const uint8_t* src = image_src + j*cols_arg*3;
+      for (i=0; i<cols_arg; i++, rgb += point_step, src += 3)
       {
-        // color
-        iter_rgb[0] = image_src[i*3+j*cols_arg*3+0];
-        iter_rgb[1] = image_src[i*3+j*cols_arg*3+1];
-        iter_rgb[2] = image_src[i*3+j*cols_arg*3+2];
+        rgb[0] = src[0];
+        rgb[1] = src[1];
+        rgb[2] = src[2];
       }
-      else if (this->image_msg_.data.size() == rows_arg*cols_arg)
+    }
+    else if (image.data.size() == rows_arg*cols_arg)
+    {
+      // mono (or bayer?  @todo; fix for bayer)
+      const uint8_t* src = image_src + j*cols_arg;
+      for (i=0; i<cols_arg; i++, rgb += point_step, src++)
       {
-        // mono (or bayer?  @todo; fix for bayer)
-        iter_rgb[0] = image_src[i+j*cols_arg];
-        iter_rgb[1] = image_src[i+j*cols_arg];
-        iter_rgb[2] = image_src[i+j*cols_arg];
+        rgb[0] = rgb[1] = rgb[2] = src[0];
       }
-      else
+    }
+    else
+    {
+      // no image
+      for (i=0; i<cols_arg; i++, rgb += point_step)
       {
-        // no image
-        iter_rgb[0] = 0;
-        iter_rgb[1] = 0;
-        iter_rgb[2] = 0;
+        rgb[0] = rgb[1] = rgb[2] = 0;
       }
     }
   }
 
+  point_cloud_msg.is_dense = is_dense;
+
   return true;
 }
 
@@ -453,26 +542,38 @@ bool GazeboRosDepthCamera::FillDepthImageHelper(
   image_msg.is_bigendian = 0;
 
   const float bad_point = std::numeric_limits<float>::quiet_NaN();
+  const float cutoff = this->point_cloud_cutoff_;
 
   float* dest = (float*)(&(image_msg.data[0]));
-  float* toCopyFrom = (float*)data_arg;
-  int index = 0;
+  const float* toCopyFrom = (const float*)data_arg;
+  const uint32_t size = rows_arg * cols_arg;
+  uint32_t index = 0;
+
+  // rows are contiguous in both images, so convert them as a single array
+#if defined(__SSE2__)
+  const __m128 v_cutoff = _mm_set1_ps(cutoff);
+  const __m128 v_bad = _mm_set1_ps(bad_point);
 
-  // convert depth to point cloud
-  for (uint32_t j = 0; j < rows_arg; j++)
+  for (; index + 4 <= size; index += 4)
   {
-    for (uint32_t i = 0; i < cols_arg; i++)
-    {
-      float depth = toCopyFrom[index++];
+    __m128 v_depth = _mm_loadu_ps(toCopyFrom + index);
+    __m128 valid = _mm_cmpgt_ps(v_depth, v_cutoff);
+    _mm_storeu_ps(dest + index,
+      _mm_or_ps(_mm_and_ps(valid, v_depth), _mm_andnot_ps(valid, v_bad)));
+  }
+#endif
 
-      if (depth > this->point_cloud_cutoff_)
-      {
-        dest[i + j * cols_arg] = depth;
-      }
-      else //point in the unseeable range
-      {
-        dest[i + j * cols_arg] = bad_point;
-      }
+  for (; index < size; index++)
+  {
+    float depth = toCopyFrom[index];
+
+    if (depth > cutoff)
+    {
+      dest[index] = depth;
+    }
+    else //point in the unseeable range
+    {
+      dest[index] = bad_point;
     }
   }
   return true;
@@ -250,47 +250,67 @@ void GazeboRosOpenniKinect::OnNewImageFrame(const unsigned char *_image,
 // Put point cloud data to the interface
 void GazeboRosOpenniKinect::FillPointdCloud(const float *_src)
 {
+  sensor_msgs::PointCloud2Ptr pooled_msg;
+  if (this->zero_copy_)
+    pooled_msg = this->point_cloud_pool_.Allocate();
+  sensor_msgs::PointCloud2 &point_cloud_msg =
+    pooled_msg ? *pooled_msg : this->point_cloud_msg_;
+
   this->lock_.lock();
 
-  this->point_cloud_msg_.header.frame_id = this->frame_name_;
-  this->point_cloud_msg_.header.stamp.sec = this->depth_sensor_update_time_.sec;
-  this->point_cloud_msg_.header.stamp.nsec = this->depth_sensor_update_time_.nsec;
-  this->point_cloud_msg_.width = this->width;
-  this->point_cloud_msg_.height = this->height;
-  this->point_cloud_msg_.row_step = this->point_cloud_msg_.point_step * this->width;
+  point_cloud_msg.header.frame_id = this->frame_name_;
+  point_cloud_msg.header.stamp.sec = this->depth_sensor_update_time_.sec;
+  point_cloud_msg.header.stamp.nsec = this->depth_sensor_update_time_.nsec;
+  point_cloud_msg.width = this->width;
+  point_cloud_msg.height = this->height;
+  point_cloud_msg.row_step = point_cloud_msg.point_step * this->width;
 
   ///copy from depth to point cloud message
-  FillPointCloudHelper(this->point_cloud_msg_,
+  FillPointCloudHelper(point_cloud_msg,
                  this->height,
                  this->width,
                  this->skip_,
                  (void*)_src );
 
-  this->point_cloud_pub_.publish(this->point_cloud_msg_);
-
   this->lock_.unlock();
+
+  // point_cloud_msg_ is only written from the sensor thread,
+  // so serialization does not have to block the image callbacks
+  if (pooled_msg)
+    this->point_cloud_pub_.publish(sensor_msgs::PointCloud2ConstPtr(pooled_msg));
+  else
+    this->point_cloud_pub_.publish(this->point_cloud_msg_);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 // Put depth image data to the interface
 void GazeboRosOpenniKinect::FillDepthImage(const float *_src)
 {
+  sensor_msgs::ImagePtr pooled_msg;
+  if (this->zero_copy_)
+    pooled_msg = this->depth_image_pool_.Allocate();
+  sensor_msgs::Image &depth_image_msg =
+    pooled_msg ? *pooled_msg : this->depth_image_msg_;
+
   this->lock_.lock();
   // copy data into image
-  this->depth_image_msg_.header.frame_id = this->frame_name_;
-  this->depth_image_msg_.header.stamp.sec = this->depth_sensor_update_time_.sec;
-  this->depth_image_msg_.header.stamp.nsec = this->depth_sensor_update_time_.nsec;
+  depth_image_msg.header.frame_id = this->frame_name_;
+  depth_image_msg.header.stamp.sec = this->depth_sensor_update_time_.sec;
+  depth_image_msg.header.stamp.nsec = this->depth_sensor_update_time_.nsec;
 
   ///copy from depth to depth image message
-  FillDepthImageHelper(this->depth_image_msg_,
+  FillDepthImageHelper(depth_image_msg,
                  this->height,
                  this->width,
                  this->skip_,
                  (void*)_src );
 
-  this->depth_image_pub_.publish(this->depth_image_msg_);
-
   this->lock_.unlock();
+
+  if (pooled_msg)
+    this->depth_image_pub_.publish(sensor_msgs::ImageConstPtr(pooled_msg));
+  else
+    this->depth_image_pub_.publish(this->depth_image_msg_);
 }
 
 
@@ -305,10 +325,10 @@ bool GazeboRosOpenniKinect::FillPointCloudHelper(
   pcd_modifier.resize(rows_arg*cols_arg);
   point_cloud_msg.is_dense = true;
 
-  sensor_msgs::PointCloud2Iterator<float> iter_x(point_cloud_msg_, "x");
-  sensor_msgs::PointCloud2Iterator<float> iter_y(point_cloud_msg_, "y");
-  sensor_msgs::PointCloud2Iterator<float> iter_z(point_cloud_msg_, "z");
-  sensor_msgs::PointCloud2Iterator<uint8_t> iter_rgb(point_cloud_msg_, "rgb");
+  sensor_msgs::PointCloud2Iterator<float> iter_x(point_cloud_msg, "x");
+  sensor_msgs::PointCloud2Iterator<float> iter_y(point_cloud_msg, "y");
+  sensor_msgs::PointCloud2Iterator<float> iter_z(point_cloud_msg, "z");
+  sensor_msgs::PointCloud2Iterator<uint8_t> iter_rgb(point_cloud_msg, "rgb");
 
   float* toCopyFrom = (float*)data_arg;
   int index = 0;
@@ -348,15 +368,16 @@ bool GazeboRosOpenniKinect::FillPointCloudHelper(
       }
 
       // put image color data for each point
-      uint8_t*  image_src = (uint8_t*)(&(this->image_msg_.data[0]));
-      if (this->image_msg_.data.size() == rows_arg*cols_arg*3)
+      const sensor_msgs::Image& image = this->GetLatestImage();
+      uint8_t*  image_src = (uint8_t*)(&(image.data[0]));
+      if (image.data.size() == rows_arg*cols_arg*3)
       {
         // color
         iter_rgb[0] = image_src[i*3+j*cols_arg*3+0];
         iter_rgb[1] = image_src[i*3+j*cols_arg*3+1];
         iter_rgb[2] = image_src[i*3+j*cols_arg*3+2];
       }
-      else if (this->image_msg_.data.size() == rows_arg*cols_arg)
+      else if (image.data.size() == rows_arg*cols_arg)
       {
         // mono (or bayer?  @todo; fix for bayer)
         iter_rgb[0] = image_src[i+j*cols_arg];
@@ -35,7 +35,11 @@ GazeboRosApiPlugin::GazeboRosApiPlugin() :
   plugin_loaded_(false),
   pub_link_states_connection_count_(0),
   pub_joint_states_connection_count_(0),
-  pub_model_states_connection_count_(0)
+  pub_model_states_connection_count_(0),
+  write_joint_blocks_(false),
+  joint_block_write_period_(0.001),
+  last_joint_block_write_time_(-1.0),
+  lock_step_timeout_(1.0)
 {
   robot_namespace_.clear();
 }
@@ -62,6 +66,9 @@ GazeboRosApiPlugin::~GazeboRosApiPlugin()
   gazebo::event::Events::DisconnectWorldUpdateBegin(wrench_update_event_);
   gazebo::event::Events::DisconnectWorldUpdateBegin(force_update_event_);
   gazebo::event::Events::DisconnectWorldUpdateBegin(time_update_event_);
+  gazebo::event::Events::DisconnectWorldUpdateEnd(joint_block_update_event_);
+  if (lock_step_)
+    gazebo::event::Events::DisconnectWorldUpdateBegin(lock_step_event_);
   ROS_DEBUG_STREAM_NAMED("api_plugin","Slots disconnected");
 
   if (pub_link_states_connection_count_ > 0) // disconnect if there are subscribers on exit
@@ -204,6 +211,7 @@ void GazeboRosApiPlugin::loadGazeboRosApiPlugin(std::string world_name)
   wrench_update_event_ = gazebo::event::Events::ConnectWorldUpdateBegin(boost::bind(&GazeboRosApiPlugin::wrenchBodySchedulerSlot,this));
   force_update_event_  = gazebo::event::Events::ConnectWorldUpdateBegin(boost::bind(&GazeboRosApiPlugin::forceJointSchedulerSlot,this));
   time_update_event_   = gazebo::event::Events::ConnectWorldUpdateBegin(boost::bind(&GazeboRosApiPlugin::publishSimTime,this));
+  joint_block_update_event_ = gazebo::event::Events::ConnectWorldUpdateEnd(boost::bind(&GazeboRosApiPlugin::jointBlockUpdateEnd,this));
 }
 
 void GazeboRosApiPlugin::onResponse(ConstResponsePtr &response)
@@ -509,6 +517,7 @@ void GazeboRosApiPlugin::advertiseServices()
 
   server_start_timer_ = nh_->advertiseService("start_timer", &GazeboRosApiPlugin::startTimerServiceCB, this);
   server_add_joint_   = nh_->advertiseService("add_joint", &GazeboRosApiPlugin::addJointServiceCB, this);
+  server_add_joint_block_ = nh_->advertiseService("add_joint_block", &GazeboRosApiPlugin::addJointBlockServiceCB, this);
   //server_add_link_    = nh_->advertiseService("add_link", &GazeboRosApiPlugin::addLinkServiceCB, this);
   timer_read_joint_efforts_ = nh_->createTimer(ros::Duration(0.001), &GazeboRosApiPlugin::readJointEffortsTimerCB, this, false, false);
   timer_write_joint_states_ = nh_->createTimer(ros::Duration(0.001), &GazeboRosApiPlugin::writeJointStatesTimerCB, this, false, false);
@@ -2472,6 +2481,30 @@ bool GazeboRosApiPlugin::spawnAndConform(TiXmlDocument &gazebo_model_xml, std::s
 bool GazeboRosApiPlugin::startTimerServiceCB(gazebo_msgs::StartTimer::Request& req,
                                              gazebo_msgs::StartTimer::Response& res)
 {
+  // joints are exchanged every physics step in lock-step mode
+  if(lock_step_)
+  {
+    return true;
+  }
+
+  if(req.lock_step)
+  {
+    if(req.lock_step_timeout > 0.0)
+      lock_step_timeout_ = req.lock_step_timeout;
+
+    timer_read_joint_efforts_.stop();
+    timer_write_joint_states_.stop();
+    {
+      boost::mutex::scoped_lock lock(lock_);
+      write_joint_blocks_ = false;
+    }
+
+    lock_step_ = ahl_utils::LockStep::Ptr(new ahl_utils::LockStep("ahl_lock_step", true));
+    lock_step_event_ = gazebo::event::Events::ConnectWorldUpdateBegin(boost::bind(&GazeboRosApiPlugin::lockStepUpdate, this));
+    ROS_INFO_STREAM("Started lock-step co-simulation, timeout : " << lock_step_timeout_ << " [s]");
+    return true;
+  }
+
   if(req.duration_read_joint_efforts <= 0.0)
   {
     timer_read_joint_efforts_.setPeriod(ros::Duration(0.001));
@@ -2489,6 +2522,13 @@ bool GazeboRosApiPlugin::startTimerServiceCB(gazebo_msgs::StartTimer::Request& r
   {
     timer_write_joint_states_.setPeriod(ros::Duration(req.duration_write_joint_states));
   }
+
+  {
+    boost::mutex::scoped_lock lock(lock_);
+    joint_block_write_period_ = (req.duration_write_joint_states <= 0.0) ? 0.001 : req.duration_write_joint_states;
+    last_joint_block_write_time_ = -1.0;
+    write_joint_blocks_ = true;
+  }
 /*
   if(req.duration_update_link_states <= 0.0)
   {
@@ -2508,6 +2548,7 @@ bool GazeboRosApiPlugin::startTimerServiceCB(gazebo_msgs::StartTimer::Request& r
 bool GazeboRosApiPlugin::addJointServiceCB(gazebo_msgs::AddJoint::Request& req,
                                            gazebo_msgs::AddJoint::Response& res)
 {
+  boost::mutex::scoped_lock lock(lock_);
   if(joint_effort_.find(req.name) == joint_effort_.end())
   {
     std::cout << "Added joint : " << req.name << std::endl;
@@ -2540,6 +2581,68 @@ bool GazeboRosApiPlugin::addJointServiceCB(gazebo_msgs::AddJoint::Request& req,
 
   return true;
 }
+bool GazeboRosApiPlugin::addJointBlockServiceCB(gazebo_msgs::AddJointBlock::Request& req,
+                                                gazebo_msgs::AddJointBlock::Response& res)
+{
+  JointBlockEntry entry;
+  entry.effort_time = ros::Duration(req.effort_time);
+  entry.q.resize(req.joints.size(), 0.0);
+  entry.dq.resize(req.joints.size(), 0.0);
+  entry.tau.resize(req.joints.size(), 0.0);
+  entry.tau_applied.resize(req.joints.size(), 0.0);
+
+  for(unsigned int i = 0; i < req.joints.size(); ++i)
+  {
+    gazebo::physics::JointPtr joint;
+    for(unsigned int j = 0; j < world_->GetModelCount() && !joint; ++j)
+    {
+      joint = world_->GetModel(j)->GetJoint(req.joints[i]);
+    }
+
+    if(!joint)
+    {
+      std::stringstream msg;
+      msg << "src : GazeboRosApiPlugin::addJointBlockServiceCB" << std::endl
+          << "msg : Could not find joint : " << req.joints[i] << std::endl;
+      ROS_ERROR_STREAM(msg.str());
+      res.success = false;
+      res.status_message = msg.str();
+      return true;
+    }
+
+    entry.joints.push_back(joint);
+  }
+
+  // a controller registering again gets a fresh segment
+  entry.block = ahl_utils::JointBlock::Ptr(new ahl_utils::JointBlock(req.name, req.joints.size(), true));
+
+  boost::mutex::scoped_lock lock(lock_);
+  joint_blocks_[req.name] = entry;
+  std::cout << "Added joint block : " << req.name << " (" << req.joints.size() << " joints)" << std::endl;
+
+  res.success = true;
+  return true;
+}
+
+void GazeboRosApiPlugin::writeJointBlockStates()
+{
+  double time = world_->GetSimTime().Double();
+
+  std::map<std::string, JointBlockEntry>::iterator it;
+  for(it = joint_blocks_.begin(); it != joint_blocks_.end(); ++it)
+  {
+    JointBlockEntry& entry = it->second;
+    for(unsigned int i = 0; i < entry.joints.size(); ++i)
+    {
+      entry.q[i]  = entry.joints[i]->GetAngle(0).Radian();
+      entry.dq[i] = entry.joints[i]->GetVelocity(0);
+      entry.tau_applied[i] = entry.joints[i]->GetForce(0u);
+    }
+
+    if(!entry.joints.empty())
+      entry.block->writeStates(&entry.q[0], &entry.dq[0], &entry.tau_applied[0], time);
+  }
+}
 /*
 bool GazeboRosApiPlugin::addLinkServiceCB(gazebo_msgs::AddLink::Request& req,
                                           gazebo_msgs::AddLink::Response& res)
@@ -2598,6 +2701,26 @@ void GazeboRosApiPlugin::readJointEffortsTimerCB(const ros::TimerEvent& e)
     fjj->duration = effort_time_[it->first];
     force_joint_jobs_.push_back(fjj);
   }
+
+  std::map<std::string, JointBlockEntry>::iterator block;
+  for(block = joint_blocks_.begin(); block != joint_blocks_.end(); ++block)
+  {
+    JointBlockEntry& entry = block->second;
+    if(entry.joints.empty())
+      continue;
+
+    entry.block->readEfforts(&entry.tau[0]);
+
+    for(unsigned int i = 0; i < entry.joints.size(); ++i)
+    {
+      GazeboRosApiPlugin::ForceJointJob* fjj = new GazeboRosApiPlugin::ForceJointJob;
+      fjj->joint = entry.joints[i];
+      fjj->force = entry.tau[i];
+      fjj->start_time = ros::Time(world_->GetSimTime().Double());
+      fjj->duration = entry.effort_time;
+      force_joint_jobs_.push_back(fjj);
+    }
+  }
 }
 
 void GazeboRosApiPlugin::writeJointStatesTimerCB(const ros::TimerEvent& e)
@@ -2612,6 +2735,76 @@ void GazeboRosApiPlugin::writeJointStatesTimerCB(const ros::TimerEvent& e)
     it->second->write(state);
   }
 }
+
+void GazeboRosApiPlugin::jointBlockUpdateEnd()
+{
+  boost::mutex::scoped_lock lock(lock_);
+
+  // lock-step mode writes the blocks itself
+  if(!write_joint_blocks_)
+    return;
+
+  // the period is kept in simulation time, with some slack for rounding of the
+  // step size. A time before the last write means the world has been reset.
+  double time = world_->GetSimTime().Double();
+  if(last_joint_block_write_time_ >= 0.0 && time >= last_joint_block_write_time_ &&
+     time - last_joint_block_write_time_ < 0.999 * joint_block_write_period_)
+    return;
+
+  last_joint_block_write_time_ = time;
+  writeJointBlockStates();
+}
+void GazeboRosApiPlugin::lockStepUpdate()
+{
+  std::map<std::string, ahl_utils::SharedMemory<double>::Ptr>::iterator it;
+
+  {
+    boost::mutex::scoped_lock lock(lock_);
+    for(it = joint_states_.begin(); it != joint_states_.end(); ++it)
+    {
+      if(!joint_[it->first]) continue;
+      double state = joint_[it->first]->GetAngle(0).Radian();
+      it->second->write(state);
+    }
+
+    writeJointBlockStates();
+  }
+
+  // hand the step over to the controller and block physics until it answers
+  if(lock_step_->isAttached())
+  {
+    lock_step_->notifyStates(world_->GetSimTime().Double());
+    if(!lock_step_->waitEfforts(lock_step_timeout_))
+    {
+      ROS_WARN_STREAM("Controller did not answer within " << lock_step_timeout_ << " [s], running without it.");
+      lock_step_->detach();
+    }
+  }
+
+  // efforts only act on this step
+  boost::mutex::scoped_lock lock(lock_);
+  for(it = joint_effort_.begin(); it != joint_effort_.end(); ++it)
+  {
+    if(!joint_[it->first]) continue;
+    double effort = 0.0;
+    it->second->read(effort);
+    joint_[it->first]->SetForce(0, effort);
+  }
+
+  std::map<std::string, JointBlockEntry>::iterator block;
+  for(block = joint_blocks_.begin(); block != joint_blocks_.end(); ++block)
+  {
+    JointBlockEntry& entry = block->second;
+    if(entry.joints.empty())
+      continue;
+
+    entry.block->readEfforts(&entry.tau[0]);
+    for(unsigned int i = 0; i < entry.joints.size(); ++i)
+    {
+      entry.joints[i]->SetForce(0, entry.tau[i]);
+    }
+  }
+}
 /*
 void GazeboRosApiPlugin::updateLinkStatesTimerCB(const ros::TimerEvent& e)
 {
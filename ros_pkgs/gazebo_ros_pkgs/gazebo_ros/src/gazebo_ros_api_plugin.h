@@ -98,12 +98,15 @@
 #include "gazebo_msgs/SetPhysicsProperties.h"
 #include "gazebo_msgs/GetPhysicsProperties.h"
 #include "gazebo_msgs/AddJoint.h"
+#include "gazebo_msgs/AddJointBlock.h"
 #include "gazebo_msgs/AddLink.h"
 #include "gazebo_msgs/StartTimer.h"
 
 #include <boost/algorithm/string.hpp>
 
 #include <ahl_utils/shared_memory.hpp>
+#include <ahl_utils/lock_step.hpp>
+#include <ahl_utils/joint_block.hpp>
 
 namespace gazebo
 {
@@ -430,6 +433,10 @@ private:
   bool addJointServiceCB(gazebo_msgs::AddJoint::Request& req,
                          gazebo_msgs::AddJoint::Response& res);
 
+  ros::ServiceServer server_add_joint_block_;
+  bool addJointBlockServiceCB(gazebo_msgs::AddJointBlock::Request& req,
+                              gazebo_msgs::AddJointBlock::Response& res);
+
   //ros::ServiceServer server_add_link_;
   //bool addLinkServiceCB(gazebo_msgs::AddLink::Request& req,
   //                      gazebo_msgs::AddLink::Response& res);
@@ -444,11 +451,40 @@ private:
   //std::map<std::string, gazebo::physics::LinkPtr> link_;
   //std::map<std::string, gazebo::physics::LinkPtr> link_frame_;
   //std::map<std::string, geometry_msgs::Pose> link_pose_;
+  // Joints registered as a block, exchanged with a single shared memory segment
+  struct JointBlockEntry
+  {
+    ahl_utils::JointBlock::Ptr block;
+    std::vector<gazebo::physics::JointPtr> joints;
+    ros::Duration effort_time;
+    std::vector<double> q;
+    std::vector<double> dq;
+    std::vector<double> tau;
+    std::vector<double> tau_applied;
+  };
+  std::map<std::string, JointBlockEntry> joint_blocks_;
+  void writeJointBlockStates();
+
+  // Timer mode : blocks are written at the end of a physics step instead of
+  // from the ROS timer, so q, dq and the time stamp belong to the same step
+  gazebo::event::ConnectionPtr joint_block_update_event_;
+  bool write_joint_blocks_;
+  double joint_block_write_period_;
+  double last_joint_block_write_time_;
+  void jointBlockUpdateEnd();
+
   ros::Timer timer_read_joint_efforts_;
   ros::Timer timer_write_joint_states_;
   //ros::Timer timer_update_link_states_;
   void readJointEffortsTimerCB(const ros::TimerEvent& e);
   void writeJointStatesTimerCB(const ros::TimerEvent& e);
+
+  // Lock-step mode : states are written and efforts applied every physics
+  // step, waiting for the controller in between
+  ahl_utils::LockStep::Ptr lock_step_;
+  gazebo::event::ConnectionPtr lock_step_event_;
+  double lock_step_timeout_;
+  void lockStepUpdate();
   //void updateLinkStatesTimerCB(const ros::TimerEvent& e);
 };
 }
@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) 2013, Willow Garage, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Willow Garage, Inc. nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ *      Author: Julius Kammerl (jkammerl@willowgarage.com)
+ */
+
+#ifndef OPENNI2_DEPTH_CONVERSION_H_
+#define OPENNI2_DEPTH_CONVERSION_H_
+
+#include <cstddef>
+#include <boost/cstdint.hpp>
+
+namespace openni2_wrapper
+{
+
+/** \brief Applies the z offset [mm] and z scaling to a raw depth frame in place
+ *         and, if depth is not NULL, writes it out in meters.
+ *
+ * Zero pixels are left untouched by offset and scaling. Pixels which are 0 or
+ * 0x7FF afterwards are written as NaN. Both steps are done in a single pass,
+ * eight pixels at a time where SSE2 is available.
+ */
+void convertDepthFrame(uint16_t* raw, float* depth, std::size_t size,
+                       int z_offset_mm, double z_scaling);
+
+/** \brief Pixel by pixel version of convertDepthFrame, used as a reference */
+void convertDepthFrameScalar(uint16_t* raw, float* depth, std::size_t size,
+                             int z_offset_mm, double z_scaling);
+
+}
+
+#endif
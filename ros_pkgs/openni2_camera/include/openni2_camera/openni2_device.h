@@ -52,6 +52,7 @@ class Device;
 class DeviceInfo;
 class VideoStream;
 class SensorInfo;
+class Recorder;
 }
 
 namespace openni2_wrapper
@@ -131,6 +132,17 @@ public:
 
   void setUseDeviceTimer(bool enable);
 
+  // Playback of a recorded .oni file, opened by passing its path as device URI
+  bool isFile() const;
+  // speed as ratio of the recorded frame rate, 0 plays back as fast as possible
+  void setPlaybackSpeed(float speed) throw (OpenNI2Exception);
+  void setPlaybackRepeat(bool enable) throw (OpenNI2Exception);
+
+  // Records all started streams to an .oni file until stopRecording is called
+  void startRecording(const std::string& file_name, bool allow_lossy_compression = false) throw (OpenNI2Exception);
+  void stopRecording();
+  bool isRecording() const;
+
 protected:
   void shutdown();
 
@@ -149,6 +161,8 @@ protected:
   mutable boost::shared_ptr<openni::VideoStream> color_video_stream_;
   mutable boost::shared_ptr<openni::VideoStream> depth_video_stream_;
 
+  boost::shared_ptr<openni::Recorder> recorder_;
+
   mutable std::vector<OpenNI2VideoMode> ir_video_modes_;
   mutable std::vector<OpenNI2VideoMode> color_video_modes_;
   mutable std::vector<OpenNI2VideoMode> depth_video_modes_;
@@ -95,7 +95,7 @@ private:
   void genVideoModeTableMap();
   int lookupVideoModeFromDynConfig(int mode_nr, OpenNI2VideoMode& video_mode);
 
-  sensor_msgs::ImageConstPtr rawToFloatingPointConversion(sensor_msgs::ImageConstPtr raw_image);
+  sensor_msgs::ImagePtr allocateFloatingPointImage(const sensor_msgs::Image& raw_image);
 
   void setIRVideoMode(const OpenNI2VideoMode& ir_video_mode);
   void setColorVideoMode(const OpenNI2VideoMode& color_video_mode);
@@ -134,6 +134,9 @@ private:
 
   std::string color_info_url_, ir_info_url_;
 
+  double playback_speed_;
+  bool playback_repeat_;
+
   bool color_depth_synchronization_;
   bool depth_registration_;
 
@@ -145,6 +148,10 @@ private:
   int z_offset_mm_;
   double z_scaling_;
 
+  // floating point depth images, reused once published
+  static const std::size_t DEPTH_IMAGE_POOL_SIZE = 4;
+  std::vector<sensor_msgs::ImagePtr> depth_image_pool_;
+
   ros::Duration ir_time_offset_;
   ros::Duration color_time_offset_;
   ros::Duration depth_time_offset_;
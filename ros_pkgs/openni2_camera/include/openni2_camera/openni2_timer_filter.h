@@ -32,13 +32,21 @@
 #ifndef OPENNI2_TIME_FILTER_H_
 #define OPENNI2_TIME_FILTER_H_
 
-#include <deque>
+#include <cstddef>
+#include <vector>
 
 #include "OpenNI.h"
 
 namespace openni2_wrapper
 {
 
+/** \brief Median and moving average over the last filter_len samples.
+ *
+ * Samples are kept in a ring buffer and split into a max heap holding the
+ * lower half and a min heap holding the upper half of the window, so adding
+ * a sample takes O(log n) and getMedian O(1). No memory is allocated after
+ * construction.
+ */
 class OpenNI2TimerFilter
 {
 public:
@@ -53,9 +61,38 @@ public:
   void clear();
 
 private:
+  // heap of ring buffer slots, ordered by their samples
+  struct Heap
+  {
+    std::vector<std::size_t> slots_;
+    std::size_t size_;
+    bool max_;
+  };
+
+  bool before(const Heap& heap, std::size_t a, std::size_t b) const;
+  void place(Heap& heap, std::size_t pos, std::size_t slot);
+  void siftUp(Heap& heap, std::size_t pos);
+  void siftDown(Heap& heap, std::size_t pos);
+  void push(Heap& heap, std::size_t slot);
+  std::size_t pop(Heap& heap);
+  void swapTops();
+
   std::size_t filter_len_;
 
-  std::deque<double> buffer_;
+  // ring buffer of samples
+  std::vector<double> buffer_;
+  std::size_t oldest_;
+  std::size_t size_;
+  double sum_;
+
+  // lower half of the window, holds size_/2 samples
+  Heap lower_;
+  // upper half of the window, its minimum is the median
+  Heap upper_;
+
+  // heap and position within that heap of each ring buffer slot
+  std::vector<bool> in_upper_;
+  std::vector<std::size_t> heap_pos_;
 };
 
 }
@@ -0,0 +1,171 @@
+/*
+ * Copyright (c) 2013, Willow Garage, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Willow Garage, Inc. nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ *      Author: Julius Kammerl (jkammerl@willowgarage.com)
+ */
+
+#include "openni2_camera/openni2_depth_conversion.h"
+
+#include <cmath>
+#include <limits>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace openni2_wrapper
+{
+
+namespace
+{
+
+inline bool hasScaling(double z_scaling)
+{
+  return std::fabs(z_scaling - 1.0) > 1e-6;
+}
+
+inline void convertPixels(uint16_t* raw, float* depth, std::size_t begin, std::size_t end,
+                          int z_offset_mm, double z_scaling)
+{
+  static const float bad_point = std::numeric_limits<float>::quiet_NaN();
+
+  const bool offset = (z_offset_mm != 0);
+  const bool scaling = hasScaling(z_scaling);
+
+  for (std::size_t i = begin; i < end; ++i)
+  {
+    uint16_t value = raw[i];
+
+    if (offset && value != 0)
+      value = static_cast<uint16_t>(value + z_offset_mm);
+    if (scaling && value != 0)
+      value = static_cast<uint16_t>(static_cast<int>(value * z_scaling));
+
+    raw[i] = value;
+
+    if (depth)
+    {
+      if (value == 0 || value == 0x7FF)
+        depth[i] = bad_point;
+      else
+        depth[i] = static_cast<float>(value) / 1000.0f;
+    }
+  }
+}
+
+#ifdef __SSE2__
+// Scales four 32 bit integers in double precision, so that the result is
+// truncated exactly as in the scalar path.
+inline __m128i scale4(__m128i value, __m128d scale)
+{
+  __m128d lo = _mm_mul_pd(_mm_cvtepi32_pd(value), scale);
+  __m128d hi = _mm_mul_pd(_mm_cvtepi32_pd(_mm_unpackhi_epi64(value, value)), scale);
+  return _mm_unpacklo_epi64(_mm_cvttpd_epi32(lo), _mm_cvttpd_epi32(hi));
+}
+
+// Packs the low 16 bits of eight 32 bit integers, wrapping like a uint16_t cast.
+inline __m128i pack16(__m128i lo, __m128i hi)
+{
+  lo = _mm_srai_epi32(_mm_slli_epi32(lo, 16), 16);
+  hi = _mm_srai_epi32(_mm_slli_epi32(hi, 16), 16);
+  return _mm_packs_epi32(lo, hi);
+}
+
+inline void storeDepth4(float* depth, __m128i value, __m128i invalid,
+                        __m128 millimeter, __m128 bad_point)
+{
+  __m128 meter = _mm_div_ps(_mm_cvtepi32_ps(value), millimeter);
+  __m128 mask = _mm_castsi128_ps(invalid);
+  _mm_storeu_ps(depth, _mm_or_ps(_mm_and_ps(mask, bad_point), _mm_andnot_ps(mask, meter)));
+}
+#endif
+
+}
+
+void convertDepthFrameScalar(uint16_t* raw, float* depth, std::size_t size,
+                             int z_offset_mm, double z_scaling)
+{
+  convertPixels(raw, depth, 0, size, z_offset_mm, z_scaling);
+}
+
+void convertDepthFrame(uint16_t* raw, float* depth, std::size_t size,
+                       int z_offset_mm, double z_scaling)
+{
+  std::size_t i = 0;
+
+#ifdef __SSE2__
+  const bool offset = (z_offset_mm != 0);
+  const bool scaling = hasScaling(z_scaling);
+
+  // nothing to do for the raw frame only
+  if (!depth && !offset && !scaling)
+    return;
+
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i offset16 = _mm_set1_epi16(static_cast<short>(z_offset_mm));
+  const __m128i invalid16 = _mm_set1_epi16(0x7FF);
+  const __m128d scale = _mm_set1_pd(z_scaling);
+  const __m128 millimeter = _mm_set1_ps(1000.0f);
+  const __m128 bad_point = _mm_set1_ps(std::numeric_limits<float>::quiet_NaN());
+
+  for (; i + 8 <= size; i += 8)
+  {
+    __m128i value = _mm_loadu_si128(reinterpret_cast<const __m128i*>(raw + i));
+
+    // zero pixels stay zero, and zero times the scale is zero as well
+    if (offset)
+      value = _mm_andnot_si128(_mm_cmpeq_epi16(value, zero), _mm_add_epi16(value, offset16));
+
+    __m128i lo = _mm_unpacklo_epi16(value, zero);
+    __m128i hi = _mm_unpackhi_epi16(value, zero);
+
+    if (scaling)
+    {
+      lo = scale4(lo, scale);
+      hi = scale4(hi, scale);
+      value = pack16(lo, hi);
+      lo = _mm_unpacklo_epi16(value, zero);
+      hi = _mm_unpackhi_epi16(value, zero);
+    }
+
+    if (offset || scaling)
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(raw + i), value);
+
+    if (depth)
+    {
+      __m128i invalid = _mm_or_si128(_mm_cmpeq_epi16(value, zero), _mm_cmpeq_epi16(value, invalid16));
+      storeDepth4(depth + i, lo, _mm_unpacklo_epi16(invalid, invalid), millimeter, bad_point);
+      storeDepth4(depth + i + 4, hi, _mm_unpackhi_epi16(invalid, invalid), millimeter, bad_point);
+    }
+  }
+#endif
+
+  convertPixels(raw, depth, i, size, z_offset_mm, z_scaling);
+}
+
+}
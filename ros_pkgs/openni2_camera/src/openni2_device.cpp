@@ -84,6 +84,8 @@ OpenNI2Device::OpenNI2Device(const std::string& device_URI) throw (OpenNI2Except
 
 OpenNI2Device::~OpenNI2Device()
 {
+  stopRecording();
+
   stopAllStreams();
 
   shutdown();
@@ -596,6 +598,79 @@ void OpenNI2Device::setUseDeviceTimer(bool enable)
     depth_frame_listener->setUseDeviceTimer(enable);
 }
 
+bool OpenNI2Device::isFile() const
+{
+  return openni_device_->isFile();
+}
+
+void OpenNI2Device::setPlaybackSpeed(float speed) throw (OpenNI2Exception)
+{
+  openni::PlaybackControl* playback_control = openni_device_->getPlaybackControl();
+
+  if (playback_control)
+  {
+    const openni::Status rc = playback_control->setSpeed(speed > 0.0f ? speed : 0.0f);
+    if (rc != openni::STATUS_OK)
+      THROW_OPENNI_EXCEPTION("Couldn't set playback speed: \n%s\n", openni::OpenNI::getExtendedError());
+  }
+}
+
+void OpenNI2Device::setPlaybackRepeat(bool enable) throw (OpenNI2Exception)
+{
+  openni::PlaybackControl* playback_control = openni_device_->getPlaybackControl();
+
+  if (playback_control)
+  {
+    const openni::Status rc = playback_control->setRepeatEnabled(enable);
+    if (rc != openni::STATUS_OK)
+      THROW_OPENNI_EXCEPTION("Couldn't set playback repeat: \n%s\n", openni::OpenNI::getExtendedError());
+  }
+}
+
+void OpenNI2Device::startRecording(const std::string& file_name, bool allow_lossy_compression) throw (OpenNI2Exception)
+{
+  stopRecording();
+
+  recorder_ = boost::make_shared<openni::Recorder>();
+
+  openni::Status rc = recorder_->create(file_name.c_str());
+  if (rc != openni::STATUS_OK)
+  {
+    recorder_.reset();
+    THROW_OPENNI_EXCEPTION("Couldn't create recorder: \n%s\n", openni::OpenNI::getExtendedError());
+  }
+
+  if (ir_video_started_)
+    recorder_->attach(*ir_video_stream_, allow_lossy_compression);
+  if (color_video_started_)
+    recorder_->attach(*color_video_stream_, allow_lossy_compression);
+  if (depth_video_started_)
+    recorder_->attach(*depth_video_stream_, allow_lossy_compression);
+
+  rc = recorder_->start();
+  if (rc != openni::STATUS_OK)
+  {
+    recorder_->destroy();
+    recorder_.reset();
+    THROW_OPENNI_EXCEPTION("Couldn't start recording: \n%s\n", openni::OpenNI::getExtendedError());
+  }
+}
+
+void OpenNI2Device::stopRecording()
+{
+  if (recorder_.get() != 0)
+  {
+    recorder_->stop();
+    recorder_->destroy();
+    recorder_.reset();
+  }
+}
+
+bool OpenNI2Device::isRecording() const
+{
+  return recorder_.get() != 0;
+}
+
 void OpenNI2Device::setIRFrameCallback(FrameCallbackFunction callback)
 {
   ir_frame_listener->setCallback(callback);
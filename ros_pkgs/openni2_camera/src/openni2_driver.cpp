@@ -31,6 +31,7 @@
 
 #include "openni2_camera/openni2_driver.h"
 #include "openni2_camera/openni2_exception.h"
+#include "openni2_camera/openni2_depth_conversion.h"
 
 #include <sensor_msgs/image_encodings.h>
 #include <sensor_msgs/distortion_models.h>
@@ -430,20 +431,17 @@ void OpenNI2Driver::newDepthFrameCallback(sensor_msgs::ImagePtr image)
     {
       image->header.stamp = image->header.stamp + depth_time_offset_;
 
-      if (z_offset_mm_ != 0)
-      {
-        uint16_t* data = reinterpret_cast<uint16_t*>(&image->data[0]);
-        for (unsigned int i = 0; i < image->width * image->height; ++i)
-          if (data[i] != 0)
-                data[i] += z_offset_mm_;
-      }
+      sensor_msgs::ImagePtr floating_point_image;
+      if (depth_subscribers_)
+        floating_point_image = allocateFloatingPointImage(*image);
 
-      if (fabs(z_scaling_ - 1.0) > 1e-6)
+      // offset, scaling and conversion to meters in a single pass
+      std::size_t data_size = image->width * image->height;
+      if (data_size > 0)
       {
-        uint16_t* data = reinterpret_cast<uint16_t*>(&image->data[0]);
-        for (unsigned int i = 0; i < image->width * image->height; ++i)
-          if (data[i] != 0)
-                data[i] = static_cast<uint16_t>(data[i] * z_scaling_);
+        convertDepthFrame(reinterpret_cast<uint16_t*>(&image->data[0]),
+                          floating_point_image ? reinterpret_cast<float*>(&floating_point_image->data[0]) : NULL,
+                          data_size, z_offset_mm_, z_scaling_);
       }
 
       sensor_msgs::CameraInfoPtr cam_info;
@@ -458,14 +456,16 @@ void OpenNI2Driver::newDepthFrameCallback(sensor_msgs::ImagePtr image)
         cam_info = getDepthCameraInfo(image->width,image->height, image->header.stamp);
       }
 
+      if (floating_point_image)
+        floating_point_image->header.frame_id = image->header.frame_id;
+
       if (depth_raw_subscribers_)
       {
         pub_depth_raw_.publish(image, cam_info);
       }
 
-      if (depth_subscribers_ )
+      if (floating_point_image)
       {
-        sensor_msgs::ImageConstPtr floating_point_image = rawToFloatingPointConversion(image);
         pub_depth_.publish(floating_point_image, cam_info);
       }
     }
@@ -601,6 +601,10 @@ void OpenNI2Driver::readConfigFromParameterServer()
   pnh_.param("rgb_camera_info_url", color_info_url_, std::string());
   pnh_.param("depth_camera_info_url", ir_info_url_, std::string());
 
+  // Playback of recorded .oni files given as device_id
+  pnh_.param("playback_speed", playback_speed_, 1.0);
+  pnh_.param("playback_repeat", playback_repeat_, true);
+
 }
 
 std::string OpenNI2Driver::resolveDeviceURI(const std::string& device_id) throw(OpenNI2Exception)
@@ -720,6 +724,23 @@ void OpenNI2Driver::initDevice()
     boost::this_thread::sleep(boost::posix_time::seconds(0.1));
   }
 
+  if (device_->isFile())
+  {
+    try
+    {
+      device_->setPlaybackSpeed(playback_speed_);
+      device_->setPlaybackRepeat(playback_repeat_);
+    }
+    catch (const OpenNI2Exception& exception)
+    {
+      ROS_ERROR("Could not configure playback. Reason: %s", exception.what());
+    }
+    if (playback_speed_ > 0.0)
+      ROS_INFO("Playing back %s at %.2fx recorded speed", device_id_.c_str(), playback_speed_);
+    else
+      ROS_INFO("Playing back %s as fast as possible", device_id_.c_str());
+  }
+
 }
 
 void OpenNI2Driver::genVideoModeTableMap()
@@ -848,36 +869,35 @@ int OpenNI2Driver::lookupVideoModeFromDynConfig(int mode_nr, OpenNI2VideoMode& v
   return ret;
 }
 
-sensor_msgs::ImageConstPtr OpenNI2Driver::rawToFloatingPointConversion(sensor_msgs::ImageConstPtr raw_image)
+sensor_msgs::ImagePtr OpenNI2Driver::allocateFloatingPointImage(const sensor_msgs::Image& raw_image)
 {
-  static const float bad_point = std::numeric_limits<float>::quiet_NaN ();
+  sensor_msgs::ImagePtr new_image;
 
-  sensor_msgs::ImagePtr new_image = boost::make_shared<sensor_msgs::Image>();
-
-  new_image->header = raw_image->header;
-  new_image->width = raw_image->width;
-  new_image->height = raw_image->height;
-  new_image->is_bigendian = 0;
-  new_image->encoding = sensor_msgs::image_encodings::TYPE_32FC1;
-  new_image->step = sizeof(float)*raw_image->width;
-
-  std::size_t data_size = new_image->width*new_image->height;
-  new_image->data.resize(data_size*sizeof(float));
-
-  const unsigned short* in_ptr = reinterpret_cast<const unsigned short*>(&raw_image->data[0]);
-  float* out_ptr = reinterpret_cast<float*>(&new_image->data[0]);
-
-  for (std::size_t i = 0; i<data_size; ++i, ++in_ptr, ++out_ptr)
+  // reuse an image no subscriber holds on to any more, its buffer is already allocated
+  for (std::size_t i = 0; i < depth_image_pool_.size(); ++i)
   {
-    if (*in_ptr==0 || *in_ptr==0x7FF)
-    {
-      *out_ptr = bad_point;
-    } else
+    if (depth_image_pool_[i].unique())
     {
-      *out_ptr = static_cast<float>(*in_ptr)/1000.0f;
+      new_image = depth_image_pool_[i];
+      break;
     }
   }
 
+  if (!new_image)
+  {
+    new_image = boost::make_shared<sensor_msgs::Image>();
+    if (depth_image_pool_.size() < DEPTH_IMAGE_POOL_SIZE)
+      depth_image_pool_.push_back(new_image);
+  }
+
+  new_image->header = raw_image.header;
+  new_image->width = raw_image.width;
+  new_image->height = raw_image.height;
+  new_image->is_bigendian = 0;
+  new_image->encoding = sensor_msgs::image_encodings::TYPE_32FC1;
+  new_image->step = sizeof(float)*raw_image.width;
+  new_image->data.resize(raw_image.width*raw_image.height*sizeof(float));
+
   return new_image;
 }
 
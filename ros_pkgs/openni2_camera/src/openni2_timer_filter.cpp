@@ -37,8 +37,17 @@ namespace openni2_wrapper
 {
 
 OpenNI2TimerFilter::OpenNI2TimerFilter(std::size_t filter_len):
-    filter_len_(filter_len)
+    filter_len_(filter_len),
+    buffer_(filter_len),
+    in_upper_(filter_len),
+    heap_pos_(filter_len)
 {
+  lower_.slots_.resize(filter_len);
+  lower_.max_ = true;
+  upper_.slots_.resize(filter_len);
+  upper_.max_ = false;
+
+  clear();
 }
 
 OpenNI2TimerFilter::~OpenNI2TimerFilter()
@@ -47,47 +56,145 @@ OpenNI2TimerFilter::~OpenNI2TimerFilter()
 
 void OpenNI2TimerFilter::addSample(double sample)
 {
-  buffer_.push_back(sample);
-  if (buffer_.size()>filter_len_)
-    buffer_.pop_front();
-}
+  if (filter_len_ == 0)
+    return;
 
-double OpenNI2TimerFilter::getMedian()
-{
-  if (buffer_.size()>0)
+  if (size_ < filter_len_)
+  {
+    std::size_t slot = (oldest_ + size_) % filter_len_;
+    buffer_[slot] = sample;
+    sum_ += sample;
+    ++size_;
+
+    // route the sample through the lower half, then restore the size invariant
+    push(lower_, slot);
+    push(upper_, pop(lower_));
+    if (upper_.size_ > lower_.size_ + 1)
+      push(lower_, pop(upper_));
+  } else
   {
-    std::deque<double> sort_buffer = buffer_;
+    // overwrite the oldest sample and move it to its new place
+    std::size_t slot = oldest_;
+    sum_ += sample - buffer_[slot];
+    buffer_[slot] = sample;
+    oldest_ = (oldest_ + 1) % filter_len_;
 
-    std::sort(sort_buffer.begin(), sort_buffer.end());
+    Heap& heap = in_upper_[slot] ? upper_ : lower_;
+    siftUp(heap, heap_pos_[slot]);
+    siftDown(heap, heap_pos_[slot]);
 
-    return sort_buffer[sort_buffer.size()/2];
-  } else
+    if (lower_.size_ > 0 && buffer_[lower_.slots_[0]] > buffer_[upper_.slots_[0]])
+      swapTops();
+
+    // resum once per revolution so rounding errors do not accumulate
+    if (oldest_ == 0)
+    {
+      sum_ = 0.0;
+      for (std::size_t i = 0; i < filter_len_; ++i)
+        sum_ += buffer_[i];
+    }
+  }
+}
+
+double OpenNI2TimerFilter::getMedian()
+{
+  if (size_>0)
+    return buffer_[upper_.slots_[0]];
+  else
     return 0.0;
 }
 
 double OpenNI2TimerFilter::getMovingAvg()
 {
-  if (buffer_.size() > 0)
-  {
-    double sum = 0;
+  if (size_ > 0)
+    return sum_ / static_cast<double>(size_);
+  else
+    return 0.0;
+}
 
-    std::deque<double>::const_iterator it = buffer_.begin();
-    std::deque<double>::const_iterator it_end = buffer_.end();
 
-    while (it != it_end)
-    {
-      sum += *(it++);
-    }
+void OpenNI2TimerFilter::clear()
+{
+  oldest_ = 0;
+  size_ = 0;
+  sum_ = 0.0;
+  lower_.size_ = 0;
+  upper_.size_ = 0;
+}
 
-    return sum / static_cast<double>(buffer_.size());
-  } else
-    return 0.0;
+bool OpenNI2TimerFilter::before(const Heap& heap, std::size_t a, std::size_t b) const
+{
+  return heap.max_ ? (buffer_[a] > buffer_[b]) : (buffer_[a] < buffer_[b]);
 }
 
+void OpenNI2TimerFilter::place(Heap& heap, std::size_t pos, std::size_t slot)
+{
+  heap.slots_[pos] = slot;
+  heap_pos_[slot] = pos;
+  in_upper_[slot] = !heap.max_;
+}
 
-void OpenNI2TimerFilter::clear()
+void OpenNI2TimerFilter::siftUp(Heap& heap, std::size_t pos)
+{
+  std::size_t slot = heap.slots_[pos];
+  while (pos > 0)
+  {
+    std::size_t parent = (pos - 1) / 2;
+    if (!before(heap, slot, heap.slots_[parent]))
+      break;
+    place(heap, pos, heap.slots_[parent]);
+    pos = parent;
+  }
+  place(heap, pos, slot);
+}
+
+void OpenNI2TimerFilter::siftDown(Heap& heap, std::size_t pos)
+{
+  std::size_t slot = heap.slots_[pos];
+  while (true)
+  {
+    std::size_t child = 2 * pos + 1;
+    if (child >= heap.size_)
+      break;
+    if (child + 1 < heap.size_ && before(heap, heap.slots_[child + 1], heap.slots_[child]))
+      ++child;
+    if (!before(heap, heap.slots_[child], slot))
+      break;
+    place(heap, pos, heap.slots_[child]);
+    pos = child;
+  }
+  place(heap, pos, slot);
+}
+
+void OpenNI2TimerFilter::push(Heap& heap, std::size_t slot)
+{
+  place(heap, heap.size_, slot);
+  ++heap.size_;
+  siftUp(heap, heap.size_ - 1);
+}
+
+std::size_t OpenNI2TimerFilter::pop(Heap& heap)
 {
-  buffer_.clear();
+  std::size_t top = heap.slots_[0];
+  --heap.size_;
+  if (heap.size_ > 0)
+  {
+    place(heap, 0, heap.slots_[heap.size_]);
+    siftDown(heap, 0);
+  }
+  return top;
+}
+
+void OpenNI2TimerFilter::swapTops()
+{
+  std::size_t lower_top = lower_.slots_[0];
+  std::size_t upper_top = upper_.slots_[0];
+
+  place(lower_, 0, upper_top);
+  place(upper_, 0, lower_top);
+
+  siftDown(lower_, 0);
+  siftDown(upper_, 0);
 }
 
 
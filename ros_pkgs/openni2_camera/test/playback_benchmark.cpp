@@ -0,0 +1,166 @@
+/*
+ * Copyright (c) 2013, Willow Garage, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Willow Garage, Inc. nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ *      Author: Julius Kammerl (jkammerl@willowgarage.com)
+ */
+
+#include "openni2_camera/openni2_device_manager.h"
+#include "openni2_camera/openni2_device.h"
+#include "openni2_camera/openni2_depth_conversion.h"
+
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/lexical_cast.hpp>
+
+#include <ctime>
+#include <iostream>
+#include <vector>
+
+using namespace std;
+using namespace openni2_wrapper;
+
+// Plays back an .oni file through the wrapper and measures the per-frame cost of
+// the driver pipeline (frame listener, image copy and depth conversion).
+// The last line of the output is meant to be parsed by CI.
+
+boost::mutex counter_mutex_;
+int ir_counter_ = 0;
+int color_counter_ = 0;
+int depth_counter_ = 0;
+
+std::vector<float> depth_buffer_;
+
+void IRCallback(sensor_msgs::ImagePtr image)
+{
+  boost::mutex::scoped_lock lock(counter_mutex_);
+  ++ir_counter_;
+}
+
+void ColorCallback(sensor_msgs::ImagePtr image)
+{
+  boost::mutex::scoped_lock lock(counter_mutex_);
+  ++color_counter_;
+}
+
+void DepthCallback(sensor_msgs::ImagePtr image)
+{
+  std::size_t size = image->width * image->height;
+  depth_buffer_.resize(size);
+  if (size > 0)
+    convertDepthFrame(reinterpret_cast<uint16_t*>(&image->data[0]), &depth_buffer_[0], size, 0, 1.0);
+
+  boost::mutex::scoped_lock lock(counter_mutex_);
+  ++depth_counter_;
+}
+
+int frameCount()
+{
+  boost::mutex::scoped_lock lock(counter_mutex_);
+  return ir_counter_ + color_counter_ + depth_counter_;
+}
+
+int main(int argc, char** argv)
+{
+  if (argc < 2)
+  {
+    std::cerr << "Usage: " << argv[0] << " <file.oni> [speed, 0 = as fast as possible]" << std::endl;
+    return 1;
+  }
+
+  std::string file_name = argv[1];
+  float speed = (argc > 2) ? boost::lexical_cast<float>(argv[2]) : 0.0f;
+
+  OpenNI2DeviceManager device_manager;
+  boost::shared_ptr<OpenNI2Device> device = device_manager.getDevice(file_name);
+
+  if (!device->isFile())
+  {
+    std::cerr << file_name << " is not a recording" << std::endl;
+    return 1;
+  }
+
+  device->setPlaybackSpeed(speed);
+  device->setPlaybackRepeat(false);
+
+  device->setIRFrameCallback(boost::bind(&IRCallback, _1));
+  device->setColorFrameCallback(boost::bind(&ColorCallback, _1));
+  device->setDepthFrameCallback(boost::bind(&DepthCallback, _1));
+
+  boost::posix_time::ptime start = boost::posix_time::microsec_clock::universal_time();
+  std::clock_t cpu_start = std::clock();
+
+  if (device->hasColorSensor())
+    device->startColorStream();
+  if (device->hasIRSensor())
+    device->startIRStream();
+  if (device->hasDepthSensor())
+    device->startDepthStream();
+
+  // the recording has ended once no frame arrived for a second
+  boost::posix_time::ptime end = start;
+  int frames = 0;
+  while (true)
+  {
+    boost::this_thread::sleep(boost::posix_time::milliseconds(10));
+
+    boost::posix_time::ptime now = boost::posix_time::microsec_clock::universal_time();
+    int count = frameCount();
+    if (count != frames)
+    {
+      frames = count;
+      end = now;
+    } else if ((now - end).total_milliseconds() > 1000)
+    {
+      break;
+    }
+  }
+
+  std::clock_t cpu_end = std::clock();
+  device->stopAllStreams();
+
+  double wall_time = (end - start).total_microseconds() * 1e-6;
+  // the idle second at the end hardly costs any cpu time
+  double cpu_time = static_cast<double>(cpu_end - cpu_start) / CLOCKS_PER_SEC;
+
+  std::cout << "IR frames: " << ir_counter_ << std::endl;
+  std::cout << "Color frames: " << color_counter_ << std::endl;
+  std::cout << "Depth frames: " << depth_counter_ << std::endl;
+
+  if (frames == 0 || wall_time <= 0.0)
+  {
+    std::cerr << "No frames played back" << std::endl;
+    return 1;
+  }
+
+  std::cout << "frames=" << frames
+            << " fps=" << frames / wall_time
+            << " cpu_ms_per_frame=" << cpu_time * 1000.0 / frames << std::endl;
+
+  return 0;
+}
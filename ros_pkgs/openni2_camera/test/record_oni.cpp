@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2013, Willow Garage, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Willow Garage, Inc. nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ *      Author: Julius Kammerl (jkammerl@willowgarage.com)
+ */
+
+#include "openni2_camera/openni2_device_manager.h"
+#include "openni2_camera/openni2_device.h"
+
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/lexical_cast.hpp>
+
+#include <iostream>
+
+using namespace std;
+using namespace openni2_wrapper;
+
+// Records depth, color and optionally IR of a connected device to an .oni file,
+// which can be played back by passing its path as device_id.
+int main(int argc, char** argv)
+{
+  if (argc < 3)
+  {
+    std::cerr << "Usage: " << argv[0] << " <file.oni> <seconds> [device_uri] [--ir]" << std::endl;
+    return 1;
+  }
+
+  std::string file_name = argv[1];
+  double duration = boost::lexical_cast<double>(argv[2]);
+  std::string device_uri = (argc > 3 && std::string(argv[3]) != "--ir") ? argv[3] : "";
+  bool record_ir = (std::string(argv[argc - 1]) == "--ir");
+
+  OpenNI2DeviceManager device_manager;
+
+  boost::shared_ptr<OpenNI2Device> device = device_uri.empty() ?
+      device_manager.getAnyDevice() : device_manager.getDevice(device_uri);
+
+  std::cout << *device;
+
+  // IR and color can not be streamed at the same time on most devices
+  if (record_ir)
+  {
+    device->startIRStream();
+  } else
+  {
+    device->startColorStream();
+  }
+  device->startDepthStream();
+
+  device->startRecording(file_name);
+
+  std::cout << "Recording to " << file_name << " for " << duration << " s" << std::endl;
+
+  boost::this_thread::sleep(boost::posix_time::milliseconds(static_cast<int>(duration * 1000.0)));
+
+  device->stopRecording();
+  device->stopAllStreams();
+
+  return 0;
+}
@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) 2013, Willow Garage, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Willow Garage, Inc. nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ *      Author: Julius Kammerl (jkammerl@willowgarage.com)
+ */
+
+#include "openni2_camera/openni2_depth_conversion.h"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+using namespace openni2_wrapper;
+
+namespace
+{
+
+// Random depth frame, including invalid pixels and values around 0x7FF
+std::vector<uint16_t> makeFrame(std::size_t size)
+{
+  std::vector<uint16_t> frame(size);
+  srand(42);
+  for (std::size_t i = 0; i < size; ++i)
+  {
+    switch (rand() % 8)
+    {
+      case 0: frame[i] = 0; break;
+      case 1: frame[i] = 0x7FF; break;
+      case 2: frame[i] = 0x7FF + (rand() % 5) - 2; break;
+      default: frame[i] = rand() % 10000; break;
+    }
+  }
+  return frame;
+}
+
+void expectSameAsScalar(std::size_t size, int z_offset_mm, double z_scaling)
+{
+  std::vector<uint16_t> raw = makeFrame(size);
+  std::vector<uint16_t> raw_ref = raw;
+  std::vector<float> depth(size);
+  std::vector<float> depth_ref(size);
+
+  convertDepthFrame(raw.empty() ? NULL : &raw[0], depth.empty() ? NULL : &depth[0],
+                    size, z_offset_mm, z_scaling);
+  convertDepthFrameScalar(raw_ref.empty() ? NULL : &raw_ref[0], depth_ref.empty() ? NULL : &depth_ref[0],
+                          size, z_offset_mm, z_scaling);
+
+  for (std::size_t i = 0; i < size; ++i)
+  {
+    ASSERT_EQ(raw_ref[i], raw[i]) << "pixel " << i;
+    if (std::isnan(depth_ref[i]))
+      ASSERT_TRUE(std::isnan(depth[i])) << "pixel " << i;
+    else
+      ASSERT_EQ(0, std::memcmp(&depth_ref[i], &depth[i], sizeof(float))) << "pixel " << i;
+  }
+}
+
+}
+
+TEST(DepthConversion, ScalarPath)
+{
+  uint16_t raw[4] = {0, 0x7FF, 1000, 1234};
+  float depth[4];
+
+  convertDepthFrameScalar(raw, depth, 4, 0, 1.0);
+
+  EXPECT_TRUE(std::isnan(depth[0]));
+  EXPECT_TRUE(std::isnan(depth[1]));
+  EXPECT_FLOAT_EQ(1.0f, depth[2]);
+  EXPECT_FLOAT_EQ(1.234f, depth[3]);
+
+  convertDepthFrameScalar(raw, NULL, 4, 10, 2.0);
+
+  EXPECT_EQ(0, raw[0]);
+  EXPECT_EQ((0x7FF + 10) * 2, raw[1]);
+  EXPECT_EQ(2020, raw[2]);
+  EXPECT_EQ(2488, raw[3]);
+}
+
+TEST(DepthConversion, Plain)
+{
+  expectSameAsScalar(640 * 480, 0, 1.0);
+}
+
+TEST(DepthConversion, Offset)
+{
+  expectSameAsScalar(640 * 480, 25, 1.0);
+  expectSameAsScalar(640 * 480, -40, 1.0);
+}
+
+TEST(DepthConversion, Scaling)
+{
+  expectSameAsScalar(640 * 480, 0, 1.1);
+  expectSameAsScalar(640 * 480, 0, 0.97);
+}
+
+TEST(DepthConversion, OffsetAndScaling)
+{
+  expectSameAsScalar(640 * 480, -12, 1.03);
+}
+
+TEST(DepthConversion, OddSizes)
+{
+  for (std::size_t size = 0; size < 20; ++size)
+    expectSameAsScalar(size, 7, 1.5);
+}
+
+TEST(DepthConversion, RawOnly)
+{
+  std::vector<uint16_t> raw = makeFrame(1003);
+  std::vector<uint16_t> raw_ref = raw;
+
+  convertDepthFrame(&raw[0], NULL, raw.size(), 30, 0.9);
+  convertDepthFrameScalar(&raw_ref[0], NULL, raw_ref.size(), 30, 0.9);
+
+  EXPECT_TRUE(raw == raw_ref);
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -77,5 +77,25 @@ class JointTrajectory {
 
 };
 
+///////////////////////////////////////////////////////////////////////////////
+/// Point of a trajectory for several joints
+/// the values are in the order of the joints, empty velocities or accelerations are zero
+///////////////////////////////////////////////////////////////////////////////
+struct MultiJointTrajectoryPoint
+{
+  std::vector< quantity<plane_angle> > positions;
+  std::vector< quantity<angular_velocity> > velocities;
+  std::vector< quantity<angular_acceleration> > accelerations;
+  boost::posix_time::time_duration time_from_start;
+};
+///////////////////////////////////////////////////////////////////////////////
+/// Trajectory for several joints which are moved synchronously
+///////////////////////////////////////////////////////////////////////////////
+class MultiJointTrajectory {
+  public:
+    std::vector< MultiJointTrajectoryPoint > points;
+
+};
+
 } // namespace youbot
 #endif
@@ -0,0 +1,154 @@
+#ifndef YOUBOT_PERIODICTIMER_H
+#define YOUBOT_PERIODICTIMER_H
+
+/****************************************************************
+ *
+ * Copyright (c) 2011
+ * All rights reserved.
+ *
+ * Hochschule Bonn-Rhein-Sieg
+ * University of Applied Sciences
+ * Computer Science Department
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Author:
+ * Jan Paulus, Nico Hochgeschwender, Michael Reckhaus, Azamat Shakhimardanov
+ * Supervised by:
+ * Gerhard K. Kraetzschmar
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * This sofware is published under a dual-license: GNU Lesser General Public 
+ * License LGPL 2.1 and BSD license. The dual-license implies that users of this
+ * code may choose which terms they prefer.
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Hochschule Bonn-Rhein-Sieg nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License LGPL as
+ * published by the Free Software Foundation, either version 2.1 of the
+ * License, or (at your option) any later version or the BSD license.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License LGPL and the BSD license for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License LGPL and BSD license along with this program.
+ *
+ ****************************************************************/
+#include <vector>
+
+namespace youbot {
+
+///////////////////////////////////////////////////////////////////////////////
+/// Timing statistics of a periodic thread
+/// The latency is the time between the deadline of a cycle and the actual wake up of the thread.
+///////////////////////////////////////////////////////////////////////////////
+struct PeriodicTimerStatistics {
+    static const unsigned int HISTOGRAM_SIZE = 32;
+
+    ///number of cycles since the start or the last reset
+    unsigned long cycles;
+
+    ///number of deadlines which have been missed because a cycle took longer than the period
+    unsigned long overruns;
+
+    ///in microseconds
+    long minLatency;
+
+    ///in microseconds
+    long maxLatency;
+
+    ///in microseconds
+    double meanLatency;
+
+    ///time between the wake up and the end of a cycle in microseconds
+    double meanExecutionTime;
+
+    ///in microseconds
+    long maxExecutionTime;
+
+    ///width of one histogram bin in microseconds
+    unsigned int histogramBinWidth;
+
+    ///number of cycles per latency bin, the last bin contains all latencies which are longer
+    unsigned long latencyHistogram[HISTOGRAM_SIZE];
+
+    PeriodicTimerStatistics();
+
+    void reset();
+
+};
+
+///////////////////////////////////////////////////////////////////////////////
+/// Wakes up a thread periodically at absolute deadlines on a monotonic clock
+/// The deadlines do not depend on the wake up time, so the error of a single cycle does not accumulate.
+/// If a cycle overruns the missed deadlines are skipped and counted.
+///////////////////////////////////////////////////////////////////////////////
+class PeriodicTimer {
+  public:
+    ///@param periodMicroSec period of the timer in microseconds
+    ///@param histogramBinWidthMicroSec width of one bin of the latency histogram in microseconds
+    PeriodicTimer(const unsigned int periodMicroSec, const unsigned int histogramBinWidthMicroSec = 10);
+
+    virtual ~PeriodicTimer();
+
+    ///sets the first deadline to one period from now
+    void start();
+
+    ///sleeps until the next deadline and updates the statistics
+    void waitForNextPeriod();
+
+    const PeriodicTimerStatistics& getStatistics() const;
+
+    void resetStatistics();
+
+    unsigned int getPeriod() const;
+
+    ///returns the time of a monotonic clock in microseconds
+    static long long getMonotonicTimeMicroSec();
+
+    ///switches the calling thread to the SCHED_FIFO scheduler with the given priority
+    ///returns false if the priority could not be set e.g. because of missing permissions
+    static bool setRealtimePriority(const int priority);
+
+    ///pins the calling thread to one CPU
+    ///returns false if the affinity could not be set
+    static bool setCpuAffinity(const int cpu);
+
+
+  private:
+    ///sleeps until the given absolute time of the monotonic clock
+    void sleepUntil(const long long timeMicroSec);
+
+    unsigned int period;
+
+    long long nextDeadline;
+
+    double latencySum;
+
+    double executionTimeSum;
+
+    long long lastWakeUp;
+
+    PeriodicTimerStatistics statistics;
+
+};
+
+} // namespace youbot
+#endif
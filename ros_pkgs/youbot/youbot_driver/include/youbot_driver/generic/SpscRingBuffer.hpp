@@ -0,0 +1,155 @@
+#ifndef YOUBOT_SPSCRINGBUFFER_H
+#define YOUBOT_SPSCRINGBUFFER_H
+
+/****************************************************************
+ *
+ * Copyright (c) 2011
+ * All rights reserved.
+ *
+ * Hochschule Bonn-Rhein-Sieg
+ * University of Applied Sciences
+ * Computer Science Department
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Author:
+ * Jan Paulus, Nico Hochgeschwender, Michael Reckhaus, Azamat Shakhimardanov
+ * Supervised by:
+ * Gerhard K. Kraetzschmar
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * This sofware is published under a dual-license: GNU Lesser General Public 
+ * License LGPL 2.1 and BSD license. The dual-license implies that users of this
+ * code may choose which terms they prefer.
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Hochschule Bonn-Rhein-Sieg nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License LGPL as
+ * published by the Free Software Foundation, either version 2.1 of the
+ * License, or (at your option) any later version or the BSD license.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License LGPL and the BSD license for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License LGPL and BSD license along with this program.
+ *
+ ****************************************************************/
+#include <vector>
+#include "youbot_driver/generic/dataobjectlockfree/target.hpp"
+#include "youbot_driver/generic/dataobjectlockfree/os/oro_arch.h"
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace youbot {
+
+///////////////////////////////////////////////////////////////////////////////
+/// Fixed size ring buffer for exactly one producer and one consumer thread.
+/// push() and pop() never lock and never allocate memory, so the producer can be a real-time thread.
+/// If the buffer is full push() drops the element and counts it.
+///////////////////////////////////////////////////////////////////////////////
+template<class T>
+class SpscRingBuffer {
+  public:
+    ///@param capacity maximum number of elements in the buffer
+    SpscRingBuffer(const unsigned int capacity)
+      : buffer(capacity > 0 ? capacity : 1), readIndex(0), writeIndex(0) {
+      oro_atomic_set(&fillLevel, 0);
+      oro_atomic_set(&droppedElements, 0);
+    }
+
+    ~SpscRingBuffer() {}
+
+    ///copies one element into the buffer, must only be called by the producer thread
+    ///returns false if the buffer was full and the element has been dropped
+    bool push(const T& element) {
+      if ((unsigned int) oro_atomic_read(&fillLevel) >= buffer.size()) {
+        oro_atomic_inc(&droppedElements);
+        return false;
+      }
+      // the slot must not be written before the consumer has released it
+      memoryBarrier();
+      buffer[writeIndex] = element;
+      writeIndex = (writeIndex + 1) % buffer.size();
+      // the atomic increment is a full memory barrier and publishes the element
+      oro_atomic_inc(&fillLevel);
+      return true;
+    }
+
+    ///copies up to maxElements elements out of the buffer, must only be called by the consumer thread
+    ///returns the number of copied elements
+    unsigned int pop(T* elements, const unsigned int maxElements) {
+      unsigned int available = (unsigned int) oro_atomic_read(&fillLevel);
+      if (available > maxElements)
+        available = maxElements;
+      // oro_atomic_read is a plain load, the elements must not be read before it
+      memoryBarrier();
+
+      for (unsigned int i = 0; i < available; i++) {
+        elements[i] = buffer[readIndex];
+        readIndex = (readIndex + 1) % buffer.size();
+      }
+      if (available > 0)
+        oro_atomic_sub(&fillLevel, (int) available);
+      return available;
+    }
+
+    unsigned int size() const {
+      return (unsigned int) oro_atomic_read(&fillLevel);
+    }
+
+    unsigned int capacity() const {
+      return buffer.size();
+    }
+
+    ///returns the number of elements which have been dropped because the buffer was full
+    unsigned int getNumberOfDroppedElements() const {
+      return (unsigned int) oro_atomic_read(&droppedElements);
+    }
+
+
+  private:
+    ///orders the accesses to the elements against the fill level
+    static inline void memoryBarrier() {
+#if defined(_MSC_VER)
+      _ReadWriteBarrier();
+#else
+      __sync_synchronize();
+#endif
+    }
+
+    SpscRingBuffer(const SpscRingBuffer & source);
+
+    SpscRingBuffer & operator=(const SpscRingBuffer & source);
+
+    std::vector<T> buffer;
+
+    unsigned int readIndex;
+
+    unsigned int writeIndex;
+
+    mutable oro_atomic_t fillLevel;
+
+    mutable oro_atomic_t droppedElements;
+
+};
+
+} // namespace youbot
+#endif
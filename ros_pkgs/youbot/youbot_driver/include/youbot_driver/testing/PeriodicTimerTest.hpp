@@ -0,0 +1,57 @@
+#ifndef PERIODIC_TIMER_TEST_H
+#define PERIODIC_TIMER_TEST_H
+
+#include <cppunit/TestCase.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <iostream>
+#include <boost/thread.hpp>
+#include "youbot_driver/generic/Logger.hpp"
+#include "youbot_driver/generic/PeriodicTimer.hpp"
+
+using namespace youbot;
+
+///////////////////////////////////////////////////////////////////////////////
+/// A unit test for the periodic timer of the EtherCAT thread
+/// It simulates the bus communication by busy waiting and does not need a youBot
+///////////////////////////////////////////////////////////////////////////////
+class PeriodicTimerTest : public CppUnit::TestFixture {
+	CPPUNIT_TEST_SUITE(PeriodicTimerTest);
+	CPPUNIT_TEST(periodicTimerNoDriftTest);
+	CPPUNIT_TEST(periodicTimerJitterUnderLoadTest);
+	CPPUNIT_TEST(periodicTimerOverrunTest);
+	CPPUNIT_TEST_SUITE_END();
+
+public:
+	PeriodicTimerTest();
+	virtual ~PeriodicTimerTest();
+
+	void setUp();
+	void tearDown();
+
+	void periodicTimerNoDriftTest();
+
+	void periodicTimerJitterUnderLoadTest();
+
+	void periodicTimerOverrunTest();
+
+private:
+	///runs the timed cycles with real-time priority on CPU 0, like the EtherCAT thread
+	///has to run on its own thread, the settings are kept until the thread exits
+	void runRealtimeCycles(PeriodicTimerStatistics* statistics);
+
+	///busy waits like a send/receive of the process data
+	void simulateBusCycle(const long durationMicroSec);
+
+	///keeps one CPU busy until stopLoad is set
+	void generateLoad();
+
+	void printStatistics(const PeriodicTimerStatistics& statistics);
+
+	unsigned int period;
+	unsigned int cycles;
+	unsigned int busCycleDuration;
+	volatile bool stopLoad;
+};
+
+#endif //PERIODIC_TIMER_TEST_H
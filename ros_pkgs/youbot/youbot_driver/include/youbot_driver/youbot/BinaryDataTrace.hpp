@@ -0,0 +1,162 @@
+#ifndef YOUBOT_BINARYDATATRACE_H
+#define YOUBOT_BINARYDATATRACE_H
+
+/****************************************************************
+ *
+ * Copyright (c) 2011
+ * All rights reserved.
+ *
+ * Hochschule Bonn-Rhein-Sieg
+ * University of Applied Sciences
+ * Computer Science Department
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Author:
+ * Jan Paulus, Nico Hochgeschwender, Michael Reckhaus, Azamat Shakhimardanov
+ * Supervised by:
+ * Gerhard K. Kraetzschmar
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * This sofware is published under a dual-license: GNU Lesser General Public 
+ * License LGPL 2.1 and BSD license. The dual-license implies that users of this
+ * code may choose which terms they prefer.
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Hochschule Bonn-Rhein-Sieg nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License LGPL as
+ * published by the Free Software Foundation, either version 2.1 of the
+ * License, or (at your option) any later version or the BSD license.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License LGPL and the BSD license for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License LGPL and BSD license along with this program.
+ *
+ ****************************************************************/
+#include <vector>
+#include <string>
+#include <fstream>
+#include <boost/thread.hpp>
+#include "youbot_driver/generic/SpscRingBuffer.hpp"
+#include "youbot_driver/youbot/YouBotSlaveMsg.hpp"
+#include "youbot_driver/youbot/YouBotJoint.hpp"
+
+namespace youbot {
+
+/// Process data of one joint in one EtherCAT cycle as it is stored in the binary trace file
+
+PACKED_BEGIN
+struct BinaryDataTraceRecord {
+  uint64 timeMicroSec;
+  uint32 cycle;
+  uint32 jointNumber;
+  SlaveMessageInput input;
+  SlaveMessageOutput output;
+} PACKED;
+PACKED_END
+
+/// Configuration of one joint which is stored in the header of the binary trace file
+
+PACKED_BEGIN
+struct BinaryDataTraceJointInfo {
+  uint32 jointNumber;
+  int32 inverseMovementDirection;
+  uint32 encoderTicksPerRound;
+  double gearRatio;
+  double torqueConstant;
+  char name[32];
+} PACKED;
+PACKED_END
+
+///////////////////////////////////////////////////////////////////////////////
+/// Records the raw process data of several joints in every EtherCAT cycle into a binary file.
+/// The EtherCAT thread only copies a fixed size record into a lock-free ring buffer per joint.
+/// A background thread writes the records to the file.
+/// Use convertToText() or the youBot_trace_converter to create jointDataTrace files for the gnuplotconfig.
+///////////////////////////////////////////////////////////////////////////////
+class BinaryDataTrace {
+  public:
+    ///@param fileName name of the binary trace file
+    ///@param bufferSize number of records which can be buffered per joint before records get dropped
+    BinaryDataTrace(const std::string& fileName, const unsigned int bufferSize = 10000);
+
+    virtual ~BinaryDataTrace();
+
+    ///adds a joint to the trace, all joints have to be added before the trace is started
+    void addJoint(YouBotJoint& joint);
+
+    ///opens the file and registers the trace at the EtherCAT master
+    void startTrace();
+
+    ///removes the registration at the EtherCAT master and writes all outstanding records
+    void stopTrace();
+
+    bool isTraceActive() const;
+
+    ///stores the process data of one joint, it is called by the EtherCAT thread
+    ///it does not block and does not allocate memory
+    void update(const unsigned int jointNumber, const uint32 cycle, const uint64 timeMicroSec, const SlaveMessageInput& input, const SlaveMessageOutput& output);
+
+    ///returns the number of records which have been dropped because the file could not be written fast enough
+    unsigned int getNumberOfDroppedRecords() const;
+
+    ///converts a binary trace file into one jointDataTrace file per joint in the folder outputFolder/joint<N>/
+    ///the columns are the same as the ones of the DataTrace
+    ///@param binaryFileName name of the binary trace file
+    ///@param outputFolder folder for the text files
+    ///@param csv use comma separated values instead of the gnuplot format
+    static void convertToText(const std::string& binaryFileName, const std::string& outputFolder, const bool csv = false);
+
+
+  private:
+    BinaryDataTrace(const BinaryDataTrace & source);
+
+    BinaryDataTrace & operator=(const BinaryDataTrace & source);
+
+    ///writes the buffered records to the file, this method is executed in a separate thread
+    void writeRecords();
+
+    ///writes all records which are in the buffers at the moment, returns the number of written records
+    unsigned int flushBuffers();
+
+    std::string fileName;
+
+    unsigned int bufferSize;
+
+    std::vector<BinaryDataTraceJointInfo> jointInfos;
+
+    ///one buffer per joint, indexed with the joint number - 1
+    std::vector<SpscRingBuffer<BinaryDataTraceRecord>*> buffers;
+
+    std::vector<BinaryDataTraceRecord> writeBuffer;
+
+    std::ofstream file;
+
+    boost::thread writerThread;
+
+    volatile bool traceActive;
+
+    volatile bool stopWriter;
+
+};
+
+} // namespace youbot
+#endif
@@ -54,6 +54,7 @@
 #include "youbot_driver/youbot/YouBotSlaveMsg.hpp"
 #include "youbot_driver/youbot/YouBotSlaveMailboxMsg.hpp"
 #include "youbot_driver/youbot/JointLimitMonitor.hpp"
+#include "youbot_driver/generic/PeriodicTimer.hpp"
 extern "C"{
 #include <youbot_driver/soem/ethercattype.h>
 #include <nicdrv.h>
@@ -90,6 +91,11 @@ friend class YouBotGripperBar;
     ///@param ethercatSlaveInfos ethercat slave informations
     virtual void getEthercatDiagnosticInformation(std::vector<ec_slavet>& ethercatSlaveInfos) = 0;
 
+    ///provides all ethercat slave informations from the SOEM driver and the timing statistics of the communication thread
+    ///@param ethercatSlaveInfos ethercat slave informations
+    ///@param cycleStatistics timing statistics of the communication thread
+    virtual void getEthercatDiagnosticInformation(std::vector<ec_slavet>& ethercatSlaveInfos, PeriodicTimerStatistics& cycleStatistics) = 0;
+
     ///sends ethercat messages to the motor controllers
     /// returns a true if everything it OK and returns false if something fail
     virtual bool sendProcessData() = 0;
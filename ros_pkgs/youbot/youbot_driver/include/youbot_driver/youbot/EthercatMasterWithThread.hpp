@@ -63,11 +63,14 @@
 #include "youbot_driver/generic/Units.hpp"
 #include "youbot_driver/generic/Time.hpp"
 #include "youbot_driver/generic/ConfigFile.hpp"
+#include "youbot_driver/generic/PeriodicTimer.hpp"
 #include "youbot_driver/youbot/ProtocolDefinitions.hpp"
 #include "youbot_driver/youbot/YouBotSlaveMsg.hpp"
 #include "youbot_driver/youbot/YouBotSlaveMailboxMsg.hpp"
 #include "youbot_driver/youbot/EthercatMaster.hpp"
 #include "youbot_driver/youbot/EthercatMasterInterface.hpp"
+#include "youbot_driver/youbot/EthercatTransport.hpp"
+#include "youbot_driver/youbot/ProcessDataImage.hpp"
 #include "youbot_driver/youbot/JointTrajectoryController.hpp"
 #include "youbot_driver/youbot/JointLimitMonitor.hpp"
 
@@ -78,6 +81,9 @@ extern "C"{
 
 namespace youbot {
 
+class BinaryDataTrace;
+class SynchronizedTrajectoryExecutor;
+
 ///////////////////////////////////////////////////////////////////////////////
 /// The Ethercat Master is managing the whole ethercat communication 
 /// It have to be a singleton in the system
@@ -107,6 +113,14 @@ friend class YouBotGripperBar;
     ///@param ethercatSlaveInfos ethercat slave informations
     void getEthercatDiagnosticInformation(std::vector<ec_slavet>& ethercatSlaveInfos);
 
+    ///provides all ethercat slave informations from the SOEM driver and the timing statistics of the communication thread
+    ///@param ethercatSlaveInfos ethercat slave informations
+    ///@param cycleStatistics timing statistics of the communication thread
+    void getEthercatDiagnosticInformation(std::vector<ec_slavet>& ethercatSlaveInfos, PeriodicTimerStatistics& cycleStatistics);
+
+    ///resets the timing statistics of the communication thread
+    void resetCycleStatistics();
+
     ///sends ethercat messages to the motor controllers
     /// returns a true if everything it OK and returns false if something fail
     bool sendProcessData();
@@ -133,6 +147,17 @@ friend class YouBotGripperBar;
 
     void deleteDataTraceRegistration(const unsigned int JointNumber);
 
+    ///registers a binary data trace which gets the process data of all slaves in every cycle
+    void registerBinaryDataTrace(BinaryDataTrace* object);
+
+    void deleteBinaryDataTraceRegistration();
+
+    ///registers an executor which steps a trajectory of several joints in every cycle
+    ///the cycle period is passed to the executor, all joints have to be added before
+    void registerSynchronizedTrajectoryExecutor(SynchronizedTrajectoryExecutor* object);
+
+    void deleteSynchronizedTrajectoryExecutorRegistration(SynchronizedTrajectoryExecutor* object);
+
 
   private:
     ///establishes the ethercat connection
@@ -175,6 +200,30 @@ friend class YouBotGripperBar;
 
     void parseYouBotErrorFlags(const YouBotSlaveMsg& messageBuffer);
 
+    ///objects which are called by the communication thread in every cycle
+    ///a published instance is never changed, a registration publishes a modified copy
+    struct Registrations {
+      std::vector<JointTrajectoryController*> trajectoryControllers;
+
+      std::vector<JointLimitMonitor*> jointLimitMonitors;
+
+      std::vector<void*> dataTraces;
+
+      BinaryDataTrace* binaryDataTrace;
+
+      std::vector<SynchronizedTrajectoryExecutor*> trajectoryExecutors;
+
+    };
+
+    ///swaps the registrations used by the communication thread, has to be called with the registrationMutex held
+    ///@param newRegistrations registrations which will be owned by the master
+    ///@return the replaced registrations, which have to be handed to retireRegistrations after releasing the mutex
+    Registrations* publishRegistrations(Registrations* newRegistrations);
+
+    ///deletes replaced registrations as soon as the communication thread has finished the cycle which might still use them
+    ///must not be called with the registrationMutex held
+    void retireRegistrations(Registrations* oldRegistrations);
+
     std::string ethernetDevice;
 
     char IOmap_[4096];
@@ -187,7 +236,8 @@ friend class YouBotGripperBar;
 
     std::vector<SlaveMessageInput*> ethercatInputBufferVector;
 
-    std::vector<YouBotSlaveMsgThreadSafe> slaveMessages;
+    ///process data shared between the communication thread and the user threads
+    ProcessDataImage* processDataImage;
 
     std::vector<ec_slavet> ethercatSlaveInfo;
 
@@ -196,6 +246,16 @@ friend class YouBotGripperBar;
     //in microseconds
     unsigned int timeTillNextEthercatUpdate;
 
+    ///SCHED_FIFO priority of the communication thread, 0 keeps the default scheduler
+    int threadPriority;
+
+    ///CPU of the communication thread, -1 does not pin the thread
+    int cpuAffinity;
+
+    DataObjectLockFree<PeriodicTimerStatistics> cycleStatistics;
+
+    volatile bool resetCycleStatisticsRequested;
+
     boost::thread_group threads;
 
     volatile bool stopThread;
@@ -220,6 +280,8 @@ friend class YouBotGripperBar;
 
     ConfigFile* configfile;
 
+    EthercatTransport* transport;
+
     static std::string configFileName;
 
     static std::string configFilepath;
@@ -234,17 +296,14 @@ friend class YouBotGripperBar;
 
     long int maxCommunicationErrors;
 
-    std::vector<JointTrajectoryController*> trajectoryControllers;
-
-    boost::mutex trajectoryControllerVectorMutex;
-
-    std::vector<JointLimitMonitor*> jointLimitMonitors;
-
-    boost::mutex jointLimitMonitorVectorMutex;
+    ///current registrations, read once per cycle by the communication thread
+    Registrations* volatile registrations;
 
-    std::vector<void*> dataTraces;
+    ///serialises the registration changes, never taken by the communication thread
+    boost::mutex registrationMutex;
 
-    boost::mutex dataTracesMutex;
+    ///number of EtherCAT cycles since the thread has been started
+    volatile uint32 ethercatCycleCounter;
 
 };
 
@@ -68,6 +68,7 @@
 #include "youbot_driver/youbot/YouBotSlaveMailboxMsg.hpp"
 #include "youbot_driver/youbot/EthercatMaster.hpp"
 #include "youbot_driver/youbot/EthercatMasterInterface.hpp"
+#include "youbot_driver/youbot/EthercatTransport.hpp"
 #include "youbot_driver/youbot/JointLimitMonitor.hpp"
 
 extern "C"{
@@ -106,6 +107,11 @@ friend class YouBotGripperBar;
     ///@param ethercatSlaveInfos ethercat slave informations
     void getEthercatDiagnosticInformation(std::vector<ec_slavet>& ethercatSlaveInfos);
 
+    ///provides all ethercat slave informations from the SOEM driver and the timing statistics of the communication thread
+    ///@param ethercatSlaveInfos ethercat slave informations
+    ///@param cycleStatistics timing statistics of the communication thread
+    void getEthercatDiagnosticInformation(std::vector<ec_slavet>& ethercatSlaveInfos, PeriodicTimerStatistics& cycleStatistics);
+
     ///sends ethercat messages to the motor controllers
     /// returns a true if everything it OK and returns false if something fail
     bool sendProcessData();
@@ -180,6 +186,8 @@ friend class YouBotGripperBar;
 
     ConfigFile* configfile;
 
+    EthercatTransport* transport;
+
     std::vector<ec_slavet> ethercatSlaveInfo;
 
     char IOmap_[4096];
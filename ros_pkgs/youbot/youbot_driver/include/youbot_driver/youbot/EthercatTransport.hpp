@@ -0,0 +1,142 @@
+#ifndef YOUBOT_ETHERCATTRANSPORT_H
+#define YOUBOT_ETHERCATTRANSPORT_H
+
+/****************************************************************
+ *
+ * Copyright (c) 2011
+ * All rights reserved.
+ *
+ * Hochschule Bonn-Rhein-Sieg
+ * University of Applied Sciences
+ * Computer Science Department
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Author:
+ * Jan Paulus, Nico Hochgeschwender, Michael Reckhaus, Azamat Shakhimardanov
+ * Supervised by:
+ * Gerhard K. Kraetzschmar
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * This sofware is published under a dual-license: GNU Lesser General Public 
+ * License LGPL 2.1 and BSD license. The dual-license implies that users of this
+ * code may choose which terms they prefer.
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Hochschule Bonn-Rhein-Sieg nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License LGPL as
+ * published by the Free Software Foundation, either version 2.1 of the
+ * License, or (at your option) any later version or the BSD license.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License LGPL and the BSD license for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License LGPL and BSD license along with this program.
+ *
+ ****************************************************************/
+#include <string>
+#include "youbot_driver/generic/ConfigFile.hpp"
+extern "C"{
+#include <youbot_driver/soem/ethercattype.h>
+#include <nicdrv.h>
+#include <youbot_driver/soem/ethercatmain.h>
+}
+
+namespace youbot {
+
+///////////////////////////////////////////////////////////////////////////////
+/// Transport layer between the EtherCAT master and the EtherCAT slaves
+/// The methods have the same semantics as the corresponding SOEM functions.
+/// Like SOEM the transport fills the global slave list ec_slave and ec_slavecount.
+///////////////////////////////////////////////////////////////////////////////
+class EthercatTransport {
+  public:
+    virtual ~EthercatTransport() {};
+
+    ///opens the network interface, returns a value > 0 if it succeeded
+    virtual int init(const std::string& ethernetDevice) = 0;
+
+    ///finds and configures all slaves and maps their process data into ioMap
+    ///returns the number of slaves
+    virtual int config(void* ioMap) = 0;
+
+    virtual uint16 stateCheck(const uint16 slave, const uint16 requestedState, const int timeout) = 0;
+
+    virtual int readState() = 0;
+
+    virtual int writeState(const uint16 slave) = 0;
+
+    ///returns a value > 0 if it succeeded
+    virtual int sendProcessData() = 0;
+
+    ///returns the working counter, 0 if no data has been received
+    virtual int receiveProcessData(const int timeout) = 0;
+
+    ///returns a value > 0 if it succeeded
+    virtual int mailboxSend(const uint16 slave, ec_mbxbuft* mailbox, const int timeout) = 0;
+
+    ///returns a value > 0 if a message has been received
+    virtual int mailboxReceive(const uint16 slave, ec_mbxbuft* mailbox, const int timeout) = 0;
+
+    virtual bool isError() = 0;
+
+    virtual void close() = 0;
+
+    ///creates the transport which is selected by the key Transport in the EtherCAT section of the config file
+    ///"SOEM" (default) or "Simulation"
+    static EthercatTransport* create(ConfigFile& configfile);
+
+};
+
+///////////////////////////////////////////////////////////////////////////////
+/// Transport over a real network interface with the SOEM driver
+///////////////////////////////////////////////////////////////////////////////
+class SoemEthercatTransport : public EthercatTransport {
+  public:
+    SoemEthercatTransport();
+
+    virtual ~SoemEthercatTransport();
+
+    virtual int init(const std::string& ethernetDevice);
+
+    virtual int config(void* ioMap);
+
+    virtual uint16 stateCheck(const uint16 slave, const uint16 requestedState, const int timeout);
+
+    virtual int readState();
+
+    virtual int writeState(const uint16 slave);
+
+    virtual int sendProcessData();
+
+    virtual int receiveProcessData(const int timeout);
+
+    virtual int mailboxSend(const uint16 slave, ec_mbxbuft* mailbox, const int timeout);
+
+    virtual int mailboxReceive(const uint16 slave, ec_mbxbuft* mailbox, const int timeout);
+
+    virtual bool isError();
+
+    virtual void close();
+
+};
+
+} // namespace youbot
+#endif
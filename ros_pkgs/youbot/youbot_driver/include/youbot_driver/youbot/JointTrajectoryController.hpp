@@ -84,6 +84,16 @@ struct Segment
   Spline spline;
 };
 
+/// Joint trajectory segment as it is evaluated in the EtherCAT cycle
+/// the times are microseconds of the monotonic clock and the coefficients are stored inline
+struct TrajectoryTableSegment
+{
+  long long startTime;
+  long long endTime;
+  double duration;
+  double coef[6];
+};
+
 ///////////////////////////////////////////////////////////////////////////////
 /// Joint Trajectory Controller
 ///////////////////////////////////////////////////////////////////////////////
@@ -113,6 +123,13 @@ class JointTrajectoryController {
 
     bool updateTrajectoryController(const SlaveMessageInput& actual, SlaveMessageOutput& velocity);
 
+    ///updates the controllers of several joints with one time stamp
+    ///@param controllers one controller per slave, NULL if the slave has no controller
+    ///@param actual process data inputs of the slaves
+    ///@param velocity outputs of the slaves, only valid if update is true
+    ///@param update true for every slave which got a new output
+    static void updateTrajectoryControllers(const std::vector<JointTrajectoryController*>& controllers, const std::vector<SlaveMessageInput*>& actual, std::vector<SlaveMessageOutput>& velocity, std::vector<bool>& update);
+
     void getLastTargetPosition(JointAngleSetpoint& position);
     
     void getLastTargetVelocity(JointVelocitySetpoint& velocity);
@@ -135,18 +152,32 @@ class JointTrajectoryController {
 
     void sampleSplineWithTimeBounds(const std::vector<double>& coefficients, const double duration, const double time, double& position, double& velocity, double& acceleration);
 
-    bool isControllerActive;
+    bool updateTrajectoryController(const long long now, const SlaveMessageInput& actual, SlaveMessageOutput& velocity);
 
-    PidController pid;
+    ///converts the trajectory into a table and makes both available to the EtherCAT thread
+    void commitTrajectory(const boost::shared_ptr<const std::vector<Segment> >& trajectory, const boost::posix_time::ptime& time_now);
 
-    boost::posix_time::ptime time;
+    bool isControllerActive;
 
-    boost::posix_time::ptime last_time;
+    PidController pid;
 
     typedef std::vector<Segment> SpecifiedTrajectory;
 
     DataObjectLockFree< boost::shared_ptr<const SpecifiedTrajectory> > current_trajectory_box_;
 
+    typedef std::vector<TrajectoryTableSegment> TrajectoryTable;
+
+    DataObjectLockFree< boost::shared_ptr<const TrajectoryTable> > current_table_box_;
+
+    ///table which is evaluated by the EtherCAT thread
+    boost::shared_ptr<const TrajectoryTable> active_table_;
+
+    ///index of the active segment in active_table_, -1 before the first segment
+    int table_cursor_;
+
+    ///time of the last update in microseconds of the monotonic clock
+    long long last_update_time_;
+
     double targetPosition;
 
     double targetVelocity;
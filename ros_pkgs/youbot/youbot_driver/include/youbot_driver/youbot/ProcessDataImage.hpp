@@ -0,0 +1,135 @@
+#ifndef YOUBOT_PROCESSDATAIMAGE_H
+#define YOUBOT_PROCESSDATAIMAGE_H
+
+/****************************************************************
+ *
+ * Copyright (c) 2011
+ * All rights reserved.
+ *
+ * Hochschule Bonn-Rhein-Sieg
+ * University of Applied Sciences
+ * Computer Science Department
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Author:
+ * Jan Paulus, Nico Hochgeschwender, Michael Reckhaus, Azamat Shakhimardanov
+ * Supervised by:
+ * Gerhard K. Kraetzschmar
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * This sofware is published under a dual-license: GNU Lesser General Public 
+ * License LGPL 2.1 and BSD license. The dual-license implies that users of this
+ * code may choose which terms they prefer.
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Hochschule Bonn-Rhein-Sieg nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License LGPL as
+ * published by the Free Software Foundation, either version 2.1 of the
+ * License, or (at your option) any later version or the BSD license.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License LGPL and the BSD license for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License LGPL and BSD license along with this program.
+ *
+ ****************************************************************/
+#include <vector>
+#include "youbot_driver/generic/dataobjectlockfree/target.hpp"
+#include "youbot_driver/generic/dataobjectlockfree/os/oro_arch.h"
+#include "youbot_driver/youbot/YouBotSlaveMsg.hpp"
+
+namespace youbot {
+
+///////////////////////////////////////////////////////////////////////////////
+/// Process data of all EtherCAT slaves in two contiguous images which are shared between
+/// the EtherCAT thread and the user threads without locks.
+/// The inputs are double buffered: the EtherCAT thread fills the back image and publishes
+/// it with one atomic increment of the input sequence, whose lowest bit is the index of the front image.
+/// The outputs are written by the user threads at any time, so every slave has its own sequence
+/// counter and the EtherCAT thread never waits for a writer but keeps the last complete output.
+///////////////////////////////////////////////////////////////////////////////
+class ProcessDataImage {
+  public:
+    ProcessDataImage(const unsigned int numberOfSlaves);
+
+    ~ProcessDataImage();
+
+    unsigned int getNumberOfSlaves() const;
+
+    ///returns the back image of the inputs which can be filled by the EtherCAT thread
+    ///the image is contiguous and has getNumberOfSlaves() elements
+    SlaveMessageInput* getInputBackImage();
+
+    ///makes the back image the new front image which is read by the user threads
+    ///must only be called by the EtherCAT thread
+    void publishInputs();
+
+    ///copies the last published input of one slave
+    ///@param slaveNumber index of the slave starting with 0
+    ///@param input the input of the slave
+    void getInput(const unsigned int slaveNumber, SlaveMessageInput& input) const;
+
+    ///copies the last published inputs of all slaves from the same cycle
+    ///@param inputs the inputs of all slaves
+    ///returns the number of published cycles
+    unsigned int getInputs(std::vector<SlaveMessageInput>& inputs) const;
+
+    ///stores the output of one slave, waits only for other user threads which write to the same slave
+    ///@param slaveNumber index of the slave starting with 0
+    ///@param output output for the slave
+    void setOutput(const unsigned int slaveNumber, const SlaveMessageOutput& output);
+
+    ///stores the output of one slave if no other thread writes to it at the same time, never waits
+    ///returns false if the output has not been stored
+    bool trySetOutput(const unsigned int slaveNumber, const SlaveMessageOutput& output);
+
+    ///copies the last stored output of one slave
+    void getOutput(const unsigned int slaveNumber, SlaveMessageOutput& output) const;
+
+    ///copies the last stored output of one slave if no thread writes to it at the same time, never waits
+    ///returns false if output has not been changed
+    bool tryGetOutput(const unsigned int slaveNumber, SlaveMessageOutput& output) const;
+
+
+  private:
+    ProcessDataImage(const ProcessDataImage & source);
+
+    ProcessDataImage & operator=(const ProcessDataImage & source);
+
+    ///output of one slave with its sequence counter, the counter is odd while the output is written
+    struct OutputSlot {
+      volatile int sequence;
+      SlaveMessageOutput output;
+    };
+
+    unsigned int numberOfSlaves;
+
+    ///front and back image of the inputs one after the other
+    std::vector<SlaveMessageInput> inputImages;
+
+    mutable oro_atomic_t inputSequence;
+
+    std::vector<OutputSlot> outputImage;
+
+};
+
+} // namespace youbot
+#endif
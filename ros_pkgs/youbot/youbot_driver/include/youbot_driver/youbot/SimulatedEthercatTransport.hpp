@@ -0,0 +1,190 @@
+#ifndef YOUBOT_SIMULATEDETHERCATTRANSPORT_H
+#define YOUBOT_SIMULATEDETHERCATTRANSPORT_H
+
+/****************************************************************
+ *
+ * Copyright (c) 2011
+ * All rights reserved.
+ *
+ * Hochschule Bonn-Rhein-Sieg
+ * University of Applied Sciences
+ * Computer Science Department
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Author:
+ * Jan Paulus, Nico Hochgeschwender, Michael Reckhaus, Azamat Shakhimardanov
+ * Supervised by:
+ * Gerhard K. Kraetzschmar
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * This sofware is published under a dual-license: GNU Lesser General Public 
+ * License LGPL 2.1 and BSD license. The dual-license implies that users of this
+ * code may choose which terms they prefer.
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Hochschule Bonn-Rhein-Sieg nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License LGPL as
+ * published by the Free Software Foundation, either version 2.1 of the
+ * License, or (at your option) any later version or the BSD license.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License LGPL and the BSD license for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License LGPL and BSD license along with this program.
+ *
+ ****************************************************************/
+#include <vector>
+#include <map>
+#include <string>
+#include "youbot_driver/youbot/EthercatTransport.hpp"
+#include "youbot_driver/youbot/YouBotSlaveMsg.hpp"
+
+namespace youbot {
+
+///////////////////////////////////////////////////////////////////////////////
+/// In-process model of one youBot motor controller
+/// It has the process data layout of the youBot slaves, an encoder, a simple motor model
+/// and answers TMCL mailbox messages.
+///////////////////////////////////////////////////////////////////////////////
+class SimulatedYouBotSlave {
+  public:
+    ///@param name EtherCAT name of the slave
+    ///@param controllerType controller type which is reported in the firmware version
+    SimulatedYouBotSlave(const std::string& name, const int controllerType);
+
+    virtual ~SimulatedYouBotSlave();
+
+    const std::string& getName() const;
+
+    ///advances the motor model by timeStep seconds with the last received process data output
+    void update(const SlaveMessageOutput& output, const double timeStep);
+
+    const SlaveMessageInput& getInput() const;
+
+    ///processes a mailbox request and stores the reply
+    void handleMailboxRequest(const ec_mbxbuft& request);
+
+    ///returns false if there is no reply
+    bool getMailboxReply(ec_mbxbuft& reply);
+
+
+  private:
+    int32 getAxisParameter(const int key) const;
+
+    std::string name;
+
+    int controllerType;
+
+    SlaveMessageInput input;
+
+    ///velocity command of the last position or velocity mode in rpm
+    double commandedVelocity;
+
+    ///in encoder ticks
+    double position;
+
+    ///in rpm of the motor axis
+    double velocity;
+
+    ///in mA
+    double current;
+
+    std::map<int, int32> axisParameters;
+
+    std::map<int, int32> globalParameters;
+
+    ec_mbxbuft mailboxReply;
+
+    bool mailboxReplyAvailable;
+
+    ///encoder ticks per revolution of the motor axis
+    double encoderTicksPerRound;
+
+    ///time constant of the velocity loop in seconds
+    double velocityTimeConstant;
+
+    ///rpm per encoder tick of position error
+    double positionGain;
+
+    ///acceleration in rpm/s per mA
+    double currentToAcceleration;
+
+    ///mA per rpm/s
+    double accelerationToCurrent;
+
+    ///mA per rpm
+    double viscousFriction;
+
+};
+
+///////////////////////////////////////////////////////////////////////////////
+/// Transport to simulated youBot slaves without a network interface
+/// The slaves are updated with the time which has elapsed since the last receive of the process data.
+///////////////////////////////////////////////////////////////////////////////
+class SimulatedEthercatTransport : public EthercatTransport {
+  public:
+    ///@param baseJoints number of simulated base motor controllers
+    ///@param manipulatorJoints number of simulated manipulator motor controllers
+    SimulatedEthercatTransport(const unsigned int baseJoints, const unsigned int manipulatorJoints);
+
+    virtual ~SimulatedEthercatTransport();
+
+    virtual int init(const std::string& ethernetDevice);
+
+    virtual int config(void* ioMap);
+
+    virtual uint16 stateCheck(const uint16 slave, const uint16 requestedState, const int timeout);
+
+    virtual int readState();
+
+    virtual int writeState(const uint16 slave);
+
+    virtual int sendProcessData();
+
+    virtual int receiveProcessData(const int timeout);
+
+    virtual int mailboxSend(const uint16 slave, ec_mbxbuft* mailbox, const int timeout);
+
+    virtual int mailboxReceive(const uint16 slave, ec_mbxbuft* mailbox, const int timeout);
+
+    virtual bool isError();
+
+    virtual void close();
+
+
+  private:
+    std::vector<SimulatedYouBotSlave*> slaves;
+
+    ///process data outputs which have been sent to the slaves
+    std::vector<SlaveMessageOutput> sentOutputs;
+
+    std::vector<SlaveMessageOutput*> outputs;
+
+    std::vector<SlaveMessageInput*> inputs;
+
+    long long lastUpdate;
+
+    bool dataSent;
+
+};
+
+} // namespace youbot
+#endif
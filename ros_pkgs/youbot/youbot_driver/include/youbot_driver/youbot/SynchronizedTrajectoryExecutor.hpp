@@ -0,0 +1,203 @@
+#ifndef YOUBOT_SYNCHRONIZEDTRAJECTORYEXECUTOR_H
+#define YOUBOT_SYNCHRONIZEDTRAJECTORYEXECUTOR_H
+
+/****************************************************************
+ *
+ * Copyright (c) 2011
+ * All rights reserved.
+ *
+ * Hochschule Bonn-Rhein-Sieg
+ * University of Applied Sciences
+ * Computer Science Department
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Author:
+ * Jan Paulus, Nico Hochgeschwender, Michael Reckhaus, Azamat Shakhimardanov
+ * Supervised by:
+ * Gerhard K. Kraetzschmar
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * This sofware is published under a dual-license: GNU Lesser General Public 
+ * License LGPL 2.1 and BSD license. The dual-license implies that users of this
+ * code may choose which terms they prefer.
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Hochschule Bonn-Rhein-Sieg nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License LGPL as
+ * published by the Free Software Foundation, either version 2.1 of the
+ * License, or (at your option) any later version or the BSD license.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License LGPL and the BSD license for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License LGPL and BSD license along with this program.
+ *
+ ****************************************************************/
+#include <vector>
+#include <string>
+#include <sstream>
+#include <stdexcept>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread.hpp>
+#include "youbot_driver/generic/Logger.hpp"
+#include "youbot_driver/generic/Units.hpp"
+#include "youbot_driver/generic/Time.hpp"
+#include "youbot_driver/generic/PidController.hpp"
+#include "youbot_driver/generic-joint/JointTrajectory.hpp"
+#include "youbot_driver/generic-joint/JointData.hpp"
+#include "youbot_driver/youbot/ProtocolDefinitions.hpp"
+#include "youbot_driver/youbot/YouBotSlaveMsg.hpp"
+#include "youbot_driver/generic/dataobjectlockfree/DataObjectLockFree.hpp"
+
+namespace youbot {
+
+/// Setpoints of all joints of a synchronized trajectory from the same EtherCAT cycle
+struct SynchronizedTrajectorySetpoints
+{
+  static const unsigned int MAXIMUM_NUMBER_OF_JOINTS = 8;
+
+  uint32 cycle;
+  double position[MAXIMUM_NUMBER_OF_JOINTS];
+  double velocity[MAXIMUM_NUMBER_OF_JOINTS];
+  double acceleration[MAXIMUM_NUMBER_OF_JOINTS];
+};
+
+///////////////////////////////////////////////////////////////////////////////
+/// Executes one trajectory for several joints, e.g. all joints of a manipulator.
+/// The trajectory is time parameterised once when it is set and is stepped once per EtherCAT cycle
+/// with the cycle counter of the EtherCAT thread as time base, so all joints are sampled at the same
+/// time and their velocity setpoints are sent in the same cycle.
+/// Cycles which have been skipped by the EtherCAT thread stretch the trajectory instead of jumping.
+///////////////////////////////////////////////////////////////////////////////
+class SynchronizedTrajectoryExecutor {
+  public:
+    SynchronizedTrajectoryExecutor();
+
+    virtual ~SynchronizedTrajectoryExecutor();
+
+
+  private:
+    SynchronizedTrajectoryExecutor(const SynchronizedTrajectoryExecutor & source);
+
+    SynchronizedTrajectoryExecutor & operator=(const SynchronizedTrajectoryExecutor & source);
+
+
+  public:
+    ///adds a joint, the joints have to be added in the order of the values in the trajectory points
+    ///@param jointNumber joint number of the joint in the EtherCAT master
+    void addJoint(const unsigned int jointNumber, const int encoderTicksPerRound, const double gearRatio, const bool inverseDirection);
+
+    unsigned int getNumberOfJoints();
+
+    void setConfigurationParameter(const unsigned int jointIndex, const double PParameter, const double IParameter, const double DParameter, const double IClippingMax, const double IClippingMin);
+
+    ///sets the period of the EtherCAT cycle which is the time base of the trajectory
+    ///@param periodMicroSec period in microseconds
+    void setCyclePeriod(const unsigned int periodMicroSec);
+
+    ///time parameterises the trajectory and starts it in the next EtherCAT cycle
+    ///the first point is reached from the current setpoint or, if no trajectory is active, from the actual position
+    void setTrajectory(const MultiJointTrajectory& trajectory);
+
+    void cancelCurrentTrajectory();
+
+    bool isTrajectoryActive();
+
+    ///gets the target positions of all joints from the last cycle
+    void getLastTargetPositions(std::vector<JointAngleSetpoint>& positions);
+
+    ///gets the target velocities of all joints from the last cycle
+    void getLastTargetVelocities(std::vector<JointVelocitySetpoint>& velocities);
+
+    ///calculates the velocity setpoints of all joints, called by the EtherCAT thread once per cycle
+    ///@param cycle cycle counter of the EtherCAT thread
+    ///@param actual process data inputs of all slaves
+    ///@param velocity outputs of all slaves, only the slaves of the joints are written
+    ///@param update set to true for the slaves of the joints if they got a new output
+    void updateTrajectoryExecutor(const uint32 cycle, const std::vector<SlaveMessageInput*>& actual, std::vector<SlaveMessageOutput>& velocity, std::vector<bool>& update);
+
+
+  private:
+    /// Time parameterised trajectory, the first segment starts at the state of the joints when the trajectory is started
+    struct Table {
+      unsigned int generation;
+
+      /// cycles from the start of the trajectory till the end of each segment
+      std::vector<uint32> endCycles;
+
+      /// position, velocity and acceleration at the end of each segment for each joint
+      std::vector<double> targets;
+
+      /// quintic spline coefficients of each segment for each joint, the first segment is calculated at the start
+      std::vector<double> coefficients;
+
+    };
+
+    struct Joint {
+      unsigned int slaveIndex;
+
+      int encoderTicksPerRound;
+
+      double gearRatio;
+
+      bool inverseDirection;
+
+      PidController pid;
+
+    };
+
+    static void getQuinticSplineCoefficients(const double start_pos, const double start_vel, const double start_acc, const double end_pos, const double end_vel, const double end_acc, const double time, double* coefficients);
+
+    void stopJoints(std::vector<SlaveMessageOutput>& velocity, std::vector<bool>& update);
+
+    std::vector<Joint> joints;
+
+    unsigned int cyclePeriod;
+
+    DataObjectLockFree< boost::shared_ptr<const Table> > current_table_box_;
+
+    boost::mutex setTrajectoryMutex;
+
+    volatile unsigned int requestedGeneration;
+
+    volatile unsigned int finishedGeneration;
+
+    /// members below are only used by the EtherCAT thread
+    boost::shared_ptr<const Table> active_table_;
+
+    std::vector<double> firstSegmentCoefficients;
+
+    uint32 startCycle;
+
+    uint32 lastCycle;
+
+    unsigned int segmentCursor;
+
+    bool isRunning;
+
+    SynchronizedTrajectorySetpoints setpoints;
+
+    DataObjectLockFree<SynchronizedTrajectorySetpoints> setpointsBox;
+
+};
+
+} // namespace youbot
+#endif
@@ -58,6 +58,7 @@
 #include "youbot_driver/youbot/YouBotJoint.hpp"
 #include "youbot_driver/youbot/EthercatMasterInterface.hpp"
 #include "youbot_driver/youbot/EthercatMasterWithThread.hpp"
+#include "youbot_driver/youbot/SynchronizedTrajectoryExecutor.hpp"
 #include <boost/ptr_container/ptr_vector.hpp>
 #include <boost/scoped_ptr.hpp>
 namespace youbot {
@@ -87,6 +88,10 @@ class YouBotManipulator {
 
     YouBotGripper& getArmGripper();
 
+    ///returns the executor which moves all arm joints synchronously along one trajectory
+    ///it is only available if the EtherCAT master runs with a thread
+    SynchronizedTrajectoryExecutor& getTrajectoryExecutor();
+
     ///commands positions or angles to all manipulator joints
     ///all positions will be set at the same time
     ///@param JointData the to command positions
@@ -149,6 +154,8 @@ class YouBotManipulator {
 
     boost::scoped_ptr<YouBotGripper> gripper;
 
+    boost::scoped_ptr<SynchronizedTrajectoryExecutor> trajectoryExecutor;
+
     int controllerType;
 
     EthercatMasterInterface& ethercatMaster;
@@ -0,0 +1,198 @@
+/////////////////////////////////////////////////
+// Measures the execution time of the EtherCAT thread per cycle with simulated slaves
+// for different numbers of slaves and with the limit monitors, the trajectory controllers
+// and the binary data trace enabled one after another
+/////////////////////////////////////////////////
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <cmath>
+#include <cstdlib>
+#include "boost/filesystem.hpp"
+#include <boost/ptr_container/ptr_vector.hpp>
+#include "youbot_driver/generic/Logger.hpp"
+#include "youbot_driver/generic/PeriodicTimer.hpp"
+#include "youbot_driver/youbot/EthercatMaster.hpp"
+#include "youbot_driver/youbot/EthercatMasterWithThread.hpp"
+#include "youbot_driver/youbot/YouBotJoint.hpp"
+#include "youbot_driver/youbot/JointLimitMonitor.hpp"
+#include "youbot_driver/youbot/JointTrajectoryController.hpp"
+#include "youbot_driver/youbot/BinaryDataTrace.hpp"
+
+using namespace youbot;
+
+enum BenchmarkFeature {
+  PROCESS_DATA_ONLY,
+  LIMIT_MONITOR,
+  TRAJECTORY_CONTROLLER,
+  BINARY_DATA_TRACE
+};
+
+static const char* featureNames[] = {"process data", "limit monitor", "trajectory controller", "binary trace"};
+
+void writeConfigFile(const std::string& path, const unsigned int numberOfSlaves, const unsigned int period) {
+  std::ofstream file((path + "youbot-ethercat.cfg").c_str());
+  file << "[EtherCAT]" << std::endl;
+  file << "EthernetDevice = simulation" << std::endl;
+  file << "EtherCATUpdateRate_[usec] = " << period << std::endl;
+  file << "EtherCATTimeout_[usec] = 500" << std::endl;
+  file << "MaximumNumberOfEtherCATErrors = 100" << std::endl;
+  file << "MailboxTimeout_[usec] = 200" << std::endl;
+  file << "Transport = Simulation" << std::endl;
+  file << "SimulatedBaseJoints = " << numberOfSlaves << std::endl;
+  file << "SimulatedManipulatorJoints = 0" << std::endl;
+  file << "BaseJointControllerName = TMCM-174" << std::endl;
+  file << "BaseJointControllerNameAlternative = TMCM-1632" << std::endl;
+  file << "ManipulatorJointControllerName = TMCM-KR-841" << std::endl;
+  file << "ManipulatorJointControllerNameAlternative = TMCM-1610" << std::endl;
+}
+
+void runBenchmark(const std::string& path, const unsigned int numberOfSlaves, const BenchmarkFeature feature, const unsigned int durationMilliSec) {
+  EthercatMasterWithThread* master = static_cast<EthercatMasterWithThread*>(&(EthercatMaster::getInstance("youbot-ethercat.cfg", path, true)));
+
+  boost::ptr_vector<YouBotJoint> joints;
+  std::vector<JointLimitMonitor*> monitors;
+  std::vector<JointTrajectoryController*> controllers;
+  BinaryDataTrace* trace = NULL;
+
+  for (unsigned int i = 1; i <= numberOfSlaves; i++) {
+    YouBotJoint* joint = new YouBotJoint(i, path);
+    GearRatio gearRatio;
+    gearRatio.setParameter(1.0 / 156.0);
+    joint->setConfigurationParameter(gearRatio);
+    EncoderTicksPerRound ticks;
+    ticks.setParameter(4000);
+    joint->setConfigurationParameter(ticks);
+    TorqueConstant torqueConstant;
+    torqueConstant.setParameter(0.0335);
+    joint->setConfigurationParameter(torqueConstant);
+    joints.push_back(joint);
+  }
+
+  switch (feature) {
+    case LIMIT_MONITOR:
+      for (unsigned int i = 0; i < numberOfSlaves; i++) {
+        YouBotJointStorage storage;
+        storage.jointNumber = i + 1;
+        storage.encoderTicksPerRound = 4000;
+        storage.gearRatio = 1.0 / 156.0;
+        storage.inverseMovementDirection = false;
+        storage.lowerLimit = -100000;
+        storage.upperLimit = 100000;
+        storage.areLimitsActive = true;
+        storage.torqueConstant = 0;
+        monitors.push_back(new JointLimitMonitor(storage, 1.0 * radian_per_second / second));
+        master->registerJointLimitMonitor(monitors.back(), i + 1);
+        joints[i].setData(JointRoundsPerMinuteSetpoint(1000));
+      }
+      break;
+    case TRAJECTORY_CONTROLLER:
+      for (unsigned int i = 0; i < numberOfSlaves; i++) {
+        JointTrajectory trajectory;
+        for (unsigned int s = 0; s <= 1000; s++) {
+          TrajectorySegment segment;
+          double t = s * 0.01;
+          segment.positions = std::sin(t) * radian;
+          segment.velocities = std::cos(t) * radian_per_second;
+          segment.accelerations = -std::sin(t) * radian_per_second / second;
+          segment.time_from_start = boost::posix_time::milliseconds(s * 10);
+          trajectory.segments.push_back(segment);
+        }
+        trajectory.start_time = boost::posix_time::microsec_clock::local_time();
+        JointTrajectoryController* controller = new JointTrajectoryController();
+        controller->setConfigurationParameter(1000, 0, 0, 1000, -1000);
+        controller->setGearRatio(1.0 / 156.0);
+        controller->setEncoderTicksPerRound(4000);
+        controller->setInverseMovementDirection(false);
+        controller->setTrajectory(trajectory);
+        controllers.push_back(controller);
+        master->registerJointTrajectoryController(controller, i + 1);
+      }
+      break;
+    case BINARY_DATA_TRACE:
+      trace = new BinaryDataTrace(path + "benchmark.trace");
+      for (unsigned int i = 0; i < numberOfSlaves; i++) {
+        trace->addJoint(joints[i]);
+      }
+      trace->startTrace();
+      break;
+    default:
+      break;
+  }
+
+  // let the first cycles pass before the measurement starts
+  SLEEP_MILLISEC(100);
+  master->resetCycleStatistics();
+  SLEEP_MILLISEC(durationMilliSec);
+
+  std::vector<ec_slavet> slaveInfos;
+  PeriodicTimerStatistics statistics;
+  master->getEthercatDiagnosticInformation(slaveInfos, statistics);
+
+  std::cout << std::setw(8) << numberOfSlaves
+          << std::setw(24) << featureNames[feature]
+          << std::setw(10) << statistics.cycles
+          << std::setw(14) << std::fixed << std::setprecision(2) << statistics.meanExecutionTime
+          << std::setw(14) << statistics.maxExecutionTime
+          << std::setw(14) << std::setprecision(2) << statistics.meanExecutionTime / numberOfSlaves
+          << std::setw(12) << statistics.maxLatency
+          << std::setw(10) << statistics.overruns << std::endl;
+
+  if (trace != NULL) {
+    trace->stopTrace();
+    delete trace;
+  }
+  for (unsigned int i = 0; i < controllers.size(); i++) {
+    master->deleteJointTrajectoryControllerRegistration(i + 1);
+  }
+  // stops the EtherCAT thread, afterwards the limit monitors and controllers are not used anymore
+  EthercatMaster::destroy();
+
+  for (unsigned int i = 0; i < controllers.size(); i++) {
+    delete controllers[i];
+  }
+  for (unsigned int i = 0; i < monitors.size(); i++) {
+    delete monitors[i];
+  }
+  // the joints are released by the ptr_vector
+}
+
+int main(int argc, char *argv[]) {
+
+  unsigned int durationMilliSec = 2000;
+  unsigned int period = 1000;
+  if (argc > 1)
+    durationMilliSec = atoi(argv[1]);
+  if (argc > 2)
+    period = atoi(argv[2]);
+
+  Logger::logginLevel = warning;
+
+  std::string path = (boost::filesystem::temp_directory_path() / "youbot_ethercat_benchmark/").string();
+  boost::filesystem::create_directories(boost::filesystem::path(path));
+
+  unsigned int slaveCounts[] = {1, 2, 4, 8, 16, 32};
+
+  std::cout << "EtherCAT thread with simulated slaves, period " << period << "us, " << durationMilliSec << "ms per run" << std::endl;
+  std::cout << std::setw(8) << "slaves" << std::setw(24) << "feature" << std::setw(10) << "cycles"
+          << std::setw(14) << "mean [us]" << std::setw(14) << "max [us]" << std::setw(14) << "mean/slave"
+          << std::setw(12) << "latency" << std::setw(10) << "overruns" << std::endl;
+
+  try {
+    for (unsigned int s = 0; s < sizeof(slaveCounts) / sizeof(slaveCounts[0]); s++) {
+      writeConfigFile(path, slaveCounts[s], period);
+      for (int f = PROCESS_DATA_ONLY; f <= BINARY_DATA_TRACE; f++) {
+        runBenchmark(path, slaveCounts[s], (BenchmarkFeature) f, durationMilliSec);
+      }
+    }
+  } catch (std::exception& e) {
+    std::cout << e.what() << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,216 @@
+/****************************************************************
+ *
+ * Copyright (c) 2011
+ * All rights reserved.
+ *
+ * Hochschule Bonn-Rhein-Sieg
+ * University of Applied Sciences
+ * Computer Science Department
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Author:
+ * Jan Paulus, Nico Hochgeschwender, Michael Reckhaus, Azamat Shakhimardanov
+ * Supervised by:
+ * Gerhard K. Kraetzschmar
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * This sofware is published under a dual-license: GNU Lesser General Public 
+ * License LGPL 2.1 and BSD license. The dual-license implies that users of this
+ * code may choose which terms they prefer.
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Hochschule Bonn-Rhein-Sieg nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License LGPL as
+ * published by the Free Software Foundation, either version 2.1 of the
+ * License, or (at your option) any later version or the BSD license.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License LGPL and the BSD license for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License LGPL and BSD license along with this program.
+ *
+ ****************************************************************/
+#ifdef WIN32
+#include <boost/thread.hpp>
+#include <boost/chrono.hpp>
+#else
+#include <time.h>
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#endif
+#include "youbot_driver/generic/Logger.hpp"
+#include "youbot_driver/generic/PeriodicTimer.hpp"
+
+namespace youbot {
+
+PeriodicTimerStatistics::PeriodicTimerStatistics() {
+  histogramBinWidth = 10;
+  this->reset();
+}
+
+void PeriodicTimerStatistics::reset() {
+  cycles = 0;
+  overruns = 0;
+  minLatency = 0;
+  maxLatency = 0;
+  meanLatency = 0;
+  meanExecutionTime = 0;
+  maxExecutionTime = 0;
+  for (unsigned int i = 0; i < HISTOGRAM_SIZE; i++) {
+    latencyHistogram[i] = 0;
+  }
+}
+
+PeriodicTimer::PeriodicTimer(const unsigned int periodMicroSec, const unsigned int histogramBinWidthMicroSec) {
+  period = periodMicroSec > 0 ? periodMicroSec : 1;
+  nextDeadline = 0;
+  latencySum = 0;
+  executionTimeSum = 0;
+  lastWakeUp = 0;
+  statistics.histogramBinWidth = histogramBinWidthMicroSec > 0 ? histogramBinWidthMicroSec : 1;
+}
+
+PeriodicTimer::~PeriodicTimer() {
+}
+
+///sets the first deadline to one period from now
+void PeriodicTimer::start() {
+  nextDeadline = getMonotonicTimeMicroSec() + period;
+}
+
+///sleeps until the next deadline and updates the statistics
+void PeriodicTimer::waitForNextPeriod() {
+  long long now = getMonotonicTimeMicroSec();
+
+  if (statistics.cycles > 0) {
+    long executionTime = (long) (now - lastWakeUp);
+    if (executionTime > statistics.maxExecutionTime)
+      statistics.maxExecutionTime = executionTime;
+    executionTimeSum += executionTime;
+    statistics.meanExecutionTime = executionTimeSum / statistics.cycles;
+  }
+
+  if (now > nextDeadline) {
+    // the cycle took longer than the period, skip the missed deadlines but keep the phase
+    long long missed = (now - nextDeadline) / period + 1;
+    statistics.overruns += missed;
+    nextDeadline += missed * period;
+  }
+
+  this->sleepUntil(nextDeadline);
+
+  lastWakeUp = getMonotonicTimeMicroSec();
+  long latency = (long) (lastWakeUp - nextDeadline);
+  nextDeadline += period;
+
+  if (statistics.cycles == 0 || latency < statistics.minLatency)
+    statistics.minLatency = latency;
+  if (statistics.cycles == 0 || latency > statistics.maxLatency)
+    statistics.maxLatency = latency;
+  statistics.cycles++;
+  latencySum += latency;
+  statistics.meanLatency = latencySum / statistics.cycles;
+
+  unsigned int bin = latency > 0 ? latency / statistics.histogramBinWidth : 0;
+  if (bin >= PeriodicTimerStatistics::HISTOGRAM_SIZE)
+    bin = PeriodicTimerStatistics::HISTOGRAM_SIZE - 1;
+  statistics.latencyHistogram[bin]++;
+}
+
+const PeriodicTimerStatistics& PeriodicTimer::getStatistics() const {
+  return statistics;
+}
+
+void PeriodicTimer::resetStatistics() {
+  statistics.reset();
+  latencySum = 0;
+  executionTimeSum = 0;
+}
+
+unsigned int PeriodicTimer::getPeriod() const {
+  return period;
+}
+
+///returns the time of a monotonic clock in microseconds
+long long PeriodicTimer::getMonotonicTimeMicroSec() {
+#ifdef WIN32
+  return boost::chrono::duration_cast<boost::chrono::microseconds>(boost::chrono::steady_clock::now().time_since_epoch()).count();
+#else
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (long long) ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+#endif
+}
+
+///switches the calling thread to the SCHED_FIFO scheduler with the given priority
+///returns false if the priority could not be set e.g. because of missing permissions
+bool PeriodicTimer::setRealtimePriority(const int priority) {
+#ifdef WIN32
+  LOG(warning) << "Real-time priorities are not supported on this platform";
+  return false;
+#else
+  struct sched_param param;
+  param.sched_priority = priority;
+  int error = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+  if (error != 0) {
+    LOG(warning) << "Could not set the SCHED_FIFO priority " << priority << " (error " << error << ")";
+    return false;
+  }
+  return true;
+#endif
+}
+
+///pins the calling thread to one CPU
+///returns false if the affinity could not be set
+bool PeriodicTimer::setCpuAffinity(const int cpu) {
+#if defined(WIN32) || !defined(__linux__)
+  LOG(warning) << "Setting the CPU affinity is not supported on this platform";
+  return false;
+#else
+  cpu_set_t cpuSet;
+  CPU_ZERO(&cpuSet);
+  CPU_SET(cpu, &cpuSet);
+  int error = pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuSet);
+  if (error != 0) {
+    LOG(warning) << "Could not pin the thread to CPU " << cpu << " (error " << error << ")";
+    return false;
+  }
+  return true;
+#endif
+}
+
+///sleeps until the given absolute time of the monotonic clock
+void PeriodicTimer::sleepUntil(const long long timeMicroSec) {
+#ifdef WIN32
+  long long timeToWait = timeMicroSec - getMonotonicTimeMicroSec();
+  if (timeToWait > 0)
+    boost::this_thread::sleep(boost::posix_time::microseconds(timeToWait));
+#else
+  struct timespec deadline;
+  deadline.tv_sec = timeMicroSec / 1000000;
+  deadline.tv_nsec = (timeMicroSec % 1000000) * 1000;
+  while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, NULL) == EINTR) {
+  }
+#endif
+}
+
+} // namespace youbot
@@ -0,0 +1,132 @@
+#include "youbot_driver/testing/PeriodicTimerTest.hpp"
+
+using namespace youbot;
+
+PeriodicTimerTest::PeriodicTimerTest() {
+
+}
+
+PeriodicTimerTest::~PeriodicTimerTest() {
+
+}
+
+void PeriodicTimerTest::setUp() {
+  period = 1000;
+  cycles = 3000;
+  busCycleDuration = 200;
+  stopLoad = false;
+}
+
+void PeriodicTimerTest::tearDown() {
+
+}
+
+void PeriodicTimerTest::periodicTimerNoDriftTest() {
+
+  std::cout << std::endl << __func__ << std::endl;
+  PeriodicTimer timer(period);
+
+  timer.start();
+  long long startTime = PeriodicTimer::getMonotonicTimeMicroSec();
+  for (unsigned int i = 0; i < cycles; i++) {
+    timer.waitForNextPeriod();
+    simulateBusCycle(busCycleDuration);
+  }
+  long long duration = PeriodicTimer::getMonotonicTimeMicroSec() - startTime;
+  const PeriodicTimerStatistics& statistics = timer.getStatistics();
+  printStatistics(statistics);
+
+  CPPUNIT_ASSERT_EQUAL((unsigned long) cycles, statistics.cycles);
+  // the deadlines are absolute, so the duration only depends on the number of periods
+  long long expectedDuration = (long long) (cycles + statistics.overruns) * period;
+  CPPUNIT_ASSERT(duration >= expectedDuration - (long long) period);
+  CPPUNIT_ASSERT(duration <= expectedDuration + (long long) period + busCycleDuration + statistics.maxLatency);
+}
+
+void PeriodicTimerTest::periodicTimerJitterUnderLoadTest() {
+
+  std::cout << std::endl << __func__ << std::endl;
+  boost::thread_group loadThreads;
+  unsigned int numberOfLoadThreads = boost::thread::hardware_concurrency();
+  if (numberOfLoadThreads == 0)
+    numberOfLoadThreads = 1;
+  for (unsigned int i = 0; i < numberOfLoadThreads; i++) {
+    loadThreads.create_thread(boost::bind(&PeriodicTimerTest::generateLoad, this));
+  }
+
+  // the timed loop gets its own thread, so the real-time settings do not stay on the test runner
+  PeriodicTimerStatistics statistics;
+  boost::thread timedThread(boost::bind(&PeriodicTimerTest::runRealtimeCycles, this, &statistics));
+  timedThread.join();
+  stopLoad = true;
+  loadThreads.join_all();
+
+  std::cout << numberOfLoadThreads << " load threads" << std::endl;
+  printStatistics(statistics);
+
+  CPPUNIT_ASSERT_EQUAL((unsigned long) cycles, statistics.cycles);
+  CPPUNIT_ASSERT(statistics.minLatency >= 0);
+  CPPUNIT_ASSERT(statistics.maxLatency >= statistics.minLatency);
+}
+
+void PeriodicTimerTest::periodicTimerOverrunTest() {
+
+  std::cout << std::endl << __func__ << std::endl;
+  PeriodicTimer timer(period);
+
+  timer.start();
+  timer.waitForNextPeriod();
+  // one cycle which takes two and a half periods
+  simulateBusCycle(period * 5 / 2);
+  timer.waitForNextPeriod();
+
+  const PeriodicTimerStatistics& statistics = timer.getStatistics();
+  printStatistics(statistics);
+  CPPUNIT_ASSERT_EQUAL((unsigned long) 2, statistics.cycles);
+  CPPUNIT_ASSERT(statistics.overruns >= 2);
+
+  timer.resetStatistics();
+  CPPUNIT_ASSERT_EQUAL((unsigned long) 0, timer.getStatistics().cycles);
+  CPPUNIT_ASSERT_EQUAL((unsigned long) 0, timer.getStatistics().overruns);
+}
+
+void PeriodicTimerTest::runRealtimeCycles(PeriodicTimerStatistics* statistics) {
+  // the same settings the EtherCAT thread uses when they are configured
+  PeriodicTimer::setRealtimePriority(80);
+  PeriodicTimer::setCpuAffinity(0);
+
+  PeriodicTimer timer(period);
+  timer.start();
+  for (unsigned int i = 0; i < cycles; i++) {
+    timer.waitForNextPeriod();
+    simulateBusCycle(busCycleDuration);
+  }
+  *statistics = timer.getStatistics();
+}
+
+void PeriodicTimerTest::simulateBusCycle(const long durationMicroSec) {
+  long long end = PeriodicTimer::getMonotonicTimeMicroSec() + durationMicroSec;
+  while (PeriodicTimer::getMonotonicTimeMicroSec() < end) {
+  }
+}
+
+void PeriodicTimerTest::generateLoad() {
+  volatile double dummy = 0;
+  while (!stopLoad) {
+    dummy = dummy + 1.0;
+  }
+}
+
+void PeriodicTimerTest::printStatistics(const PeriodicTimerStatistics& statistics) {
+  std::cout << "cycles: " << statistics.cycles << " overruns: " << statistics.overruns
+          << " latency min: " << statistics.minLatency << "us max: " << statistics.maxLatency
+          << "us mean: " << statistics.meanLatency << "us" << std::endl;
+  for (unsigned int i = 0; i < PeriodicTimerStatistics::HISTOGRAM_SIZE; i++) {
+    if (statistics.latencyHistogram[i] == 0)
+      continue;
+    std::cout << "  " << i * statistics.histogramBinWidth << "us";
+    if (i == PeriodicTimerStatistics::HISTOGRAM_SIZE - 1)
+      std::cout << " and more";
+    std::cout << ": " << statistics.latencyHistogram[i] << std::endl;
+  }
+}
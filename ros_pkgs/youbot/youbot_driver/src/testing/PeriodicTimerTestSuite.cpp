@@ -0,0 +1,21 @@
+#include "youbot_driver/testing/PeriodicTimerTest.hpp"
+#include <cppunit/CompilerOutputter.h>
+#include <cppunit/extensions/TestFactoryRegistry.h>
+#include <cppunit/ui/text/TestRunner.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+CPPUNIT_TEST_SUITE_REGISTRATION( PeriodicTimerTest );
+
+int main(int argc, char* argv[]) {
+  Logger::logginLevel = info;
+
+  CppUnit::Test *suite = CppUnit::TestFactoryRegistry::getRegistry().makeTest();
+  CppUnit::TextUi::TestRunner runner;
+  runner.addTest( suite );
+  runner.setOutputter( new CppUnit::CompilerOutputter( &runner.result(), std::cerr ) );
+  /** let the test run */
+  bool wasSucessful = runner.run();
+
+  /** check whether it was sucessfull or not */
+  return wasSucessful ? 0 : 1;
+}
@@ -0,0 +1,26 @@
+/////////////////////////////////////////////////
+// Converts a binary data trace of the EtherCAT master into jointDataTrace files
+// which can be plotted with the gnuplotconfig or imported as CSV
+/////////////////////////////////////////////////
+
+#include <iostream>
+#include <string>
+#include <stdexcept>
+#include "youbot_driver/youbot/BinaryDataTrace.hpp"
+
+int main(int argc, char *argv[]) {
+
+  if (argc < 3 || argc > 4 || (argc == 4 && std::string(argv[3]) != "--csv")) {
+    std::cout << "usage: " << argv[0] << " <binary trace file> <output folder> [--csv]" << std::endl;
+    return 1;
+  }
+
+  try {
+    youbot::BinaryDataTrace::convertToText(argv[1], argv[2], argc == 4);
+  } catch (std::exception& e) {
+    std::cout << e.what() << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
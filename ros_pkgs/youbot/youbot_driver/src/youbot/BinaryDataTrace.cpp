@@ -0,0 +1,410 @@
+/****************************************************************
+ *
+ * Copyright (c) 2011
+ * All rights reserved.
+ *
+ * Hochschule Bonn-Rhein-Sieg
+ * University of Applied Sciences
+ * Computer Science Department
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Author:
+ * Jan Paulus, Nico Hochgeschwender, Michael Reckhaus, Azamat Shakhimardanov
+ * Supervised by:
+ * Gerhard K. Kraetzschmar
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * This sofware is published under a dual-license: GNU Lesser General Public 
+ * License LGPL 2.1 and BSD license. The dual-license implies that users of this
+ * code may choose which terms they prefer.
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Hochschule Bonn-Rhein-Sieg nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License LGPL as
+ * published by the Free Software Foundation, either version 2.1 of the
+ * License, or (at your option) any later version or the BSD license.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License LGPL and the BSD license for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License LGPL and BSD license along with this program.
+ *
+ ****************************************************************/
+#include <cstring>
+#include <cmath>
+#include <limits>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include "boost/filesystem.hpp"
+#include "youbot_driver/youbot/BinaryDataTrace.hpp"
+#include "youbot_driver/youbot/EthercatMaster.hpp"
+#include "youbot_driver/youbot/EthercatMasterWithThread.hpp"
+
+namespace youbot {
+
+static const char binaryDataTraceMagic[8] = {'Y', 'B', 'T', 'R', 'A', 'C', 'E', '1'};
+
+BinaryDataTrace::BinaryDataTrace(const std::string& fileName, const unsigned int bufferSize) {
+  // Bouml preserved body begin 00112A71
+    this->fileName = fileName;
+    this->bufferSize = bufferSize;
+    this->traceActive = false;
+    this->stopWriter = false;
+    writeBuffer.resize(bufferSize > 0 ? bufferSize : 1);
+  // Bouml preserved body end 00112A71
+}
+
+BinaryDataTrace::~BinaryDataTrace() {
+  // Bouml preserved body begin 00112AF1
+    if (traceActive) {
+      try {
+        this->stopTrace();
+      } catch (...) {
+      }
+    }
+    for (unsigned int i = 0; i < buffers.size(); i++) {
+      delete buffers[i];
+    }
+  // Bouml preserved body end 00112AF1
+}
+
+///adds a joint to the trace, all joints have to be added before the trace is started
+void BinaryDataTrace::addJoint(YouBotJoint& joint) {
+  // Bouml preserved body begin 00112B71
+    if (traceActive)
+      throw std::runtime_error("Joints can not be added while the trace is active!");
+
+    BinaryDataTraceJointInfo info;
+    std::memset(&info, 0, sizeof(info));
+
+    info.jointNumber = joint.getJointNumber();
+
+    GearRatio gearRatioParameter;
+    double gearRatio = 0;
+    joint.getConfigurationParameter(gearRatioParameter);
+    gearRatioParameter.getParameter(gearRatio);
+    info.gearRatio = gearRatio;
+
+    EncoderTicksPerRound ticksParameter;
+    unsigned int ticks = 0;
+    joint.getConfigurationParameter(ticksParameter);
+    ticksParameter.getParameter(ticks);
+    info.encoderTicksPerRound = ticks;
+
+    InverseMovementDirection inverseParameter;
+    bool inverted = false;
+    joint.getConfigurationParameter(inverseParameter);
+    inverseParameter.getParameter(inverted);
+    info.inverseMovementDirection = inverted;
+
+    TorqueConstant torqueParameter;
+    double torqueConstant = 0;
+    joint.getConfigurationParameter(torqueParameter);
+    torqueParameter.getParameter(torqueConstant);
+    info.torqueConstant = torqueConstant;
+
+    JointName nameParameter;
+    std::string name;
+    joint.getConfigurationParameter(nameParameter);
+    nameParameter.getParameter(name);
+    std::strncpy(info.name, name.c_str(), sizeof(info.name) - 1);
+
+    if (info.jointNumber == 0)
+      throw std::out_of_range("Invalid joint number");
+
+    if (info.jointNumber > buffers.size())
+      buffers.resize(info.jointNumber, NULL);
+    if (buffers[info.jointNumber - 1] != NULL)
+      throw std::runtime_error("The joint is already part of the trace!");
+
+    buffers[info.jointNumber - 1] = new SpscRingBuffer<BinaryDataTraceRecord>(bufferSize);
+    jointInfos.push_back(info);
+  // Bouml preserved body end 00112B71
+}
+
+///opens the file and registers the trace at the EtherCAT master
+void BinaryDataTrace::startTrace() {
+  // Bouml preserved body begin 00112BF1
+    if (traceActive)
+      return;
+
+    file.open(fileName.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!file.is_open())
+      throw std::runtime_error("could not open the trace file " + fileName);
+
+    uint32 numberOfJoints = jointInfos.size();
+    uint32 recordSize = sizeof(BinaryDataTraceRecord);
+    file.write(binaryDataTraceMagic, sizeof(binaryDataTraceMagic));
+    file.write((const char*) &numberOfJoints, sizeof(numberOfJoints));
+    file.write((const char*) &recordSize, sizeof(recordSize));
+    for (unsigned int i = 0; i < jointInfos.size(); i++) {
+      file.write((const char*) &jointInfos[i], sizeof(BinaryDataTraceJointInfo));
+    }
+
+    stopWriter = false;
+    writerThread = boost::thread(boost::bind(&BinaryDataTrace::writeRecords, this));
+    traceActive = true;
+
+    EthercatMasterInterface& ethercatMaster = EthercatMaster::getInstance();
+    if (ethercatMaster.isThreadActive()) {
+      static_cast<EthercatMasterWithThread*>(&ethercatMaster)->registerBinaryDataTrace(this);
+    } else {
+      LOG(warning) << "The binary data trace needs the EtherCAT master with thread!";
+    }
+  // Bouml preserved body end 00112BF1
+}
+
+///removes the registration at the EtherCAT master and writes all outstanding records
+void BinaryDataTrace::stopTrace() {
+  // Bouml preserved body begin 00112C71
+    if (!traceActive)
+      return;
+
+    EthercatMasterInterface& ethercatMaster = EthercatMaster::getInstance();
+    if (ethercatMaster.isThreadActive()) {
+      static_cast<EthercatMasterWithThread*>(&ethercatMaster)->deleteBinaryDataTraceRegistration();
+    }
+    traceActive = false;
+
+    stopWriter = true;
+    writerThread.join();
+    this->flushBuffers();
+    file.close();
+
+    if (this->getNumberOfDroppedRecords() > 0)
+      LOG(warning) << this->getNumberOfDroppedRecords() << " records have been dropped in the binary data trace " << fileName;
+  // Bouml preserved body end 00112C71
+}
+
+bool BinaryDataTrace::isTraceActive() const {
+  // Bouml preserved body begin 00112CF1
+    return traceActive;
+  // Bouml preserved body end 00112CF1
+}
+
+///stores the process data of one joint, it is called by the EtherCAT thread
+///it does not block and does not allocate memory
+void BinaryDataTrace::update(const unsigned int jointNumber, const uint32 cycle, const uint64 timeMicroSec, const SlaveMessageInput& input, const SlaveMessageOutput& output) {
+  // Bouml preserved body begin 00112D71
+    if (jointNumber == 0 || jointNumber > buffers.size() || buffers[jointNumber - 1] == NULL)
+      return;
+
+    BinaryDataTraceRecord record;
+    record.timeMicroSec = timeMicroSec;
+    record.cycle = cycle;
+    record.jointNumber = jointNumber;
+    std::memcpy(&record.input, &input, sizeof(SlaveMessageInput));
+    std::memcpy(&record.output, &output, sizeof(SlaveMessageOutput));
+    buffers[jointNumber - 1]->push(record);
+  // Bouml preserved body end 00112D71
+}
+
+///returns the number of records which have been dropped because the file could not be written fast enough
+unsigned int BinaryDataTrace::getNumberOfDroppedRecords() const {
+  // Bouml preserved body begin 00112DF1
+    unsigned int dropped = 0;
+    for (unsigned int i = 0; i < buffers.size(); i++) {
+      if (buffers[i] != NULL)
+        dropped += buffers[i]->getNumberOfDroppedElements();
+    }
+    return dropped;
+  // Bouml preserved body end 00112DF1
+}
+
+///converts a binary trace file into one jointDataTrace file per joint in the folder outputFolder/joint<N>/
+///the columns are the same as the ones of the DataTrace
+///@param binaryFileName name of the binary trace file
+///@param outputFolder folder for the text files
+///@param csv use comma separated values instead of the gnuplot format
+void BinaryDataTrace::convertToText(const std::string& binaryFileName, const std::string& outputFolder, const bool csv) {
+  // Bouml preserved body begin 00112E71
+    std::ifstream input(binaryFileName.c_str(), std::ios::in | std::ios::binary);
+    if (!input.is_open())
+      throw std::runtime_error("could not open the trace file " + binaryFileName);
+
+    char magic[sizeof(binaryDataTraceMagic)];
+    uint32 numberOfJoints = 0;
+    uint32 recordSize = 0;
+    input.read(magic, sizeof(magic));
+    input.read((char*) &numberOfJoints, sizeof(numberOfJoints));
+    input.read((char*) &recordSize, sizeof(recordSize));
+    if (!input || std::memcmp(magic, binaryDataTraceMagic, sizeof(magic)) != 0)
+      throw std::runtime_error(binaryFileName + " is not a binary data trace");
+    if (recordSize != sizeof(BinaryDataTraceRecord))
+      throw std::runtime_error(binaryFileName + " has been recorded with an incompatible record layout");
+
+    std::vector<BinaryDataTraceJointInfo> infos(numberOfJoints);
+    std::map<uint32, unsigned int> jointIndex;
+    std::vector<std::ofstream*> files(numberOfJoints, (std::ofstream*) NULL);
+    const char separator = csv ? ',' : ' ';
+
+    for (unsigned int i = 0; i < numberOfJoints; i++) {
+      input.read((char*) &infos[i], sizeof(BinaryDataTraceJointInfo));
+      if (!input)
+        throw std::runtime_error(binaryFileName + " has a corrupted header");
+      jointIndex[infos[i].jointNumber] = i;
+
+      std::stringstream path;
+      path << outputFolder << "/joint" << infos[i].jointNumber;
+      boost::filesystem::create_directories(boost::filesystem::path(path.str()));
+      path << (csv ? "/jointDataTrace.csv" : "/jointDataTrace");
+
+      files[i] = new std::ofstream(path.str().c_str(), std::ios::out | std::ios::trunc);
+      std::ofstream& out = *files[i];
+      std::string header[] = {"time [milliseconds]", "angle setpoint [rad]", "velocity setpoint [rad/s]", "RPM setpoint",
+        "current setpoint [A]", "torque setpoint [Nm]", "ramp generator setpoint [rad/s]", "encoder setpoint",
+        "sensed angle [rad]", "sensed encoder ticks", "sensed velocity [rad/s]", "sensed RPM",
+        "sensed current [A]", "sensed torque [Nm]", "actual PWM",
+        "OVER_CURRENT", "UNDER_VOLTAGE", "OVER_VOLTAGE", "OVER_TEMPERATURE", "MOTOR_HALTED",
+        "HALL_SENSOR_ERROR", "PWM_MODE_ACTIVE", "VELOCITY_MODE", "POSITION_MODE", "TORQUE_MODE",
+        "POSITION_REACHED", "INITIALIZED", "TIMEOUT", "I2T_EXCEEDED"};
+      if (csv) {
+        for (unsigned int h = 0; h < sizeof(header) / sizeof(header[0]); h++) {
+          out << (h == 0 ? "" : ",") << header[h];
+        }
+        out << std::endl;
+      } else {
+        out << "# Name: " << infos[i].name << std::endl;
+        out << "# Joint: " << infos[i].jointNumber << std::endl;
+        out << "#";
+        for (unsigned int h = 0; h < sizeof(header) / sizeof(header[0]); h++) {
+          out << " " << header[h];
+        }
+        out << std::endl;
+      }
+    }
+
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    bool firstRecord = true;
+    uint64 startTime = 0;
+    BinaryDataTraceRecord record;
+
+    while (input.read((char*) &record, sizeof(record))) {
+      std::map<uint32, unsigned int>::const_iterator it = jointIndex.find(record.jointNumber);
+      if (it == jointIndex.end())
+        continue;
+      if (firstRecord) {
+        startTime = record.timeMicroSec;
+        firstRecord = false;
+      }
+      const BinaryDataTraceJointInfo& info = infos[it->second];
+      std::ofstream& out = *files[it->second];
+
+      double direction = info.inverseMovementDirection ? -1.0 : 1.0;
+      double ticksToRad = 0;
+      if (info.encoderTicksPerRound != 0)
+        ticksToRad = direction * info.gearRatio * 2.0 * M_PI / info.encoderTicksPerRound;
+      double rpmToRadPerSec = direction * info.gearRatio * 2.0 * M_PI / 60.0;
+      double currentToTorque = 0;
+      if (info.gearRatio != 0)
+        currentToTorque = info.torqueConstant / info.gearRatio;
+
+      double angleSet = nan, encoderSet = nan, velSet = nan, rpmSet = nan, currentSet = nan, torqueSet = nan;
+      switch (record.output.controllerMode) {
+        case POSITION_CONTROL:
+          angleSet = record.output.value * ticksToRad;
+          encoderSet = direction * record.output.value;
+          velSet = record.input.targetVelocity * rpmToRadPerSec;
+          currentSet = direction * record.input.targetCurrent / 1000.0;
+          break;
+        case VELOCITY_CONTROL:
+          velSet = record.output.value * rpmToRadPerSec;
+          rpmSet = direction * record.output.value;
+          currentSet = direction * record.input.targetCurrent / 1000.0;
+          break;
+        case CURRENT_MODE:
+          currentSet = direction * record.output.value / 1000.0;
+          torqueSet = currentSet * currentToTorque;
+          break;
+        default:
+          break;
+      }
+      double sensedCurrent = direction * record.input.actualCurrent / 1000.0;
+      uint32 flags = record.input.errorFlags;
+
+      out << (record.timeMicroSec - startTime) / 1000.0 //1
+              << separator << angleSet //2
+              << separator << velSet //3
+              << separator << rpmSet //4
+              << separator << currentSet //5
+              << separator << torqueSet //6
+              << separator << record.input.rampGeneratorVelocity * rpmToRadPerSec //7
+              << separator << encoderSet //8
+              << separator << record.input.actualPosition * ticksToRad //9
+              << separator << direction * record.input.actualPosition //10
+              << separator << record.input.actualVelocity * rpmToRadPerSec //11
+              << separator << direction * record.input.actualVelocity //12
+              << separator << sensedCurrent //13
+              << separator << sensedCurrent * currentToTorque //14
+              << separator << "0" //15  //dummy has been pwm
+              << separator << bool(flags & OVER_CURRENT) //16
+              << separator << bool(flags & UNDER_VOLTAGE) //17
+              << separator << bool(flags & OVER_VOLTAGE) //18
+              << separator << bool(flags & OVER_TEMPERATURE) //19
+              << separator << bool(flags & MOTOR_HALTED) //20
+              << separator << bool(flags & HALL_SENSOR_ERROR) //21
+              << separator << "0" //22 //dummy has been pwm
+              << separator << bool(flags & VELOCITY_MODE) //23
+              << separator << bool(flags & POSITION_MODE) //24
+              << separator << bool(flags & TORQUE_MODE) //25
+              << separator << bool(flags & POSITION_REACHED) //26
+              << separator << bool(flags & INITIALIZED) //27
+              << separator << bool(flags & TIMEOUT) //28
+              << separator << bool(flags & I2T_EXCEEDED) //29
+              << std::endl;
+    }
+
+    for (unsigned int i = 0; i < files.size(); i++) {
+      files[i]->close();
+      delete files[i];
+    }
+  // Bouml preserved body end 00112E71
+}
+
+///writes the buffered records to the file, this method is executed in a separate thread
+void BinaryDataTrace::writeRecords() {
+  // Bouml preserved body begin 00112EF1
+    while (!stopWriter) {
+      if (this->flushBuffers() == 0)
+        boost::this_thread::sleep(boost::posix_time::milliseconds(10));
+    }
+  // Bouml preserved body end 00112EF1
+}
+
+///writes all records which are in the buffers at the moment, returns the number of written records
+unsigned int BinaryDataTrace::flushBuffers() {
+  // Bouml preserved body begin 00112F71
+    unsigned int written = 0;
+    for (unsigned int i = 0; i < buffers.size(); i++) {
+      if (buffers[i] == NULL)
+        continue;
+      unsigned int count = buffers[i]->pop(&writeBuffer[0], writeBuffer.size());
+      if (count > 0) {
+        file.write((const char*) &writeBuffer[0], count * sizeof(BinaryDataTraceRecord));
+        written += count;
+      }
+    }
+    return written;
+  // Bouml preserved body end 00112F71
+}
+
+} // namespace youbot
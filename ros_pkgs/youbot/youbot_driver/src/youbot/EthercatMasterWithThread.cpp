@@ -58,17 +58,35 @@ extern "C" {
 #include "youbot_driver/soem/ethercatdc.h"
 #include "youbot_driver/soem/ethercatprint.h"
 }
+#include <algorithm>
 #include "youbot_driver/youbot/EthercatMasterWithThread.hpp"
 #include "youbot_driver/youbot/DataTrace.hpp"
+#include "youbot_driver/youbot/BinaryDataTrace.hpp"
+#include "youbot_driver/youbot/SynchronizedTrajectoryExecutor.hpp"
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
 
 namespace youbot {
 
+///orders the copy of the registrations against the publication of the pointer
+static inline void registrationMemoryBarrier() {
+#if defined(_MSC_VER)
+  _ReadWriteBarrier();
+#else
+  __sync_synchronize();
+#endif
+}
+
 EthercatMasterWithThread::EthercatMasterWithThread(const std::string& configFile, const std::string& configFilePath) {
   // Bouml preserved body begin 00041171
 
     this->ethercatConnectionEstablished = false;
     ethernetDevice = "eth0";
     timeTillNextEthercatUpdate = 1000; //usec
+    threadPriority = 0;
+    cpuAffinity = -1;
+    resetCycleStatisticsRequested = false;
     mailboxTimeout = 4000; //micro sec
     ethercatTimeout = 500; //micro sec
     communicationErrors = 0;
@@ -79,6 +97,10 @@ EthercatMasterWithThread::EthercatMasterWithThread(const std::string& configFile
     this->configFileName = configFile;
     this->configFilepath = configFilePath;
     configfile = NULL;
+    transport = NULL;
+    processDataImage = NULL;
+    registrations = NULL;
+    ethercatCycleCounter = 0;
 
     //initialize to zero
     for (unsigned int i = 0; i < 4096; i++) {
@@ -86,6 +108,7 @@ EthercatMasterWithThread::EthercatMasterWithThread(const std::string& configFile
     }
     //read ethercat parameters form config file
     configfile = new ConfigFile(this->configFileName, this->configFilepath);
+    transport = EthercatTransport::create(*configfile);
 
     // configfile.setSection("EtherCAT");
     configfile->readInto(ethernetDevice, "EtherCAT", "EthernetDevice");
@@ -93,6 +116,10 @@ EthercatMasterWithThread::EthercatMasterWithThread(const std::string& configFile
     configfile->readInto(ethercatTimeout, "EtherCAT", "EtherCATTimeout_[usec]");
     configfile->readInto(mailboxTimeout, "EtherCAT", "MailboxTimeout_[usec]");
     configfile->readInto(maxCommunicationErrors, "EtherCAT", "MaximumNumberOfEtherCATErrors");
+    if (configfile->keyExists("EtherCAT", "ThreadPriority"))
+      configfile->readInto(threadPriority, "EtherCAT", "ThreadPriority");
+    if (configfile->keyExists("EtherCAT", "CPUAffinity"))
+      configfile->readInto(cpuAffinity, "EtherCAT", "CPUAffinity");
 
     this->initializeEthercat();
 
@@ -105,6 +132,12 @@ EthercatMasterWithThread::~EthercatMasterWithThread() {
     stopThread = true;
     threads.join_all();
     this->closeEthercat();
+    if (registrations != NULL)
+      delete registrations;
+    if (processDataImage != NULL)
+      delete processDataImage;
+    if (transport != NULL)
+      delete transport;
     if (configfile != NULL)
       delete configfile;
   // Bouml preserved body end 000411F1
@@ -132,9 +165,7 @@ void EthercatMasterWithThread::AutomaticSendOn(const bool enableAutomaticSend) {
 
       for (unsigned int i = 0; i < automaticSendOffBufferVector.size(); i++) {
         slaveNo = automaticSendOffBufferVector[i].jointNumber - 1;
-        slaveMessages[slaveNo].stctInput.Set(automaticSendOffBufferVector[i].stctInput);
-        slaveMessages[slaveNo].stctOutput.Set(automaticSendOffBufferVector[i].stctOutput);
-        slaveMessages[slaveNo].jointNumber.Set(automaticSendOffBufferVector[i].jointNumber);
+        processDataImage->setOutput(slaveNo, automaticSendOffBufferVector[i].stctOutput);
       }
 
       automaticSendOffBufferVector.clear();
@@ -153,10 +184,12 @@ void EthercatMasterWithThread::AutomaticReceiveOn(const bool enableAutomaticRece
     if (this->automaticReceiveOn == false) {
       
 
-      for (unsigned int i = 0; i < slaveMessages.size(); i++) {
-        slaveMessages[i].stctInput.Get(automaticReceiveOffBufferVector[i].stctInput);
-        slaveMessages[i].stctOutput.Get(automaticReceiveOffBufferVector[i].stctOutput);
-        slaveMessages[i].jointNumber.Get(automaticReceiveOffBufferVector[i].jointNumber);
+      std::vector<SlaveMessageInput> inputs;
+      processDataImage->getInputs(inputs);
+      for (unsigned int i = 0; i < automaticReceiveOffBufferVector.size(); i++) {
+        automaticReceiveOffBufferVector[i].stctInput = inputs[i];
+        processDataImage->getOutput(i, automaticReceiveOffBufferVector[i].stctOutput);
+        automaticReceiveOffBufferVector[i].jointNumber = i + 1;
       }
     }
 
@@ -176,6 +209,23 @@ void EthercatMasterWithThread::getEthercatDiagnosticInformation(std::vector<ec_s
   // Bouml preserved body end 00061EF1
 }
 
+///provides all ethercat slave informations from the SOEM driver and the timing statistics of the communication thread
+///@param ethercatSlaveInfos ethercat slave informations
+///@param cycleStatistics timing statistics of the communication thread
+void EthercatMasterWithThread::getEthercatDiagnosticInformation(std::vector<ec_slavet>& ethercatSlaveInfos, PeriodicTimerStatistics& cycleStatistics) {
+  // Bouml preserved body begin 001131F1
+    this->getEthercatDiagnosticInformation(ethercatSlaveInfos);
+    cycleStatistics = this->cycleStatistics.Get();
+  // Bouml preserved body end 001131F1
+}
+
+///resets the timing statistics of the communication thread
+void EthercatMasterWithThread::resetCycleStatistics() {
+  // Bouml preserved body begin 00113271
+    resetCycleStatisticsRequested = true;
+  // Bouml preserved body end 00113271
+}
+
 ///sends ethercat messages to the motor controllers
 /// returns a true if everything it OK and returns false if something fail
 bool EthercatMasterWithThread::sendProcessData() {
@@ -199,35 +249,43 @@ bool EthercatMasterWithThread::receiveProcessData() {
 bool EthercatMasterWithThread::isErrorInSoemDriver() {
   // Bouml preserved body begin 000E69F1
 
-    return ec_iserror();
+    return transport->isError();
 
   // Bouml preserved body end 000E69F1
 }
 
 void EthercatMasterWithThread::registerJointTrajectoryController(JointTrajectoryController* object, const unsigned int JointNumber) {
   // Bouml preserved body begin 000EBCF1
+    Registrations* oldRegistrations = NULL;
     {
-      boost::mutex::scoped_lock trajectoryControllerMutex(trajectoryControllerVectorMutex);
-      if (this->trajectoryControllers[JointNumber - 1] != NULL)
-        throw std::runtime_error("A joint trajectory controller is already register for this joint!");
-      if ((JointNumber - 1) >= this->trajectoryControllers.size())
+      boost::mutex::scoped_lock registrationLock(registrationMutex);
+      if ((JointNumber - 1) >= registrations->trajectoryControllers.size())
         throw std::out_of_range("Invalid joint number");
+      if (registrations->trajectoryControllers[JointNumber - 1] != NULL)
+        throw std::runtime_error("A joint trajectory controller is already register for this joint!");
 
-      this->trajectoryControllers[JointNumber - 1] = object;
+      Registrations* newRegistrations = new Registrations(*registrations);
+      newRegistrations->trajectoryControllers[JointNumber - 1] = object;
+      oldRegistrations = this->publishRegistrations(newRegistrations);
     }
+    this->retireRegistrations(oldRegistrations);
     LOG(debug) << "register joint trajectory controller for joint: " << JointNumber;
   // Bouml preserved body end 000EBCF1
 }
 
 void EthercatMasterWithThread::deleteJointTrajectoryControllerRegistration(const unsigned int JointNumber) {
   // Bouml preserved body begin 000F06F1
+    Registrations* oldRegistrations = NULL;
     {
-      boost::mutex::scoped_lock trajectoryControllerMutex(trajectoryControllerVectorMutex);
-      if ((JointNumber - 1) >= this->trajectoryControllers.size())
+      boost::mutex::scoped_lock registrationLock(registrationMutex);
+      if ((JointNumber - 1) >= registrations->trajectoryControllers.size())
         throw std::out_of_range("Invalid joint number");
 
-      this->trajectoryControllers[JointNumber - 1] = NULL;
+      Registrations* newRegistrations = new Registrations(*registrations);
+      newRegistrations->trajectoryControllers[JointNumber - 1] = NULL;
+      oldRegistrations = this->publishRegistrations(newRegistrations);
     }
+    this->retireRegistrations(oldRegistrations);
     LOG(debug) << "delete joint trajectory controller registration for joint: " << JointNumber;
   // Bouml preserved body end 000F06F1
 }
@@ -247,57 +305,138 @@ bool EthercatMasterWithThread::isEtherCATConnectionEstablished() {
 
 void EthercatMasterWithThread::registerJointLimitMonitor(JointLimitMonitor* object, const unsigned int JointNumber) {
   // Bouml preserved body begin 000FB071
+    Registrations* oldRegistrations = NULL;
     {
-      boost::mutex::scoped_lock limitMonitorMutex(jointLimitMonitorVectorMutex);
-      if (this->jointLimitMonitors[JointNumber - 1] != NULL)
-        LOG(warning) << "A joint limit monitor is already register for this joint!";
-      if ((JointNumber - 1) >= this->jointLimitMonitors.size())
+      boost::mutex::scoped_lock registrationLock(registrationMutex);
+      if ((JointNumber - 1) >= registrations->jointLimitMonitors.size())
         throw std::out_of_range("Invalid joint number");
+      if (registrations->jointLimitMonitors[JointNumber - 1] != NULL)
+        LOG(warning) << "A joint limit monitor is already register for this joint!";
 
-      this->jointLimitMonitors[JointNumber - 1] = object;
+      Registrations* newRegistrations = new Registrations(*registrations);
+      newRegistrations->jointLimitMonitors[JointNumber - 1] = object;
+      oldRegistrations = this->publishRegistrations(newRegistrations);
     }
+    this->retireRegistrations(oldRegistrations);
     LOG(debug) << "register a joint limit monitor for joint: " << JointNumber;
   // Bouml preserved body end 000FB071
 }
 
 void EthercatMasterWithThread::registerDataTrace(void* object, const unsigned int JointNumber) {
   // Bouml preserved body begin 00105871
+    Registrations* oldRegistrations = NULL;
     {
-      boost::mutex::scoped_lock datatraceM(dataTracesMutex);
-      if (this->dataTraces[JointNumber - 1] != NULL)
-        throw std::runtime_error("A data trace is already register for this joint!");
-      if ((JointNumber - 1) >= this->dataTraces.size())
+      boost::mutex::scoped_lock registrationLock(registrationMutex);
+      if ((JointNumber - 1) >= registrations->dataTraces.size())
         throw std::out_of_range("Invalid joint number");
+      if (registrations->dataTraces[JointNumber - 1] != NULL)
+        throw std::runtime_error("A data trace is already register for this joint!");
 
-      this->dataTraces[JointNumber - 1] = (DataTrace*)object;
+      Registrations* newRegistrations = new Registrations(*registrations);
+      newRegistrations->dataTraces[JointNumber - 1] = (DataTrace*)object;
+      oldRegistrations = this->publishRegistrations(newRegistrations);
     }
+    this->retireRegistrations(oldRegistrations);
     LOG(debug) << "register a data trace for joint: " << JointNumber;
   // Bouml preserved body end 00105871
 }
 
 void EthercatMasterWithThread::deleteDataTraceRegistration(const unsigned int JointNumber) {
   // Bouml preserved body begin 001058F1
+    Registrations* oldRegistrations = NULL;
     {
-      boost::mutex::scoped_lock datatraceM(dataTracesMutex);
-      if ((JointNumber - 1) >= this->dataTraces.size())
+      boost::mutex::scoped_lock registrationLock(registrationMutex);
+      if ((JointNumber - 1) >= registrations->dataTraces.size())
         throw std::out_of_range("Invalid joint number");
 
-      this->dataTraces[JointNumber - 1] = NULL;
-
+      Registrations* newRegistrations = new Registrations(*registrations);
+      newRegistrations->dataTraces[JointNumber - 1] = NULL;
+      oldRegistrations = this->publishRegistrations(newRegistrations);
     }
+    this->retireRegistrations(oldRegistrations);
     LOG(debug) << "removed data trace for joint: " << JointNumber;
   // Bouml preserved body end 001058F1
 }
 
+///registers a binary data trace which gets the process data of all slaves in every cycle
+void EthercatMasterWithThread::registerBinaryDataTrace(BinaryDataTrace* object) {
+  // Bouml preserved body begin 00112FF1
+    Registrations* oldRegistrations = NULL;
+    {
+      boost::mutex::scoped_lock registrationLock(registrationMutex);
+      if (registrations->binaryDataTrace != NULL)
+        throw std::runtime_error("A binary data trace is already registered!");
+
+      Registrations* newRegistrations = new Registrations(*registrations);
+      newRegistrations->binaryDataTrace = object;
+      oldRegistrations = this->publishRegistrations(newRegistrations);
+    }
+    this->retireRegistrations(oldRegistrations);
+    LOG(debug) << "register a binary data trace";
+  // Bouml preserved body end 00112FF1
+}
+
+void EthercatMasterWithThread::deleteBinaryDataTraceRegistration() {
+  // Bouml preserved body begin 00113071
+    Registrations* oldRegistrations = NULL;
+    {
+      boost::mutex::scoped_lock registrationLock(registrationMutex);
+      Registrations* newRegistrations = new Registrations(*registrations);
+      newRegistrations->binaryDataTrace = NULL;
+      oldRegistrations = this->publishRegistrations(newRegistrations);
+    }
+    this->retireRegistrations(oldRegistrations);
+    LOG(debug) << "removed binary data trace";
+  // Bouml preserved body end 00113071
+}
+
+///registers an executor which steps a trajectory of several joints in every cycle
+///the cycle period is passed to the executor, all joints have to be added before
+void EthercatMasterWithThread::registerSynchronizedTrajectoryExecutor(SynchronizedTrajectoryExecutor* object) {
+  // Bouml preserved body begin 001138F1
+    Registrations* oldRegistrations = NULL;
+    {
+      boost::mutex::scoped_lock registrationLock(registrationMutex);
+      for (unsigned int i = 0; i < registrations->trajectoryExecutors.size(); i++) {
+        if (registrations->trajectoryExecutors[i] == object)
+          throw std::runtime_error("The synchronized trajectory executor is already registered!");
+      }
+      object->setCyclePeriod(timeTillNextEthercatUpdate);
+
+      Registrations* newRegistrations = new Registrations(*registrations);
+      newRegistrations->trajectoryExecutors.push_back(object);
+      oldRegistrations = this->publishRegistrations(newRegistrations);
+    }
+    this->retireRegistrations(oldRegistrations);
+    LOG(debug) << "register a synchronized trajectory executor";
+  // Bouml preserved body end 001138F1
+}
+
+void EthercatMasterWithThread::deleteSynchronizedTrajectoryExecutorRegistration(SynchronizedTrajectoryExecutor* object) {
+  // Bouml preserved body begin 00113971
+    Registrations* oldRegistrations = NULL;
+    {
+      boost::mutex::scoped_lock registrationLock(registrationMutex);
+      Registrations* newRegistrations = new Registrations(*registrations);
+      newRegistrations->trajectoryExecutors.erase(
+              std::remove(newRegistrations->trajectoryExecutors.begin(), newRegistrations->trajectoryExecutors.end(), object),
+              newRegistrations->trajectoryExecutors.end());
+      oldRegistrations = this->publishRegistrations(newRegistrations);
+    }
+    this->retireRegistrations(oldRegistrations);
+    LOG(debug) << "removed synchronized trajectory executor";
+  // Bouml preserved body end 00113971
+}
+
 ///establishes the ethercat connection
 void EthercatMasterWithThread::initializeEthercat() {
   // Bouml preserved body begin 000410F1
 
     /* initialise SOEM, bind socket to ifname */
-    if (ec_init(const_cast<char*>(ethernetDevice.c_str()))) {
+    if (transport->init(ethernetDevice)) {
       LOG(info) << "Initializing EtherCAT on " << ethernetDevice << " with communication thread";
       /* find and auto-config slaves */
-      if (ec_config(TRUE, &IOmap_) > 0) {
+      if (transport->config(&IOmap_) > 0) {
 
         LOG(trace) << ec_slavecount << " EtherCAT slaves found and configured.";
 
@@ -332,10 +471,10 @@ void EthercatMasterWithThread::initializeEthercat() {
          */
 
         /* wait for all slaves to reach SAFE_OP state */
-        ec_statecheck(0, EC_STATE_SAFE_OP, EC_TIMEOUTSTATE);
+        transport->stateCheck(0, EC_STATE_SAFE_OP, EC_TIMEOUTSTATE);
         if (ec_slave[0].state != EC_STATE_SAFE_OP) {
           LOG(warning) << "Not all EtherCAT slaves reached safe operational state.";
-          ec_readstate();
+          transport->readState();
           //If not all slaves operational find out which one
           for (int i = 1; i <= ec_slavecount; i++) {
             if (ec_slave[i].state != EC_STATE_SAFE_OP) {
@@ -354,13 +493,13 @@ void EthercatMasterWithThread::initializeEthercat() {
         ec_slave[0].state = EC_STATE_OPERATIONAL;
         // request OP state for all slaves
         /* send one valid process data to make outputs in slaves happy*/
-        ec_send_processdata();
-        ec_receive_processdata(EC_TIMEOUTRET);
+        transport->sendProcessData();
+        transport->receiveProcessData(EC_TIMEOUTRET);
         /* request OP state for all slaves */
-        ec_writestate(0);
+        transport->writeState(0);
         // wait for all slaves to reach OP state
 
-        ec_statecheck(0, EC_STATE_OPERATIONAL, EC_TIMEOUTSTATE);
+        transport->stateCheck(0, EC_STATE_OPERATIONAL, EC_TIMEOUTSTATE);
         if (ec_slave[0].state == EC_STATE_OPERATIONAL) {
           LOG(trace) << "Operational state reached for all EtherCAT slaves.";
         } else {
@@ -385,7 +524,8 @@ void EthercatMasterWithThread::initializeEthercat() {
     std::string actualSlaveName;
     nrOfSlaves = 0;
     YouBotSlaveMsg emptySlaveMsg;
-    YouBotSlaveMsgThreadSafe emptySlaveMsgThreadSafe;
+    Registrations* initialRegistrations = new Registrations();
+    initialRegistrations->binaryDataTrace = NULL;
 
     configfile->readInto(baseJointControllerName, "BaseJointControllerName");
     configfile->readInto(baseJointControllerNameAlternative, "BaseJointControllerNameAlternative");
@@ -410,15 +550,16 @@ void EthercatMasterWithThread::initializeEthercat() {
         YouBotSlaveMailboxMsgThreadSafe emptyMailboxSlaveMsg(cnt);
         mailboxMessages.push_back(emptyMailboxSlaveMsg);
         pendingMailboxMsgsReply.push_back(false);
-        trajectoryControllers.push_back(NULL);
-        jointLimitMonitors.push_back(NULL);
-        slaveMessages.push_back(emptySlaveMsgThreadSafe);
+        initialRegistrations->trajectoryControllers.push_back(NULL);
+        initialRegistrations->jointLimitMonitors.push_back(NULL);
         outstandingMailboxMsgFlag.push_back(false);
         newInputMailboxMsgFlag.push_back(false);
-        dataTraces.push_back(NULL);
+        initialRegistrations->dataTraces.push_back(NULL);
       }
     }
-    automaticReceiveOffBufferVector.resize(slaveMessages.size());
+    automaticReceiveOffBufferVector.resize(nrOfSlaves);
+    processDataImage = new ProcessDataImage(nrOfSlaves);
+    registrations = initialRegistrations;
 
     if (nrOfSlaves > 0) {
       LOG(info) << nrOfSlaves << " EtherCAT slaves found";
@@ -446,10 +587,10 @@ bool EthercatMasterWithThread::closeEthercat() {
     ec_slave[0].state = EC_STATE_SAFE_OP;
 
     /* request SAFE_OP state for all slaves */
-    ec_writestate(0);
+    transport->writeState(0);
 
     //stop SOEM, close socket
-    ec_close();
+    transport->close();
 
     return true;
   // Bouml preserved body end 00041271
@@ -462,7 +603,7 @@ void EthercatMasterWithThread::setMsgBuffer(const YouBotSlaveMsg& msgBuffer, con
   // Bouml preserved body begin 000414F1
 
     if (this->automaticSendOn == true) {
-      slaveMessages[jointNumber - 1].stctOutput.Set(msgBuffer.stctOutput);
+      processDataImage->setOutput(jointNumber - 1, msgBuffer.stctOutput);
     } else {
       YouBotSlaveMsg localMsg;
       localMsg.stctInput = msgBuffer.stctInput;
@@ -481,9 +622,9 @@ void EthercatMasterWithThread::getMsgBuffer(const unsigned int jointNumber, YouB
   // Bouml preserved body begin 00041571
 
     if (this->automaticReceiveOn == true) {
-      slaveMessages[jointNumber - 1].stctInput.Get(returnMsg.stctInput);
-      slaveMessages[jointNumber - 1].stctOutput.Get(returnMsg.stctOutput);
-      slaveMessages[jointNumber - 1].jointNumber.Get(returnMsg.jointNumber);
+      processDataImage->getInput(jointNumber - 1, returnMsg.stctInput);
+      processDataImage->getOutput(jointNumber - 1, returnMsg.stctOutput);
+      returnMsg.jointNumber = jointNumber;
     } else {
       returnMsg = this->automaticReceiveOffBufferVector[jointNumber - 1];
     }
@@ -529,7 +670,7 @@ bool EthercatMasterWithThread::sendMailboxMessage(const YouBotSlaveMailboxMsg& m
     mailboxBufferSend[5] = mailboxMsg.stctOutput.value >> 16;
     mailboxBufferSend[6] = mailboxMsg.stctOutput.value >> 8;
     mailboxBufferSend[7] = mailboxMsg.stctOutput.value & 0xff;
-    if (ec_mbxsend(mailboxMsg.slaveNumber, &mailboxBufferSend, mailboxTimeout)) {
+    if (transport->mailboxSend(mailboxMsg.slaveNumber, &mailboxBufferSend, mailboxTimeout)) {
       return true;
     } else {
       return false;
@@ -541,7 +682,7 @@ bool EthercatMasterWithThread::sendMailboxMessage(const YouBotSlaveMailboxMsg& m
 ///@param mailboxMsg ethercat mailbox message
 bool EthercatMasterWithThread::receiveMailboxMessage(YouBotSlaveMailboxMsg& mailboxMsg) {
   // Bouml preserved body begin 00052FF1
-    if (ec_mbxreceive(mailboxMsg.slaveNumber, &mailboxBufferReceive, mailboxTimeout)) {
+    if (transport->mailboxReceive(mailboxMsg.slaveNumber, &mailboxBufferReceive, mailboxTimeout)) {
       //    LOG(trace) << "received mailbox message (buffer two) slave " << mailboxMsg.getSlaveNo();
       mailboxMsg.stctInput.replyAddress = (int) mailboxBufferReceive[0];
       mailboxMsg.stctInput.moduleAddress = (int) mailboxBufferReceive[1];
@@ -559,51 +700,34 @@ bool EthercatMasterWithThread::receiveMailboxMessage(YouBotSlaveMailboxMsg& mail
 void EthercatMasterWithThread::updateSensorActorValues() {
   // Bouml preserved body begin 0003F771
 
-    long timeToWait = 0;
-    boost::posix_time::ptime startTime = boost::posix_time::microsec_clock::local_time();
-    boost::posix_time::time_duration pastTime;
-    //  int counter = 0;
-    boost::posix_time::time_duration realperiode;
-    SlaveMessageOutput trajectoryContollerOutput;
+    std::vector<SlaveMessageOutput> trajectoryContollerOutputs(nrOfSlaves);
+    std::vector<bool> trajectoryContollerOutputValid(nrOfSlaves, false);
     YouBotSlaveMailboxMsg tempMsg;
+    PeriodicTimer cycleTimer(timeTillNextEthercatUpdate);
 
+    if (cpuAffinity >= 0 && PeriodicTimer::setCpuAffinity(cpuAffinity))
+      LOG(info) << "EtherCAT thread runs on CPU " << cpuAffinity;
+    if (threadPriority > 0 && PeriodicTimer::setRealtimePriority(threadPriority))
+      LOG(info) << "EtherCAT thread runs with SCHED_FIFO priority " << threadPriority;
 
-    while (!stopThread) {
+    cycleTimer.start();
 
-      pastTime = boost::posix_time::microsec_clock::local_time() - startTime;
-      timeToWait = timeTillNextEthercatUpdate - pastTime.total_microseconds();
+    while (!stopThread) {
 
-      if (timeToWait < 0 || timeToWait > (int) timeTillNextEthercatUpdate) {
-        //    printf("Missed communication period of %d  microseconds it have been %d microseconds \n",timeTillNextEthercatUpdate, (int)pastTime.total_microseconds()+ 100);
-      } else {
-        boost::this_thread::sleep(boost::posix_time::microseconds(timeToWait));
+      // sleep until the absolute deadline of this cycle
+      cycleTimer.waitForNextPeriod();
+      if (resetCycleStatisticsRequested) {
+        cycleTimer.resetStatistics();
+        resetCycleStatisticsRequested = false;
       }
-
-      // realperiode = boost::posix_time::microsec_clock::local_time() - startTime;
-      startTime = boost::posix_time::microsec_clock::local_time();
-
-      /*
-            counter++;
-            timeSum  = timeSum + realperiode;
-
-            if(counter == 1000){
-
-              double dtotaltime = (double)timeSum.total_microseconds()/counter;
-              printf("TotalTime %7.0lf us\n", dtotaltime);
-              counter = 0;
-              timeSum = startTime - startTime;
-            }
-       */
-
-
-
+      cycleStatistics.Set(cycleTimer.getStatistics());
 
       //send and receive data from ethercat
-      if (ec_send_processdata() == 0) {
+      if (transport->sendProcessData() == 0) {
         LOG(warning) << "Sending process data failed";
       }
 
-      if (ec_receive_processdata(this->ethercatTimeout) == 0) {
+      if (transport->receiveProcessData(this->ethercatTimeout) == 0) {
         if (communicationErrors == 0) {
           LOG(warning) << "Receiving data failed";
         }
@@ -619,24 +743,27 @@ void EthercatMasterWithThread::updateSensorActorValues() {
         break;
       }
 
-      if (ec_iserror())
+      if (transport->isError())
         LOG(warning) << "there is an error in the soem driver";
 
+      // the registrations read here stay valid until the cycle counter is incremented
+      const Registrations* activeRegistrations = registrations;
+      SlaveMessageInput* inputBackImage = processDataImage->getInputBackImage();
 
       for (unsigned int i = 0; i < nrOfSlaves; i++) {
 
-        //send data
+        //send data, an output which is just written by a user thread is sent in the next cycle
         if(automaticSendOn == true)
-          slaveMessages[i].stctOutput.Get(*(ethercatOutputBufferVector[i]));
+          processDataImage->tryGetOutput(i, *(ethercatOutputBufferVector[i]));
 
         //receive data
         if(automaticReceiveOn == true)
-          slaveMessages[i].stctInput.Set(*(ethercatInputBufferVector[i]));
+          inputBackImage[i] = *(ethercatInputBufferVector[i]);
 
 
         // Limit checker
-        if (jointLimitMonitors[i] != NULL) {
-          this->jointLimitMonitors[i]->checkLimitsProcessData(*(ethercatInputBufferVector[i]), *(ethercatOutputBufferVector[i]));
+        if (activeRegistrations->jointLimitMonitors[i] != NULL) {
+          activeRegistrations->jointLimitMonitors[i]->checkLimitsProcessData(*(ethercatInputBufferVector[i]), *(ethercatOutputBufferVector[i]));
         }
         // this->parseYouBotErrorFlags(secondBufferVector[i]);
 
@@ -660,34 +787,69 @@ void EthercatMasterWithThread::updateSensorActorValues() {
         }
       }
       
-      // Trajectory Controller
-      {
-        boost::mutex::scoped_lock trajectoryControllerMutex(trajectoryControllerVectorMutex);
-        for (unsigned int i = 0; i < nrOfSlaves; i++) {
-          if (this->trajectoryControllers[i] != NULL) {
-            if (this->trajectoryControllers[i]->updateTrajectoryController(*(ethercatInputBufferVector[i]), trajectoryContollerOutput)) {
-              //   printf("send vel slave: %d", i);
-              (*(ethercatOutputBufferVector[i])).controllerMode = trajectoryContollerOutput.controllerMode;
-              (*(ethercatOutputBufferVector[i])).value = trajectoryContollerOutput.value;
-              //copy back
-              slaveMessages[i].stctOutput.Set(*(ethercatOutputBufferVector[i]));
-            }
-          }
+      if (automaticReceiveOn == true)
+        processDataImage->publishInputs();
+
+      // Trajectory Controller, all joints are evaluated at the same time
+      JointTrajectoryController::updateTrajectoryControllers(activeRegistrations->trajectoryControllers, ethercatInputBufferVector, trajectoryContollerOutputs, trajectoryContollerOutputValid);
+      // Synchronized trajectories of several joints, driven by the cycle counter
+      for (unsigned int i = 0; i < activeRegistrations->trajectoryExecutors.size(); i++) {
+        activeRegistrations->trajectoryExecutors[i]->updateTrajectoryExecutor(ethercatCycleCounter, ethercatInputBufferVector, trajectoryContollerOutputs, trajectoryContollerOutputValid);
+      }
+      for (unsigned int i = 0; i < nrOfSlaves; i++) {
+        if (trajectoryContollerOutputValid[i]) {
+          //   printf("send vel slave: %d", i);
+          (*(ethercatOutputBufferVector[i])).controllerMode = trajectoryContollerOutputs[i].controllerMode;
+          (*(ethercatOutputBufferVector[i])).value = trajectoryContollerOutputs[i].value;
+          //copy back, skipped if a user thread writes to this slave at the same time
+          processDataImage->trySetOutput(i, *(ethercatOutputBufferVector[i]));
         }
       }
       // update Data Traces
       for (unsigned int i = 0; i < nrOfSlaves; i++) {
-        {
-          boost::mutex::scoped_lock datatraceM(dataTracesMutex);
-          if (dataTraces[i] != NULL) {
-            ((DataTrace*)dataTraces[i])->updateTrace();
-          }
+        if (activeRegistrations->dataTraces[i] != NULL) {
+          ((DataTrace*)activeRegistrations->dataTraces[i])->updateTrace();
+        }
+      }
+      if (activeRegistrations->binaryDataTrace != NULL) {
+        ec_timet now = osal_current_time();
+        uint64 timeMicroSec = (uint64) now.sec * 1000000 + now.usec;
+        for (unsigned int i = 0; i < nrOfSlaves; i++) {
+          activeRegistrations->binaryDataTrace->update(i + 1, ethercatCycleCounter, timeMicroSec, *(ethercatInputBufferVector[i]), *(ethercatOutputBufferVector[i]));
         }
       }
+      // marks the end of the use of activeRegistrations
+      ethercatCycleCounter++;
     }
   // Bouml preserved body end 0003F771
 }
 
+///swaps the registrations used by the communication thread, has to be called with the registrationMutex held
+///@param newRegistrations registrations which will be owned by the master
+///@return the replaced registrations, which have to be handed to retireRegistrations after releasing the mutex
+EthercatMasterWithThread::Registrations* EthercatMasterWithThread::publishRegistrations(Registrations* newRegistrations) {
+  // Bouml preserved body begin 00113871
+    Registrations* oldRegistrations = registrations;
+    // the copy has to be complete before the communication thread can see the pointer
+    registrationMemoryBarrier();
+    registrations = newRegistrations;
+    return oldRegistrations;
+  // Bouml preserved body end 00113871
+}
+
+///deletes replaced registrations as soon as the communication thread has finished the cycle which might still use them
+///must not be called with the registrationMutex held
+void EthercatMasterWithThread::retireRegistrations(Registrations* oldRegistrations) {
+  // Bouml preserved body begin 001139F1
+    // grace period: the cycle which might have read the old registrations has to be finished
+    const uint32 cycle = ethercatCycleCounter;
+    while (cycle == ethercatCycleCounter && !stopThread) {
+      SLEEP_MICROSEC(timeTillNextEthercatUpdate / 2);
+    }
+    delete oldRegistrations;
+  // Bouml preserved body end 001139F1
+}
+
 void EthercatMasterWithThread::parseYouBotErrorFlags(const YouBotSlaveMsg& messageBuffer) {
   // Bouml preserved body begin 000A9E71
     std::stringstream errorMessageStream;
@@ -71,6 +71,7 @@ EthercatMasterWithoutThread::EthercatMasterWithoutThread(const std::string& conf
     mailboxTimeout = 4000; //micro sec
     ethercatTimeout = 500; //micro sec
     configfile = NULL;
+    transport = NULL;
     this->configFileName = configFile;
     this->configFilepath = configFilePath;
 
@@ -80,6 +81,7 @@ EthercatMasterWithoutThread::EthercatMasterWithoutThread(const std::string& conf
     }
     //read ethercat parameters form config file
     configfile = new ConfigFile(this->configFileName, this->configFilepath);
+    transport = EthercatTransport::create(*configfile);
 
     // configfile.setSection("EtherCAT");
     configfile->readInto(ethernetDevice, "EtherCAT", "EthernetDevice");
@@ -94,6 +96,8 @@ EthercatMasterWithoutThread::EthercatMasterWithoutThread(const std::string& conf
 EthercatMasterWithoutThread::~EthercatMasterWithoutThread() {
   // Bouml preserved body begin 000D1BF1
     this->closeEthercat();
+    if (transport != NULL)
+      delete transport;
     if (configfile != NULL)
       delete configfile;
   // Bouml preserved body end 000D1BF1
@@ -139,6 +143,17 @@ void EthercatMasterWithoutThread::getEthercatDiagnosticInformation(std::vector<e
   // Bouml preserved body end 000D1EF1
 }
 
+///provides all ethercat slave informations from the SOEM driver and the timing statistics of the communication thread
+///without a communication thread there are no timing statistics
+///@param ethercatSlaveInfos ethercat slave informations
+///@param cycleStatistics timing statistics of the communication thread
+void EthercatMasterWithoutThread::getEthercatDiagnosticInformation(std::vector<ec_slavet>& ethercatSlaveInfos, PeriodicTimerStatistics& cycleStatistics) {
+  // Bouml preserved body begin 00113171
+    this->getEthercatDiagnosticInformation(ethercatSlaveInfos);
+    cycleStatistics.reset();
+  // Bouml preserved body end 00113171
+}
+
 ///sends ethercat messages to the motor controllers
 /// returns a true if everything it OK and returns false if something fail
 bool EthercatMasterWithoutThread::sendProcessData() {
@@ -150,7 +165,7 @@ bool EthercatMasterWithoutThread::sendProcessData() {
     }
 
     //send data to ethercat
-    if (ec_send_processdata() == 0) {
+    if (transport->sendProcessData() == 0) {
       return false;
     }
     
@@ -165,7 +180,7 @@ bool EthercatMasterWithoutThread::receiveProcessData() {
   // Bouml preserved body begin 000D5D71
 
     //receive data from ethercat
-    if (ec_receive_processdata(this->ethercatTimeout) == 0) {
+    if (transport->receiveProcessData(this->ethercatTimeout) == 0) {
       return false;
     }
 
@@ -184,7 +199,7 @@ bool EthercatMasterWithoutThread::receiveProcessData() {
 bool EthercatMasterWithoutThread::isErrorInSoemDriver() {
   // Bouml preserved body begin 000D5DF1
    
-    return ec_iserror();
+    return transport->isError();
 
   // Bouml preserved body end 000D5DF1
 }
@@ -206,10 +221,10 @@ void EthercatMasterWithoutThread::initializeEthercat() {
   // Bouml preserved body begin 000D1F71
 
     /* initialise SOEM, bind socket to ifname */
-    if (ec_init(const_cast<char*>(ethernetDevice.c_str()))) {
+    if (transport->init(ethernetDevice)) {
       LOG(info) << "Initializing EtherCAT on " << ethernetDevice << " without communication thread";
       /* find and auto-config slaves */
-      if (ec_config(TRUE, &IOmap_) > 0) {
+      if (transport->config(&IOmap_) > 0) {
 
         LOG(trace) << ec_slavecount << " EtherCAT slaves found and configured.";
 
@@ -244,10 +259,10 @@ void EthercatMasterWithoutThread::initializeEthercat() {
          */
 
         /* wait for all slaves to reach SAFE_OP state */
-        ec_statecheck(0, EC_STATE_SAFE_OP, EC_TIMEOUTSTATE);
+        transport->stateCheck(0, EC_STATE_SAFE_OP, EC_TIMEOUTSTATE);
         if (ec_slave[0].state != EC_STATE_SAFE_OP) {
           LOG(warning) << "Not all EtherCAT slaves reached safe operational state.";
-          ec_readstate();
+          transport->readState();
           //If not all slaves operational find out which one
           for (int i = 1; i <= ec_slavecount; i++) {
             if (ec_slave[i].state != EC_STATE_SAFE_OP) {
@@ -266,13 +281,13 @@ void EthercatMasterWithoutThread::initializeEthercat() {
         ec_slave[0].state = EC_STATE_OPERATIONAL;
         // request OP state for all slaves
         /* send one valid process data to make outputs in slaves happy*/
-        ec_send_processdata();
-        ec_receive_processdata(EC_TIMEOUTRET);
+        transport->sendProcessData();
+        transport->receiveProcessData(EC_TIMEOUTRET);
         /* request OP state for all slaves */
-        ec_writestate(0);
+        transport->writeState(0);
         // wait for all slaves to reach OP state
 
-        ec_statecheck(0, EC_STATE_OPERATIONAL, EC_TIMEOUTSTATE);
+        transport->stateCheck(0, EC_STATE_OPERATIONAL, EC_TIMEOUTSTATE);
         if (ec_slave[0].state == EC_STATE_OPERATIONAL) {
           LOG(trace) << "Operational state reached for all EtherCAT slaves.";
         } else {
@@ -349,10 +364,10 @@ bool EthercatMasterWithoutThread::closeEthercat() {
     ec_slave[0].state = EC_STATE_SAFE_OP;
 
     /* request SAFE_OP state for all slaves */
-    ec_writestate(0);
+    transport->writeState(0);
 
     //stop SOEM, close socket
-    ec_close();
+    transport->close();
 
     return true;
   // Bouml preserved body end 000D2071
@@ -415,7 +430,7 @@ bool EthercatMasterWithoutThread::sendMailboxMessage(const YouBotSlaveMailboxMsg
     mailboxBufferSend[5] = mailboxMsg.stctOutput.value >> 16;
     mailboxBufferSend[6] = mailboxMsg.stctOutput.value >> 8;
     mailboxBufferSend[7] = mailboxMsg.stctOutput.value & 0xff;
-    if (ec_mbxsend(mailboxMsg.slaveNumber, &mailboxBufferSend, mailboxTimeout)) {
+    if (transport->mailboxSend(mailboxMsg.slaveNumber, &mailboxBufferSend, mailboxTimeout)) {
       return true;
     } else {
       return false;
@@ -427,7 +442,7 @@ bool EthercatMasterWithoutThread::sendMailboxMessage(const YouBotSlaveMailboxMsg
 ///@param mailboxMsg ethercat mailbox message
 bool EthercatMasterWithoutThread::receiveMailboxMessage(YouBotSlaveMailboxMsg& mailboxMsg) {
   // Bouml preserved body begin 000D2371
-    if (ec_mbxreceive(mailboxMsg.slaveNumber, &mailboxBufferReceive, mailboxTimeout)) {
+    if (transport->mailboxReceive(mailboxMsg.slaveNumber, &mailboxBufferReceive, mailboxTimeout)) {
       mailboxMsg.stctInput.replyAddress = (int) mailboxBufferReceive[0];
       mailboxMsg.stctInput.moduleAddress = (int) mailboxBufferReceive[1];
       mailboxMsg.stctInput.status = (int) mailboxBufferReceive[2];
@@ -0,0 +1,139 @@
+/****************************************************************
+ *
+ * Copyright (c) 2011
+ * All rights reserved.
+ *
+ * Hochschule Bonn-Rhein-Sieg
+ * University of Applied Sciences
+ * Computer Science Department
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Author:
+ * Jan Paulus, Nico Hochgeschwender, Michael Reckhaus, Azamat Shakhimardanov
+ * Supervised by:
+ * Gerhard K. Kraetzschmar
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * This sofware is published under a dual-license: GNU Lesser General Public 
+ * License LGPL 2.1 and BSD license. The dual-license implies that users of this
+ * code may choose which terms they prefer.
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Hochschule Bonn-Rhein-Sieg nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License LGPL as
+ * published by the Free Software Foundation, either version 2.1 of the
+ * License, or (at your option) any later version or the BSD license.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License LGPL and the BSD license for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License LGPL and BSD license along with this program.
+ *
+ ****************************************************************/
+extern "C" {
+#include "youbot_driver/soem/ethercattype.h"
+#include "nicdrv.h"
+#include "youbot_driver/soem/ethercatbase.h"
+#include "youbot_driver/soem/ethercatmain.h"
+#include "youbot_driver/soem/ethercatconfig.h"
+}
+#include <stdexcept>
+#include "youbot_driver/generic/Logger.hpp"
+#include "youbot_driver/youbot/EthercatTransport.hpp"
+#include "youbot_driver/youbot/SimulatedEthercatTransport.hpp"
+
+namespace youbot {
+
+///creates the transport which is selected by the key Transport in the EtherCAT section of the config file
+///"SOEM" (default) or "Simulation"
+EthercatTransport* EthercatTransport::create(ConfigFile& configfile) {
+  std::string transport = "SOEM";
+  if (configfile.keyExists("EtherCAT", "Transport"))
+    configfile.readInto(transport, "EtherCAT", "Transport");
+
+  if (transport == "SOEM")
+    return new SoemEthercatTransport();
+
+  if (transport == "Simulation") {
+    unsigned int baseJoints = 4;
+    unsigned int manipulatorJoints = 5;
+    if (configfile.keyExists("EtherCAT", "SimulatedBaseJoints"))
+      configfile.readInto(baseJoints, "EtherCAT", "SimulatedBaseJoints");
+    if (configfile.keyExists("EtherCAT", "SimulatedManipulatorJoints"))
+      configfile.readInto(manipulatorJoints, "EtherCAT", "SimulatedManipulatorJoints");
+    LOG(info) << "Using simulated EtherCAT slaves: " << baseJoints << " base joints and " << manipulatorJoints << " manipulator joints";
+    return new SimulatedEthercatTransport(baseJoints, manipulatorJoints);
+  }
+
+  throw std::runtime_error("Unknown EtherCAT transport: " + transport);
+}
+
+SoemEthercatTransport::SoemEthercatTransport() {
+}
+
+SoemEthercatTransport::~SoemEthercatTransport() {
+}
+
+int SoemEthercatTransport::init(const std::string& ethernetDevice) {
+  return ec_init(const_cast<char*>(ethernetDevice.c_str()));
+}
+
+int SoemEthercatTransport::config(void* ioMap) {
+  return ec_config(TRUE, ioMap);
+}
+
+uint16 SoemEthercatTransport::stateCheck(const uint16 slave, const uint16 requestedState, const int timeout) {
+  return ec_statecheck(slave, requestedState, timeout);
+}
+
+int SoemEthercatTransport::readState() {
+  return ec_readstate();
+}
+
+int SoemEthercatTransport::writeState(const uint16 slave) {
+  return ec_writestate(slave);
+}
+
+int SoemEthercatTransport::sendProcessData() {
+  return ec_send_processdata();
+}
+
+int SoemEthercatTransport::receiveProcessData(const int timeout) {
+  return ec_receive_processdata(timeout);
+}
+
+int SoemEthercatTransport::mailboxSend(const uint16 slave, ec_mbxbuft* mailbox, const int timeout) {
+  return ec_mbxsend(slave, mailbox, timeout);
+}
+
+int SoemEthercatTransport::mailboxReceive(const uint16 slave, ec_mbxbuft* mailbox, const int timeout) {
+  return ec_mbxreceive(slave, mailbox, timeout);
+}
+
+bool SoemEthercatTransport::isError() {
+  return ec_iserror();
+}
+
+void SoemEthercatTransport::close() {
+  ec_close();
+}
+
+} // namespace youbot
@@ -50,14 +50,15 @@
  ****************************************************************/
 #include "youbot_driver/youbot/JointTrajectoryController.hpp"
 #include "youbot_driver/youbot/YouBotJointParameter.hpp"
+#include "youbot_driver/generic/PeriodicTimer.hpp"
 
 namespace youbot {
 
   JointTrajectoryController::JointTrajectoryController() {
 
     this->pid.initPid(80.0, 1, 0, 1000, -1000);
-    time = boost::posix_time::microsec_clock::local_time();
-    last_time = boost::posix_time::microsec_clock::local_time();
+    last_update_time_ = PeriodicTimer::getMonotonicTimeMicroSec();
+    table_cursor_ = -1;
 
     this->isControllerActive = false;
     this->targetPosition = 0;
@@ -75,7 +76,7 @@ namespace youbot {
     traj[0].start_time = boost::posix_time::microsec_clock::local_time();
     traj[0].duration = boost::posix_time::microseconds(0);
     //traj[0].splines.coef[0] = 0.0;
-    current_trajectory_box_.Set(traj_ptr);
+    commitTrajectory(traj_ptr, traj[0].start_time);
 
 
   }
@@ -244,7 +245,7 @@ namespace youbot {
       return;
     }
 
-    current_trajectory_box_.Set(new_traj_ptr);
+    commitTrajectory(new_traj_ptr, time_now);
     LOG(debug) << "The new trajectory has " << new_traj.size() << " segments";
     this->isControllerActive = true;
 
@@ -257,7 +258,7 @@ namespace youbot {
     traj[0].start_time = boost::posix_time::microsec_clock::local_time();
     traj[0].duration = boost::posix_time::microseconds(0);
     //traj[0].splines.coef[0] = 0.0;
-    current_trajectory_box_.Set(traj_ptr);
+    commitTrajectory(traj_ptr, traj[0].start_time);
     LOG(trace) << "Trajectory has been canceled";
   }
 
@@ -267,36 +268,70 @@ namespace youbot {
 
   bool JointTrajectoryController::updateTrajectoryController(const SlaveMessageInput& actual, SlaveMessageOutput& velocity) {
 
-    time = boost::posix_time::microsec_clock::local_time();
-    boost::posix_time::time_duration dt = time - last_time;
-    last_time = time;
+    return updateTrajectoryController(PeriodicTimer::getMonotonicTimeMicroSec(), actual, velocity);
 
-    boost::shared_ptr<const SpecifiedTrajectory> traj_ptr;
-    current_trajectory_box_.Get(traj_ptr);
-    if (!traj_ptr || !this->isControllerActive) {
+  }
+
+  void JointTrajectoryController::updateTrajectoryControllers(const std::vector<JointTrajectoryController*>& controllers, const std::vector<SlaveMessageInput*>& actual, std::vector<SlaveMessageOutput>& velocity, std::vector<bool>& update) {
+
+    // all joints are sampled at the same time
+    const long long now = PeriodicTimer::getMonotonicTimeMicroSec();
+
+    for (unsigned int i = 0; i < controllers.size(); i++) {
+      if (controllers[i] != NULL) {
+        update[i] = controllers[i]->updateTrajectoryController(now, *(actual[i]), velocity[i]);
+      } else {
+        update[i] = false;
+      }
+    }
+
+  }
+
+  bool JointTrajectoryController::updateTrajectoryController(const long long now, const SlaveMessageInput& actual, SlaveMessageOutput& velocity) {
+
+    boost::posix_time::time_duration dt = boost::posix_time::microseconds(now - last_update_time_);
+    last_update_time_ = now;
+
+    boost::shared_ptr<const TrajectoryTable> table_ptr;
+    current_table_box_.Get(table_ptr);
+    if (!table_ptr || !this->isControllerActive) {
       this->isControllerActive = false;
       //   LOG(error) << "The current trajectory can never be null";
       return false;
     }
-    
-    // Only because this is what the code originally looked like.
-    const SpecifiedTrajectory &traj = *traj_ptr;
-
 
-    // Determines which segment of the trajectory to use.  (Not particularly realtime friendly).
-    int seg = -1;
-    while (seg + 1 < (int) traj.size() && traj[seg + 1].start_time < time) {
-      ++seg;
+    const TrajectoryTable &table = *table_ptr;
+
+    // A new table starts with a binary search, afterwards the cursor only moves forward with the time.
+    if (table_ptr != active_table_) {
+      active_table_ = table_ptr;
+      table_cursor_ = -1;
+      int first = 0;
+      int count = (int) table.size();
+      while (count > 0) {
+        int step = count / 2;
+        if (table[first + step].startTime < now) {
+          first += step + 1;
+          count -= step + 1;
+        } else {
+          count = step;
+        }
+      }
+      table_cursor_ = first - 1;
+    }
+    while (table_cursor_ + 1 < (int) table.size() && table[table_cursor_ + 1].startTime < now) {
+      ++table_cursor_;
     }
 
-    if (seg == -1) {
-      if (traj.size() == 0)
+    if (table_cursor_ == -1) {
+      if (table.size() == 0)
         LOG(error) << "No segments in the trajectory";
       else
         LOG(error) << "No earlier segments.";
       return false;
     }
-    if(seg == (int) traj.size()-1 && (traj[seg].start_time + traj[seg].duration)  < time){
+    const TrajectoryTableSegment& segment = table[table_cursor_];
+    if(table_cursor_ == (int) table.size()-1 && segment.endTime < now){
       LOG(trace) << "trajectory finished.";
       this->isControllerActive = false;
       velocity.value = 0;
@@ -305,10 +340,25 @@ namespace youbot {
     }
 
     // ------ Trajectory Sampling
-    duration = (double)traj[seg].duration.total_microseconds()/1000.0/1000.0; //convert to seconds
-    time_till_seg_start = (double)(time - traj[seg].start_time).total_microseconds()/1000.0/1000.0;
-
-    sampleSplineWithTimeBounds(traj[seg].spline.coef, duration, time_till_seg_start, targetPosition, targetVelocity, targetAcceleration);
+    duration = segment.duration;
+    time_till_seg_start = (double)(now - segment.startTime)/1000.0/1000.0;
+
+    double t = time_till_seg_start;
+    if (t < 0)
+      t = 0;
+    else if (t > duration)
+      t = duration;
+
+    // Horner scheme on the inline coefficients
+    const double* c = segment.coef;
+    targetPosition = c[0] + t * (c[1] + t * (c[2] + t * (c[3] + t * (c[4] + t * c[5]))));
+    if (time_till_seg_start < 0 || time_till_seg_start > duration) {
+      targetVelocity = 0;
+      targetAcceleration = 0;
+    } else {
+      targetVelocity = c[1] + t * (2.0 * c[2] + t * (3.0 * c[3] + t * (4.0 * c[4] + t * 5.0 * c[5])));
+      targetAcceleration = 2.0 * c[2] + t * (6.0 * c[3] + t * (12.0 * c[4] + t * 20.0 * c[5]));
+    }
 
 
     if(inverseDirection){
@@ -449,5 +499,28 @@ namespace youbot {
 
   }
 
+  void JointTrajectoryController::commitTrajectory(const boost::shared_ptr<const SpecifiedTrajectory>& trajectory, const boost::posix_time::ptime& time_now) {
+
+    // the segment times are moved from the wall clock to the monotonic clock
+    const long long monotonic_now = PeriodicTimer::getMonotonicTimeMicroSec();
+
+    boost::shared_ptr<TrajectoryTable> table_ptr(new TrajectoryTable(trajectory->size()));
+    TrajectoryTable &table = *table_ptr;
+
+    for (unsigned int i = 0; i < trajectory->size(); i++) {
+      const Segment& seg = (*trajectory)[i];
+      table[i].startTime = monotonic_now + (seg.start_time - time_now).total_microseconds();
+      table[i].endTime = table[i].startTime + seg.duration.total_microseconds();
+      table[i].duration = (double)seg.duration.total_microseconds()/1000.0/1000.0;
+      for (unsigned int j = 0; j < 6; j++) {
+        table[i].coef[j] = (j < seg.spline.coef.size()) ? seg.spline.coef[j] : 0.0;
+      }
+    }
+
+    current_trajectory_box_.Set(trajectory);
+    current_table_box_.Set(table_ptr);
+
+  }
+
 
 } // namespace youbot
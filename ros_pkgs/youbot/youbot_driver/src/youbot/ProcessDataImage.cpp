@@ -0,0 +1,214 @@
+/****************************************************************
+ *
+ * Copyright (c) 2011
+ * All rights reserved.
+ *
+ * Hochschule Bonn-Rhein-Sieg
+ * University of Applied Sciences
+ * Computer Science Department
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Author:
+ * Jan Paulus, Nico Hochgeschwender, Michael Reckhaus, Azamat Shakhimardanov
+ * Supervised by:
+ * Gerhard K. Kraetzschmar
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * This sofware is published under a dual-license: GNU Lesser General Public 
+ * License LGPL 2.1 and BSD license. The dual-license implies that users of this
+ * code may choose which terms they prefer.
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Hochschule Bonn-Rhein-Sieg nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License LGPL as
+ * published by the Free Software Foundation, either version 2.1 of the
+ * License, or (at your option) any later version or the BSD license.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License LGPL and the BSD license for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License LGPL and BSD license along with this program.
+ *
+ ****************************************************************/
+#include <stdexcept>
+#include "youbot_driver/youbot/ProcessDataImage.hpp"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace youbot {
+
+///orders the copies of the process data against the sequence counters
+static inline void processDataMemoryBarrier() {
+#if defined(_MSC_VER)
+  _ReadWriteBarrier();
+#else
+  __sync_synchronize();
+#endif
+}
+
+ProcessDataImage::ProcessDataImage(const unsigned int numberOfSlaves)
+  : numberOfSlaves(numberOfSlaves), inputImages(2 * numberOfSlaves), outputImage(numberOfSlaves) {
+  // Bouml preserved body begin 001132F1
+    oro_atomic_set(&inputSequence, 0);
+    for (unsigned int i = 0; i < outputImage.size(); i++) {
+      outputImage[i].sequence = 0;
+    }
+  // Bouml preserved body end 001132F1
+}
+
+ProcessDataImage::~ProcessDataImage() {
+  // Bouml preserved body begin 00113371
+  // Bouml preserved body end 00113371
+}
+
+unsigned int ProcessDataImage::getNumberOfSlaves() const {
+  // Bouml preserved body begin 001133F1
+    return numberOfSlaves;
+  // Bouml preserved body end 001133F1
+}
+
+///returns the back image of the inputs which can be filled by the EtherCAT thread
+///the image is contiguous and has getNumberOfSlaves() elements
+SlaveMessageInput* ProcessDataImage::getInputBackImage() {
+  // Bouml preserved body begin 00113471
+    if (numberOfSlaves == 0)
+      return NULL;
+    unsigned int back = ((unsigned int) oro_atomic_read(&inputSequence) + 1) & 1;
+    return &inputImages[back * numberOfSlaves];
+  // Bouml preserved body end 00113471
+}
+
+///makes the back image the new front image which is read by the user threads
+///must only be called by the EtherCAT thread
+void ProcessDataImage::publishInputs() {
+  // Bouml preserved body begin 001134F1
+    processDataMemoryBarrier();
+    oro_atomic_inc(&inputSequence);
+    processDataMemoryBarrier();
+  // Bouml preserved body end 001134F1
+}
+
+///copies the last published input of one slave
+///@param slaveNumber index of the slave starting with 0
+///@param input the input of the slave
+void ProcessDataImage::getInput(const unsigned int slaveNumber, SlaveMessageInput& input) const {
+  // Bouml preserved body begin 00113571
+    if (slaveNumber >= numberOfSlaves)
+      throw std::out_of_range("Invalid slave number");
+
+    // the EtherCAT thread writes to this image only after the next flip,
+    // so the copy is complete if the sequence has not changed meanwhile
+    int sequence;
+    do {
+      sequence = oro_atomic_read(&inputSequence);
+      processDataMemoryBarrier();
+      input = inputImages[((unsigned int) sequence & 1) * numberOfSlaves + slaveNumber];
+      processDataMemoryBarrier();
+    } while (sequence != oro_atomic_read(&inputSequence));
+  // Bouml preserved body end 00113571
+}
+
+///copies the last published inputs of all slaves from the same cycle
+///@param inputs the inputs of all slaves
+///returns the number of published cycles
+unsigned int ProcessDataImage::getInputs(std::vector<SlaveMessageInput>& inputs) const {
+  // Bouml preserved body begin 001135F1
+    inputs.resize(numberOfSlaves);
+    int sequence;
+    do {
+      sequence = oro_atomic_read(&inputSequence);
+      processDataMemoryBarrier();
+      const unsigned int front = ((unsigned int) sequence & 1) * numberOfSlaves;
+      for (unsigned int i = 0; i < numberOfSlaves; i++) {
+        inputs[i] = inputImages[front + i];
+      }
+      processDataMemoryBarrier();
+    } while (sequence != oro_atomic_read(&inputSequence));
+    return (unsigned int) sequence;
+  // Bouml preserved body end 001135F1
+}
+
+///stores the output of one slave, waits only for other user threads which write to the same slave
+///@param slaveNumber index of the slave starting with 0
+///@param output output for the slave
+void ProcessDataImage::setOutput(const unsigned int slaveNumber, const SlaveMessageOutput& output) {
+  // Bouml preserved body begin 00113671
+    if (slaveNumber >= numberOfSlaves)
+      throw std::out_of_range("Invalid slave number");
+
+    while (!trySetOutput(slaveNumber, output)) {
+    }
+  // Bouml preserved body end 00113671
+}
+
+///stores the output of one slave if no other thread writes to it at the same time, never waits
+///returns false if the output has not been stored
+bool ProcessDataImage::trySetOutput(const unsigned int slaveNumber, const SlaveMessageOutput& output) {
+  // Bouml preserved body begin 001136F1
+    OutputSlot& slot = outputImage[slaveNumber];
+    int sequence = slot.sequence;
+
+    // an odd sequence marks the slot as being written
+    if ((sequence & 1) || oro_cmpxchg(&slot.sequence, sequence, sequence + 1) != sequence)
+      return false;
+
+    slot.output = output;
+    processDataMemoryBarrier();
+    slot.sequence = sequence + 2;
+    return true;
+  // Bouml preserved body end 001136F1
+}
+
+///copies the last stored output of one slave
+void ProcessDataImage::getOutput(const unsigned int slaveNumber, SlaveMessageOutput& output) const {
+  // Bouml preserved body begin 00113771
+    if (slaveNumber >= numberOfSlaves)
+      throw std::out_of_range("Invalid slave number");
+
+    while (!tryGetOutput(slaveNumber, output)) {
+    }
+  // Bouml preserved body end 00113771
+}
+
+///copies the last stored output of one slave if no thread writes to it at the same time, never waits
+///returns false if output has not been changed
+bool ProcessDataImage::tryGetOutput(const unsigned int slaveNumber, SlaveMessageOutput& output) const {
+  // Bouml preserved body begin 001137F1
+    const OutputSlot& slot = outputImage[slaveNumber];
+    int sequence = slot.sequence;
+    if (sequence & 1)
+      return false;
+
+    processDataMemoryBarrier();
+    SlaveMessageOutput copy = slot.output;
+    processDataMemoryBarrier();
+    if (sequence != slot.sequence)
+      return false;
+
+    output = copy;
+    return true;
+  // Bouml preserved body end 001137F1
+}
+
+
+} // namespace youbot
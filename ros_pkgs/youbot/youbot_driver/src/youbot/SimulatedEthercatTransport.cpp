@@ -0,0 +1,367 @@
+/****************************************************************
+ *
+ * Copyright (c) 2011
+ * All rights reserved.
+ *
+ * Hochschule Bonn-Rhein-Sieg
+ * University of Applied Sciences
+ * Computer Science Department
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Author:
+ * Jan Paulus, Nico Hochgeschwender, Michael Reckhaus, Azamat Shakhimardanov
+ * Supervised by:
+ * Gerhard K. Kraetzschmar
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * This sofware is published under a dual-license: GNU Lesser General Public 
+ * License LGPL 2.1 and BSD license. The dual-license implies that users of this
+ * code may choose which terms they prefer.
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Hochschule Bonn-Rhein-Sieg nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License LGPL as
+ * published by the Free Software Foundation, either version 2.1 of the
+ * License, or (at your option) any later version or the BSD license.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License LGPL and the BSD license for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License LGPL and BSD license along with this program.
+ *
+ ****************************************************************/
+#include <cmath>
+#include <cstring>
+#include <cstdio>
+#include <stdexcept>
+#include "youbot_driver/generic/PeriodicTimer.hpp"
+#include "youbot_driver/youbot/ProtocolDefinitions.hpp"
+#include "youbot_driver/youbot/SimulatedEthercatTransport.hpp"
+
+namespace youbot {
+
+SimulatedYouBotSlave::SimulatedYouBotSlave(const std::string& name, const int controllerType) {
+  this->name = name;
+  this->controllerType = controllerType;
+  position = 0;
+  velocity = 0;
+  current = 0;
+  commandedVelocity = 0;
+  mailboxReplyAvailable = false;
+  std::memset(mailboxReply, 0, sizeof(mailboxReply));
+
+  encoderTicksPerRound = 4000;
+  velocityTimeConstant = 0.01;
+  positionGain = 0.3;
+  accelerationToCurrent = 0.05;
+  currentToAcceleration = 1.0 / accelerationToCurrent;
+  viscousFriction = 0.1;
+
+  axisParameters[4] = 2000; //MaximumPositioningVelocity
+  axisParameters[15] = 1; //InitializeJoint, the commutation has already been done
+  input.errorFlags = INITIALIZED;
+}
+
+SimulatedYouBotSlave::~SimulatedYouBotSlave() {
+}
+
+const std::string& SimulatedYouBotSlave::getName() const {
+  return name;
+}
+
+///advances the motor model by timeStep seconds with the last received process data output
+void SimulatedYouBotSlave::update(const SlaveMessageOutput& output, const double timeStep) {
+  double acceleration = 0;
+  uint32 modeFlags = 0;
+
+  switch (output.controllerMode) {
+    case POSITION_CONTROL:
+    {
+      double maxVelocity = getAxisParameter(4);
+      commandedVelocity = positionGain * (output.value - position);
+      if (commandedVelocity > maxVelocity)
+        commandedVelocity = maxVelocity;
+      if (commandedVelocity < -maxVelocity)
+        commandedVelocity = -maxVelocity;
+      input.targetPosition = output.value;
+      modeFlags = POSITION_MODE;
+      if (std::fabs(output.value - position) < 10)
+        modeFlags |= POSITION_REACHED;
+      break;
+    }
+    case VELOCITY_CONTROL:
+      commandedVelocity = output.value;
+      modeFlags = VELOCITY_MODE;
+      break;
+    case CURRENT_MODE:
+      current = output.value;
+      acceleration = currentToAcceleration * (current - viscousFriction * velocity);
+      modeFlags = TORQUE_MODE;
+      break;
+    case MOTOR_STOP:
+      commandedVelocity = 0;
+      break;
+    case SET_POSITION_TO_REFERENCE:
+      position = output.value;
+      break;
+    default:
+      break;
+  }
+
+  if (output.controllerMode != CURRENT_MODE) {
+    // first order velocity loop
+    acceleration = (commandedVelocity - velocity) / velocityTimeConstant;
+    if (timeStep > velocityTimeConstant)
+      acceleration = (commandedVelocity - velocity) / timeStep;
+    current = accelerationToCurrent * acceleration + viscousFriction * velocity;
+  }
+
+  velocity += acceleration * timeStep;
+  position += velocity / 60.0 * encoderTicksPerRound * timeStep;
+
+  input.actualPosition = (int32) floor(position + 0.5);
+  input.actualVelocity = (int32) floor(velocity + 0.5);
+  input.actualCurrent = (int32) floor(current + 0.5);
+  input.targetVelocity = (int32) floor(commandedVelocity + 0.5);
+  input.targetCurrent = input.actualCurrent;
+  input.rampGeneratorVelocity = input.targetVelocity;
+  input.errorFlags = INITIALIZED | modeFlags;
+  if (std::fabs(velocity) < 0.5 && output.controllerMode != CURRENT_MODE)
+    input.errorFlags |= MOTOR_HALTED;
+}
+
+const SlaveMessageInput& SimulatedYouBotSlave::getInput() const {
+  return input;
+}
+
+///processes a mailbox request and stores the reply
+void SimulatedYouBotSlave::handleMailboxRequest(const ec_mbxbuft& request) {
+  uint8 moduleAddress = request[0];
+  uint8 commandNumber = request[1];
+  uint8 typeNumber = request[2];
+  int32 value = (request[4] << 24 | request[5] << 16 | request[6] << 8 | request[7]);
+  int key = moduleAddress * 256 + typeNumber;
+  uint8 status = MAILBOX_SUCCESS;
+
+  switch (commandNumber) {
+    case SAP:
+      axisParameters[key] = value;
+      break;
+    case GAP:
+      value = getAxisParameter(key);
+      break;
+    case SGP:
+      globalParameters[key] = value;
+      break;
+    case GGP:
+      value = globalParameters.count(key) ? globalParameters[key] : 0;
+      break;
+    case FIRMWARE_VERSION:
+    {
+      char version[9] = {0};
+      snprintf(version, sizeof(version), "%dV200", controllerType);
+      std::memcpy(mailboxReply, version, 8);
+      mailboxReplyAvailable = true;
+      return;
+    }
+    case MST:
+      commandedVelocity = 0;
+      break;
+    case STAP:
+    case RSAP:
+    case STGP:
+    case RSGP:
+      break;
+    default:
+      status = INVALID_COMMAND;
+      break;
+  }
+
+  mailboxReply[0] = 2; //reply address of the master
+  mailboxReply[1] = moduleAddress;
+  mailboxReply[2] = status;
+  mailboxReply[3] = commandNumber;
+  mailboxReply[4] = value >> 24;
+  mailboxReply[5] = value >> 16;
+  mailboxReply[6] = value >> 8;
+  mailboxReply[7] = value & 0xff;
+  mailboxReplyAvailable = true;
+}
+
+///returns false if there is no reply
+bool SimulatedYouBotSlave::getMailboxReply(ec_mbxbuft& reply) {
+  if (!mailboxReplyAvailable)
+    return false;
+  std::memcpy(reply, mailboxReply, sizeof(ec_mbxbuft));
+  mailboxReplyAvailable = false;
+  return true;
+}
+
+int32 SimulatedYouBotSlave::getAxisParameter(const int key) const {
+  std::map<int, int32>::const_iterator it = axisParameters.find(key);
+  if (it != axisParameters.end())
+    return it->second;
+  return 0;
+}
+
+SimulatedEthercatTransport::SimulatedEthercatTransport(const unsigned int baseJoints, const unsigned int manipulatorJoints) {
+  if (baseJoints + manipulatorJoints >= EC_MAXSLAVE)
+    throw std::out_of_range("Too many simulated EtherCAT slaves");
+
+  for (unsigned int i = 0; i < baseJoints; i++) {
+    slaves.push_back(new SimulatedYouBotSlave("TMCM-174", 174));
+  }
+  for (unsigned int i = 0; i < manipulatorJoints; i++) {
+    slaves.push_back(new SimulatedYouBotSlave("TMCM-1610", 1610));
+  }
+  sentOutputs.resize(slaves.size());
+  lastUpdate = 0;
+  dataSent = false;
+}
+
+SimulatedEthercatTransport::~SimulatedEthercatTransport() {
+  for (unsigned int i = 0; i < slaves.size(); i++) {
+    delete slaves[i];
+  }
+}
+
+int SimulatedEthercatTransport::init(const std::string& ethernetDevice) {
+  return 1;
+}
+
+///maps the process data like SOEM, first the outputs of all slaves then the inputs
+int SimulatedEthercatTransport::config(void* ioMap) {
+  uint8* data = (uint8*) ioMap;
+  outputs.clear();
+  inputs.clear();
+
+  for (unsigned int i = 0; i < slaves.size(); i++) {
+    outputs.push_back((SlaveMessageOutput*) data);
+    data += sizeof(SlaveMessageOutput);
+  }
+  for (unsigned int i = 0; i < slaves.size(); i++) {
+    inputs.push_back((SlaveMessageInput*) data);
+    data += sizeof(SlaveMessageInput);
+  }
+
+  ec_slavecount = slaves.size();
+  std::memset(&ec_slave[0], 0, sizeof(ec_slavet));
+  for (unsigned int i = 0; i < slaves.size(); i++) {
+    ec_slavet& slave = ec_slave[i + 1];
+    std::memset(&slave, 0, sizeof(ec_slavet));
+    std::strncpy(slave.name, slaves[i]->getName().c_str(), EC_MAXNAME);
+    slave.Obits = sizeof(SlaveMessageOutput) * 8;
+    slave.Obytes = sizeof(SlaveMessageOutput);
+    slave.outputs = (uint8*) outputs[i];
+    slave.Ibits = sizeof(SlaveMessageInput) * 8;
+    slave.Ibytes = sizeof(SlaveMessageInput);
+    slave.inputs = (uint8*) inputs[i];
+    slave.state = EC_STATE_PRE_OP;
+    *(outputs[i]) = SlaveMessageOutput();
+    *(inputs[i]) = slaves[i]->getInput();
+  }
+  ec_slave[0].state = EC_STATE_PRE_OP;
+
+  return ec_slavecount;
+}
+
+uint16 SimulatedEthercatTransport::stateCheck(const uint16 slave, const uint16 requestedState, const int timeout) {
+  if (slave == 0) {
+    for (int i = 0; i <= ec_slavecount; i++) {
+      ec_slave[i].state = requestedState;
+    }
+  } else {
+    ec_slave[slave].state = requestedState;
+  }
+  return requestedState;
+}
+
+int SimulatedEthercatTransport::readState() {
+  uint16 lowestState = ec_slavecount > 0 ? ec_slave[1].state : 0;
+  for (int i = 1; i <= ec_slavecount; i++) {
+    if (ec_slave[i].state < lowestState)
+      lowestState = ec_slave[i].state;
+  }
+  ec_slave[0].state = lowestState;
+  return lowestState;
+}
+
+int SimulatedEthercatTransport::writeState(const uint16 slave) {
+  if (slave == 0) {
+    for (int i = 1; i <= ec_slavecount; i++) {
+      ec_slave[i].state = ec_slave[0].state;
+    }
+  }
+  return 1;
+}
+
+int SimulatedEthercatTransport::sendProcessData() {
+  for (unsigned int i = 0; i < outputs.size(); i++) {
+    sentOutputs[i] = *(outputs[i]);
+  }
+  dataSent = true;
+  return 1;
+}
+
+///updates the slaves with the elapsed time and returns the working counter
+int SimulatedEthercatTransport::receiveProcessData(const int timeout) {
+  if (!dataSent)
+    return 0;
+
+  long long now = PeriodicTimer::getMonotonicTimeMicroSec();
+  double timeStep = 0.001;
+  if (lastUpdate != 0)
+    timeStep = (now - lastUpdate) * 1e-6;
+  if (timeStep > 0.1)
+    timeStep = 0.1;
+  lastUpdate = now;
+
+  for (unsigned int i = 0; i < slaves.size(); i++) {
+    slaves[i]->update(sentOutputs[i], timeStep);
+    *(inputs[i]) = slaves[i]->getInput();
+  }
+  dataSent = false;
+  // a slave with inputs and outputs increments the working counter by three
+  return slaves.size() * 3;
+}
+
+int SimulatedEthercatTransport::mailboxSend(const uint16 slave, ec_mbxbuft* mailbox, const int timeout) {
+  if (slave == 0 || slave > slaves.size())
+    return 0;
+  slaves[slave - 1]->handleMailboxRequest(*mailbox);
+  return 1;
+}
+
+int SimulatedEthercatTransport::mailboxReceive(const uint16 slave, ec_mbxbuft* mailbox, const int timeout) {
+  if (slave == 0 || slave > slaves.size())
+    return 0;
+  return slaves[slave - 1]->getMailboxReply(*mailbox) ? 1 : 0;
+}
+
+bool SimulatedEthercatTransport::isError() {
+  return false;
+}
+
+void SimulatedEthercatTransport::close() {
+  ec_slavecount = 0;
+}
+
+} // namespace youbot
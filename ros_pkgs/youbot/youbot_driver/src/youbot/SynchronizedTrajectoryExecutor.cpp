@@ -0,0 +1,368 @@
+/****************************************************************
+ *
+ * Copyright (c) 2011
+ * All rights reserved.
+ *
+ * Hochschule Bonn-Rhein-Sieg
+ * University of Applied Sciences
+ * Computer Science Department
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Author:
+ * Jan Paulus, Nico Hochgeschwender, Michael Reckhaus, Azamat Shakhimardanov
+ * Supervised by:
+ * Gerhard K. Kraetzschmar
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * This sofware is published under a dual-license: GNU Lesser General Public 
+ * License LGPL 2.1 and BSD license. The dual-license implies that users of this
+ * code may choose which terms they prefer.
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Hochschule Bonn-Rhein-Sieg nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License LGPL as
+ * published by the Free Software Foundation, either version 2.1 of the
+ * License, or (at your option) any later version or the BSD license.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License LGPL and the BSD license for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License LGPL and BSD license along with this program.
+ *
+ ****************************************************************/
+#include "youbot_driver/youbot/SynchronizedTrajectoryExecutor.hpp"
+
+namespace youbot {
+
+  SynchronizedTrajectoryExecutor::SynchronizedTrajectoryExecutor() {
+
+    this->cyclePeriod = 0;
+    this->requestedGeneration = 0;
+    this->finishedGeneration = 0;
+    this->startCycle = 0;
+    this->lastCycle = 0;
+    this->segmentCursor = 0;
+    this->isRunning = false;
+    this->setpoints.cycle = 0;
+    for (unsigned int j = 0; j < SynchronizedTrajectorySetpoints::MAXIMUM_NUMBER_OF_JOINTS; j++) {
+      this->setpoints.position[j] = 0;
+      this->setpoints.velocity[j] = 0;
+      this->setpoints.acceleration[j] = 0;
+    }
+    this->setpointsBox.Set(setpoints);
+
+  }
+
+  SynchronizedTrajectoryExecutor::~SynchronizedTrajectoryExecutor() {
+
+  }
+
+  void SynchronizedTrajectoryExecutor::addJoint(const unsigned int jointNumber, const int encoderTicksPerRound, const double gearRatio, const bool inverseDirection) {
+
+    if (joints.size() >= SynchronizedTrajectorySetpoints::MAXIMUM_NUMBER_OF_JOINTS)
+      throw std::out_of_range("Too many joints for a synchronized trajectory");
+    if (jointNumber == 0)
+      throw std::out_of_range("Invalid joint number");
+
+    Joint joint;
+    joint.slaveIndex = jointNumber - 1;
+    joint.encoderTicksPerRound = encoderTicksPerRound;
+    joint.gearRatio = gearRatio;
+    joint.inverseDirection = inverseDirection;
+    joint.pid.initPid(80.0, 1, 0, 1000, -1000);
+    joints.push_back(joint);
+    firstSegmentCoefficients.resize(joints.size() * 6, 0.0);
+
+  }
+
+  unsigned int SynchronizedTrajectoryExecutor::getNumberOfJoints() {
+    return joints.size();
+  }
+
+  void SynchronizedTrajectoryExecutor::setConfigurationParameter(const unsigned int jointIndex, const double PParameter, const double IParameter, const double DParameter, const double IClippingMax, const double IClippingMin) {
+
+    if (this->isTrajectoryActive())
+      throw std::runtime_error("The synchronized trajectory executor is running");
+    if (jointIndex >= joints.size())
+      throw std::out_of_range("Invalid joint index");
+    joints[jointIndex].pid.setGains(PParameter, IParameter, DParameter, IClippingMax, IClippingMin);
+
+  }
+
+  void SynchronizedTrajectoryExecutor::setCyclePeriod(const unsigned int periodMicroSec) {
+    this->cyclePeriod = periodMicroSec;
+  }
+
+  void SynchronizedTrajectoryExecutor::setTrajectory(const MultiJointTrajectory& trajectory) {
+
+    const unsigned int nrOfJoints = joints.size();
+
+    if (cyclePeriod == 0)
+      throw std::runtime_error("The synchronized trajectory executor is not registered at the EtherCAT master");
+    if (trajectory.points.size() == 0 || nrOfJoints == 0)
+      throw std::runtime_error("Invalid trajectory");
+
+    boost::shared_ptr<Table> table_ptr(new Table);
+    Table &table = *table_ptr;
+    table.endCycles.resize(trajectory.points.size());
+    table.targets.resize(trajectory.points.size() * nrOfJoints * 3, 0.0);
+    table.coefficients.resize(trajectory.points.size() * nrOfJoints * 6, 0.0);
+
+    // ------ Quantizes the time of the points to EtherCAT cycles
+
+    for (unsigned int i = 0; i < trajectory.points.size(); i++) {
+      const MultiJointTrajectoryPoint& point = trajectory.points[i];
+
+      if (point.positions.size() != nrOfJoints
+              || (point.velocities.size() != 0 && point.velocities.size() != nrOfJoints)
+              || (point.accelerations.size() != 0 && point.accelerations.size() != nrOfJoints)) {
+        std::stringstream errorMessageStream;
+        errorMessageStream << "Trajectory point " << i << " has not the values of " << nrOfJoints << " joints";
+        throw std::runtime_error(errorMessageStream.str());
+      }
+      if (point.time_from_start.is_negative() || (i > 0 && point.time_from_start < trajectory.points[i - 1].time_from_start))
+        throw std::runtime_error("The time from start of the trajectory points has to be increasing");
+
+      table.endCycles[i] = (uint32) ((point.time_from_start.total_microseconds() + cyclePeriod / 2) / cyclePeriod);
+
+      for (unsigned int j = 0; j < nrOfJoints; j++) {
+        double* target = &table.targets[(i * nrOfJoints + j) * 3];
+        target[0] = point.positions[j].value();
+        target[1] = point.velocities.size() == 0 ? 0.0 : point.velocities[j].value();
+        target[2] = point.accelerations.size() == 0 ? 0.0 : point.accelerations[j].value();
+      }
+    }
+
+    // ------ Converts the boundary conditions to splines, the first segment depends on the start state
+
+    for (unsigned int i = 1; i < trajectory.points.size(); i++) {
+      const double duration = (double) (table.endCycles[i] - table.endCycles[i - 1]) * cyclePeriod / 1000.0 / 1000.0;
+      for (unsigned int j = 0; j < nrOfJoints; j++) {
+        const double* start = &table.targets[((i - 1) * nrOfJoints + j) * 3];
+        const double* end = &table.targets[(i * nrOfJoints + j) * 3];
+        getQuinticSplineCoefficients(start[0], start[1], start[2], end[0], end[1], end[2], duration,
+                &table.coefficients[(i * nrOfJoints + j) * 6]);
+      }
+    }
+
+    // ------ Commits the new trajectory
+
+    {
+      boost::mutex::scoped_lock lock(setTrajectoryMutex);
+      table.generation = requestedGeneration + 1;
+      current_table_box_.Set(table_ptr);
+      requestedGeneration = table.generation;
+    }
+    LOG(debug) << "The new synchronized trajectory has " << trajectory.points.size() << " points for " << nrOfJoints << " joints";
+
+  }
+
+  void SynchronizedTrajectoryExecutor::cancelCurrentTrajectory() {
+
+    // a trajectory without points stops all joints
+    boost::shared_ptr<Table> table_ptr(new Table);
+    {
+      boost::mutex::scoped_lock lock(setTrajectoryMutex);
+      table_ptr->generation = requestedGeneration + 1;
+      current_table_box_.Set(table_ptr);
+      requestedGeneration = table_ptr->generation;
+    }
+    LOG(trace) << "Synchronized trajectory has been canceled";
+
+  }
+
+  bool SynchronizedTrajectoryExecutor::isTrajectoryActive() {
+    return this->finishedGeneration != this->requestedGeneration;
+  }
+
+  void SynchronizedTrajectoryExecutor::getLastTargetPositions(std::vector<JointAngleSetpoint>& positions) {
+
+    SynchronizedTrajectorySetpoints lastSetpoints;
+    setpointsBox.Get(lastSetpoints);
+    positions.resize(joints.size());
+    for (unsigned int j = 0; j < joints.size(); j++) {
+      positions[j].angle = lastSetpoints.position[j] * radian;
+    }
+
+  }
+
+  void SynchronizedTrajectoryExecutor::getLastTargetVelocities(std::vector<JointVelocitySetpoint>& velocities) {
+
+    SynchronizedTrajectorySetpoints lastSetpoints;
+    setpointsBox.Get(lastSetpoints);
+    velocities.resize(joints.size());
+    for (unsigned int j = 0; j < joints.size(); j++) {
+      velocities[j].angularVelocity = lastSetpoints.velocity[j] * radian_per_second;
+    }
+
+  }
+
+  void SynchronizedTrajectoryExecutor::updateTrajectoryExecutor(const uint32 cycle, const std::vector<SlaveMessageInput*>& actual, std::vector<SlaveMessageOutput>& velocity, std::vector<bool>& update) {
+
+    const unsigned int nrOfJoints = joints.size();
+
+    boost::shared_ptr<const Table> table_ptr;
+    current_table_box_.Get(table_ptr);
+    if (!table_ptr)
+      return;
+
+    const Table &table = *table_ptr;
+
+    // ------ Starts a new trajectory in this cycle
+
+    if (table_ptr != active_table_) {
+      active_table_ = table_ptr;
+
+      if (table.endCycles.size() == 0) {
+        if (isRunning)
+          stopJoints(velocity, update);
+        isRunning = false;
+        finishedGeneration = table.generation;
+        return;
+      }
+
+      const double duration = (double) table.endCycles[0] * cyclePeriod / 1000.0 / 1000.0;
+      for (unsigned int j = 0; j < nrOfJoints; j++) {
+        const Joint& joint = joints[j];
+        if (!isRunning) {
+          double actualPosition = actual[joint.slaveIndex]->actualPosition;
+          if (joint.inverseDirection)
+            actualPosition = -actualPosition;
+          setpoints.position[j] = (actualPosition / joint.encoderTicksPerRound) * joint.gearRatio * (2.0 * M_PI);
+          setpoints.velocity[j] = 0;
+          setpoints.acceleration[j] = 0;
+        }
+        const double* end = &table.targets[j * 3];
+        getQuinticSplineCoefficients(setpoints.position[j], setpoints.velocity[j], setpoints.acceleration[j],
+                end[0], end[1], end[2], duration, &firstSegmentCoefficients[j * 6]);
+      }
+      startCycle = cycle;
+      lastCycle = cycle;
+      segmentCursor = 0;
+      isRunning = true;
+    }
+
+    if (!isRunning)
+      return;
+
+    // ------ Determines the segment from the cycle counter
+
+    const uint32 cyclesSinceStart = cycle - startCycle;
+    while (segmentCursor < table.endCycles.size() && cyclesSinceStart >= table.endCycles[segmentCursor]) {
+      ++segmentCursor;
+    }
+
+    if (segmentCursor == table.endCycles.size()) {
+      const unsigned int last = table.endCycles.size() - 1;
+      for (unsigned int j = 0; j < nrOfJoints; j++) {
+        setpoints.position[j] = table.targets[(last * nrOfJoints + j) * 3];
+        setpoints.velocity[j] = 0;
+        setpoints.acceleration[j] = 0;
+      }
+      setpoints.cycle = cycle;
+      setpointsBox.Set(setpoints);
+      stopJoints(velocity, update);
+      LOG(trace) << "synchronized trajectory finished.";
+      isRunning = false;
+      finishedGeneration = table.generation;
+      return;
+    }
+
+    // ------ Trajectory Sampling and Following, all joints at the same time
+
+    const uint32 segmentStartCycle = (segmentCursor == 0) ? 0 : table.endCycles[segmentCursor - 1];
+    const double t = (double) (cyclesSinceStart - segmentStartCycle) * cyclePeriod / 1000.0 / 1000.0;
+    boost::posix_time::time_duration dt = boost::posix_time::microseconds((long) (cycle - lastCycle) * cyclePeriod);
+    lastCycle = cycle;
+
+    for (unsigned int j = 0; j < nrOfJoints; j++) {
+      Joint& joint = joints[j];
+      const double* c = (segmentCursor == 0) ? &firstSegmentCoefficients[j * 6] : &table.coefficients[(segmentCursor * nrOfJoints + j) * 6];
+
+      setpoints.position[j] = c[0] + t * (c[1] + t * (c[2] + t * (c[3] + t * (c[4] + t * c[5]))));
+      setpoints.velocity[j] = c[1] + t * (2.0 * c[2] + t * (3.0 * c[3] + t * (4.0 * c[4] + t * 5.0 * c[5])));
+      setpoints.acceleration[j] = 2.0 * c[2] + t * (6.0 * c[3] + t * (12.0 * c[4] + t * 20.0 * c[5]));
+
+      double actualpose = actual[joint.slaveIndex]->actualPosition;
+      double actualvel = actual[joint.slaveIndex]->actualVelocity;
+      if (joint.inverseDirection) {
+        actualpose = -actualpose;
+        actualvel = -actualvel;
+      }
+      double pose_error = ((actualpose / joint.encoderTicksPerRound) * joint.gearRatio * (2.0 * M_PI)) - setpoints.position[j];
+      double velocity_error = ((actualvel / 60.0) * joint.gearRatio * 2.0 * M_PI) - setpoints.velocity[j];
+
+      double velsetpoint = joint.pid.updatePid(pose_error, velocity_error, dt);
+
+      SlaveMessageOutput& output = velocity[joint.slaveIndex];
+      output.value = (int32) boost::math::round((velsetpoint / (joint.gearRatio * 2.0 * M_PI)) * 60.0);
+      output.controllerMode = VELOCITY_CONTROL;
+      if (joint.inverseDirection) {
+        output.value = -output.value;
+      }
+      update[joint.slaveIndex] = true;
+    }
+    setpoints.cycle = cycle;
+    setpointsBox.Set(setpoints);
+
+  }
+
+  void SynchronizedTrajectoryExecutor::getQuinticSplineCoefficients(const double start_pos, const double start_vel, const double start_acc, const double end_pos, const double end_vel, const double end_acc, const double time, double* coefficients) {
+
+    if (time == 0.0) {
+      coefficients[0] = end_pos;
+      coefficients[1] = end_vel;
+      coefficients[2] = 0.5 * end_acc;
+      coefficients[3] = 0.0;
+      coefficients[4] = 0.0;
+      coefficients[5] = 0.0;
+    } else {
+      const double T1 = time;
+      const double T2 = T1 * time;
+      const double T3 = T2 * time;
+      const double T4 = T3 * time;
+      const double T5 = T4 * time;
+
+      coefficients[0] = start_pos;
+      coefficients[1] = start_vel;
+      coefficients[2] = 0.5 * start_acc;
+      coefficients[3] = (-20.0 * start_pos + 20.0 * end_pos - 3.0 * start_acc * T2 + end_acc * T2 -
+              12.0 * start_vel * T1 - 8.0 * end_vel * T1) / (2.0 * T3);
+      coefficients[4] = (30.0 * start_pos - 30.0 * end_pos + 3.0 * start_acc * T2 - 2.0 * end_acc * T2 +
+              16.0 * start_vel * T1 + 14.0 * end_vel * T1) / (2.0 * T4);
+      coefficients[5] = (-12.0 * start_pos + 12.0 * end_pos - start_acc * T2 + end_acc * T2 -
+              6.0 * start_vel * T1 - 6.0 * end_vel * T1) / (2.0 * T5);
+    }
+
+  }
+
+  void SynchronizedTrajectoryExecutor::stopJoints(std::vector<SlaveMessageOutput>& velocity, std::vector<bool>& update) {
+
+    for (unsigned int j = 0; j < joints.size(); j++) {
+      velocity[joints[j].slaveIndex].value = 0;
+      velocity[joints[j].slaveIndex].controllerMode = VELOCITY_CONTROL;
+      update[joints[j].slaveIndex] = true;
+    }
+
+  }
+
+
+} // namespace youbot
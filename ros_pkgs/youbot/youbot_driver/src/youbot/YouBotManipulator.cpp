@@ -89,6 +89,9 @@ YouBotManipulator::~YouBotManipulator() {
 			for (unsigned int i = 0; i < numberArmJoints; i++) {
 				ethercatMasterWithThread->deleteJointTrajectoryControllerRegistration(this->joints[i].getJointNumber());
 			}
+			if(trajectoryExecutor){
+				ethercatMasterWithThread->deleteSynchronizedTrajectoryExecutorRegistration(trajectoryExecutor.get());
+			}
 		}
   // Bouml preserved body end 00067FF1
 }
@@ -314,6 +317,17 @@ YouBotGripper& YouBotManipulator::getArmGripper() {
   // Bouml preserved body end 0005F9F1
 }
 
+///returns the executor which moves all arm joints synchronously along one trajectory
+///it is only available if the EtherCAT master runs with a thread
+SynchronizedTrajectoryExecutor& YouBotManipulator::getTrajectoryExecutor() {
+  // Bouml preserved body begin 001139F1
+		if(!trajectoryExecutor){
+			throw std::runtime_error("The synchronized trajectory executor needs the EtherCAT master with thread!");
+		}
+    return *trajectoryExecutor;
+  // Bouml preserved body end 001139F1
+}
+
 ///commands positions or angles to all manipulator joints
 ///all positions will be set at the same time
 ///@param JointData the to command positions
@@ -703,9 +717,20 @@ void YouBotManipulator::initializeJoints() {
         joints[i].trajectoryController.setGearRatio(gearRatio_numerator / gearRatio_denominator);
         joints[i].trajectoryController.setInverseMovementDirection(invdir);
         ethercatMasterWithThread->registerJointTrajectoryController(&(joints[i].trajectoryController), joints[i].getJointNumber());
+
+        //all arm joints are also part of the synchronized trajectory executor
+        if(!trajectoryExecutor){
+          trajectoryExecutor.reset(new SynchronizedTrajectoryExecutor());
+        }
+        trajectoryExecutor->addJoint(joints[i].getJointNumber(), ticks, gearRatio_numerator / gearRatio_denominator, invdir);
+        trajectoryExecutor->setConfigurationParameter(i, trajectory_p, trajectory_i, trajectory_d, trajectory_imax, trajectory_imin);
 			}
     }
 
+    if(trajectoryExecutor){
+      ethercatMasterWithThread->registerSynchronizedTrajectoryExecutor(trajectoryExecutor.get());
+    }
+
 
 		configfile->readInto(useGripper, "Gripper", "EnableGripper");
 		
@@ -0,0 +1,112 @@
+/*********************************************************************
+ *
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2015, Daichi Yoshikawa
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the Daichi Yoshikawa nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Author: Daichi Yoshikawa
+ *
+ *********************************************************************/
+
+#ifndef __AHL_UTILS_JOINT_BLOCK_HPP
+#define __AHL_UTILS_JOINT_BLOCK_HPP
+
+#include <string>
+#include <boost/shared_ptr.hpp>
+#include <boost/interprocess/managed_shared_memory.hpp>
+#include <boost/interprocess/sync/interprocess_mutex.hpp>
+
+namespace ahl_utils
+{
+
+  struct JointBlockHeader
+  {
+    JointBlockHeader()
+      : time(0.0), state_count(0)
+    {
+    }
+
+    boost::interprocess::interprocess_mutex state_mutex;
+    boost::interprocess::interprocess_mutex effort_mutex;
+    double time;
+    unsigned long state_count;
+  };
+
+  // Positions, velocities, commanded and applied efforts of a fixed list of joints in a single
+  // shared memory segment, so that all joints are exchanged under one lock
+  // instead of one segment and one named mutex per joint.
+  // Joints are addressed by their index in the registration order.
+  class JointBlock
+  {
+  public:
+    typedef boost::shared_ptr<JointBlock> Ptr;
+
+    JointBlock(const std::string& name, unsigned int size, bool remove = false);
+    ~JointBlock();
+
+    // Simulator side
+    // @param tau_applied Efforts the simulator actually applied in the last step
+    void writeStates(const double* q, const double* dq, const double* tau_applied, double time);
+    void readEfforts(double* tau);
+
+    // Controller side
+    // @return false : states haven't been written yet
+    bool readStates(double* q, double* dq, double* tau_applied, double& time);
+    void writeEfforts(const double* tau);
+
+    unsigned int getSize() const
+    {
+      return size_;
+    }
+
+    const std::string& getName() const
+    {
+      return name_;
+    }
+
+  private:
+    typedef boost::shared_ptr<boost::interprocess::managed_shared_memory> ManagedSharedMemoryPtr;
+
+    double* findArray(const char* name);
+
+    std::string name_;
+    unsigned int size_;
+    ManagedSharedMemoryPtr segment_;
+    JointBlockHeader* header_;
+    double* q_;
+    double* dq_;
+    double* tau_;
+    double* tau_applied_;
+  };
+
+}
+
+#endif /* __AHL_UTILS_JOINT_BLOCK_HPP */
@@ -0,0 +1,117 @@
+/*********************************************************************
+ *
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2015, Daichi Yoshikawa
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the Daichi Yoshikawa nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Author: Daichi Yoshikawa
+ *
+ *********************************************************************/
+
+#ifndef __AHL_UTILS_LOCK_STEP_HPP
+#define __AHL_UTILS_LOCK_STEP_HPP
+
+#include <string>
+#include <boost/shared_ptr.hpp>
+#include <boost/interprocess/managed_shared_memory.hpp>
+#include <boost/interprocess/sync/interprocess_semaphore.hpp>
+
+namespace ahl_utils
+{
+
+  // Lives in the shared memory segment, constructed once by whichever
+  // process opens the segment first.
+  struct LockStepData
+  {
+    LockStepData()
+      : states_ready(0), efforts_ready(0), time(0.0), step(0), answered_step(0), attached(0)
+    {
+    }
+
+    boost::interprocess::interprocess_semaphore states_ready;
+    boost::interprocess::interprocess_semaphore efforts_ready;
+    volatile double time;
+    // Sequence number of the step whose states were posted last
+    volatile unsigned long step;
+    // Sequence number of the step the controller answered last
+    volatile unsigned long answered_step;
+    volatile int attached;
+  };
+
+  // Synchronizes a simulator and a single controller step by step.
+  // Every physics step, the simulator writes joint states, calls notifyStates
+  // and blocks in waitEfforts until the controller has read the states
+  // through waitStates, written its efforts and called notifyEfforts.
+  // The simulator only waits while a controller is attached, and detaches
+  // it when it misses the timeout so that the simulation keeps running.
+  // Every step carries a sequence number, so posts left over from a step
+  // one side missed are discarded instead of shifting the protocol.
+  class LockStep
+  {
+  public:
+    typedef boost::shared_ptr<LockStep> Ptr;
+
+    LockStep(const std::string& name, bool remove = false);
+    ~LockStep();
+
+    // Simulator side
+    void notifyStates(double time);
+    bool waitEfforts(double timeout);
+
+    // Controller side
+    bool waitStates(double timeout);
+    void notifyEfforts();
+
+    void attach();
+    void detach();
+    bool isAttached() const;
+
+    // Simulation time of the states of the current step
+    double getTime() const;
+
+    const std::string& getName() const
+    {
+      return name_;
+    }
+
+  private:
+    typedef boost::shared_ptr<boost::interprocess::managed_shared_memory> ManagedSharedMemoryPtr;
+
+    std::string name_;
+    ManagedSharedMemoryPtr segment_;
+    LockStepData* data_;
+    // Controller side : step returned by the last successful waitStates
+    unsigned long step_;
+  };
+
+}
+
+#endif /* __AHL_UTILS_LOCK_STEP_HPP */
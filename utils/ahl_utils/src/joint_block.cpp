@@ -0,0 +1,77 @@
+#include <cstring>
+#include <sstream>
+#include <boost/interprocess/sync/scoped_lock.hpp>
+#include "ahl_utils/joint_block.hpp"
+#include "ahl_utils/exception.hpp"
+
+using namespace ahl_utils;
+using namespace boost::interprocess;
+
+JointBlock::JointBlock(const std::string& name, unsigned int size, bool remove)
+  : name_(name), size_(size)
+{
+  if(remove)
+  {
+    shared_memory_object::remove(name_.c_str());
+  }
+
+  std::size_t bytes = 4096 + 5 * size_ * sizeof(double);
+  segment_ = ManagedSharedMemoryPtr(new managed_shared_memory(open_or_create, name_.c_str(), bytes));
+
+  header_ = segment_->find_or_construct<JointBlockHeader>("header")();
+  q_   = this->findArray("position");
+  dq_  = this->findArray("velocity");
+  tau_ = this->findArray("effort");
+  tau_applied_ = this->findArray("applied_effort");
+}
+
+JointBlock::~JointBlock()
+{
+}
+
+double* JointBlock::findArray(const char* name)
+{
+  double* array = segment_->find_or_construct<double>(name)[size_](0.0);
+
+  std::pair<double*, std::size_t> found = segment_->find<double>(name);
+  if(found.second != size_)
+  {
+    std::stringstream msg;
+    msg << name_ << " holds " << found.second << " joints, expected " << size_ << ".";
+    throw ahl_utils::Exception("ahl_utils::JointBlock::findArray", msg.str());
+  }
+
+  return array;
+}
+
+void JointBlock::writeStates(const double* q, const double* dq, const double* tau_applied, double time)
+{
+  scoped_lock<interprocess_mutex> lock(header_->state_mutex);
+  std::memcpy(q_, q, size_ * sizeof(double));
+  std::memcpy(dq_, dq, size_ * sizeof(double));
+  std::memcpy(tau_applied_, tau_applied, size_ * sizeof(double));
+  header_->time = time;
+  ++header_->state_count;
+}
+
+void JointBlock::readEfforts(double* tau)
+{
+  scoped_lock<interprocess_mutex> lock(header_->effort_mutex);
+  std::memcpy(tau, tau_, size_ * sizeof(double));
+}
+
+bool JointBlock::readStates(double* q, double* dq, double* tau_applied, double& time)
+{
+  scoped_lock<interprocess_mutex> lock(header_->state_mutex);
+  std::memcpy(q, q_, size_ * sizeof(double));
+  std::memcpy(dq, dq_, size_ * sizeof(double));
+  std::memcpy(tau_applied, tau_applied_, size_ * sizeof(double));
+  time = header_->time;
+  return header_->state_count > 0;
+}
+
+void JointBlock::writeEfforts(const double* tau)
+{
+  scoped_lock<interprocess_mutex> lock(header_->effort_mutex);
+  std::memcpy(tau_, tau, size_ * sizeof(double));
+}
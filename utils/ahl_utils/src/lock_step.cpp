@@ -0,0 +1,104 @@
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include "ahl_utils/lock_step.hpp"
+
+using namespace ahl_utils;
+using namespace boost::interprocess;
+
+namespace
+{
+  boost::posix_time::ptime deadline(double timeout)
+  {
+    return boost::posix_time::microsec_clock::universal_time() +
+           boost::posix_time::microseconds(static_cast<long>(timeout * 1000000.0));
+  }
+}
+
+LockStep::LockStep(const std::string& name, bool remove)
+  : name_(name), step_(0)
+{
+  if(remove)
+  {
+    shared_memory_object::remove(name_.c_str());
+  }
+
+  segment_ = ManagedSharedMemoryPtr(new managed_shared_memory(open_or_create, name_.c_str(), 4096));
+  data_ = segment_->find_or_construct<LockStepData>("lock_step")();
+}
+
+LockStep::~LockStep()
+{
+}
+
+void LockStep::notifyStates(double time)
+{
+  // discard efforts a controller posted after the last timeout
+  while(data_->efforts_ready.try_wait());
+
+  data_->time = time;
+  ++data_->step;
+  data_->states_ready.post();
+}
+
+bool LockStep::waitEfforts(double timeout)
+{
+  boost::posix_time::ptime until = deadline(timeout);
+
+  // efforts answering an earlier step may still arrive after notifyStates
+  while(data_->efforts_ready.timed_wait(until))
+  {
+    if(data_->answered_step == data_->step)
+      return true;
+  }
+
+  return false;
+}
+
+bool LockStep::waitStates(double timeout)
+{
+  boost::posix_time::ptime until = deadline(timeout);
+
+  // skip posts of a step which has already been answered
+  while(data_->states_ready.timed_wait(until))
+  {
+    unsigned long step = data_->step;
+    if(step != step_)
+    {
+      step_ = step;
+      return true;
+    }
+  }
+
+  return false;
+}
+
+void LockStep::notifyEfforts()
+{
+  data_->answered_step = step_;
+  data_->efforts_ready.post();
+}
+
+void LockStep::attach()
+{
+  // states posted for a step the controller missed are stale now
+  while(data_->states_ready.try_wait());
+
+  data_->attached = 1;
+}
+
+void LockStep::detach()
+{
+  data_->attached = 0;
+
+  // the controller must not pick up the step it missed once it reattaches
+  while(data_->states_ready.try_wait());
+}
+
+bool LockStep::isAttached() const
+{
+  return data_->attached != 0;
+}
+
+double LockStep::getTime() const
+{
+  return data_->time;
+}
@@ -0,0 +1,87 @@
+/*********************************************************************
+ *
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2014, Daichi Yoshikawa
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the Daichi Yoshikawa nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Author: Daichi Yoshikawa
+ *
+ *********************************************************************/
+
+#ifndef __CV_WRAPPER_HSV_LOOKUP_TABLE_HPP
+#define __CV_WRAPPER_HSV_LOOKUP_TABLE_HPP
+
+#include <boost/shared_ptr.hpp>
+#include <boost/cstdint.hpp>
+#include <opencv2/opencv.hpp>
+#include "cv_wrapper/hsv_mask_param.hpp"
+
+namespace cv_wrapper
+{
+
+  // Per-channel bit tables for HSV range segmentation.
+  // Bit i of h_[h] & s_[s] & v_[v] is set iff (h, s, v) is inside the i-th range,
+  // so any number of ranges (up to 32) are tested in one pass over the image.
+  // Range semantics (min < x <= max, hue wrap-around over 255) are the same
+  // as extractDesignatedHueArea and extractDesignatedArea.
+  class HSVLookupTable
+  {
+  public:
+    static const unsigned int MAX_RANGES = 32;
+
+    HSVLookupTable();
+
+    void clear();
+    void set(const HSVMaskParamPtr& param, unsigned int idx);
+    void add(const HSVMaskParamPtr& param);
+
+    // hsv : CV_8UC3, dst : CV_8UC1 (reallocated only when the size changes)
+    void apply(const cv::Mat& hsv, cv::Mat& dst) const;
+
+    unsigned int size() const
+    {
+      return range_num_;
+    }
+
+  private:
+    void setHueRange(unsigned int idx, int min, int max);
+    void setRange(boost::uint32_t* table, unsigned int idx, int min, int max);
+
+    unsigned int range_num_;
+    boost::uint32_t h_[256];
+    boost::uint32_t s_[256];
+    boost::uint32_t v_[256];
+  };
+
+  typedef boost::shared_ptr<HSVLookupTable> HSVLookupTablePtr;
+}
+
+#endif /* __CV_WRAPPER_HSV_LOOKUP_TABLE_HPP */
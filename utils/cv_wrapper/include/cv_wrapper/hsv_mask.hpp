@@ -44,6 +44,8 @@
 
 #include <opencv2/opencv.hpp>
 #include "cv_wrapper/hsv_mask_param.hpp"
+#include "cv_wrapper/hsv_lookup_table.hpp"
+#include "cv_wrapper/labeler.hpp"
 
 namespace cv_wrapper
 {
@@ -56,10 +58,15 @@ namespace cv_wrapper
     void set(const HSVMaskParamPtr& param, int idx);
     void add(const HSVMaskParamPtr& param);
     void getMask(std::vector<cv::Mat>& hsv, bool labeling, int erode_num, int dilate_num);
+    // Single-pass version : bgr -> hsv (reused buffer) -> mask of all ranges -> one closing
+    void getMaskFromBGR(const cv::Mat& bgr, bool labeling, int erode_num, int dilate_num);
     const cv::Mat& get() const;
 
   private:
     std::vector<HSVMaskParamPtr> param_;
+    HSVLookupTable lut_;
+    Labeler labeler_;
+    cv::Mat hsv_;
     cv::Mat mask_;
   };
 
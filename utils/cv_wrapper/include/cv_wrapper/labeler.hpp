@@ -0,0 +1,162 @@
+/*********************************************************************
+ *
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2014, Daichi Yoshikawa
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the Daichi Yoshikawa nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Author: Daichi Yoshikawa
+ *
+ *********************************************************************/
+
+#ifndef __CV_WRAPPER_LABELER_HPP
+#define __CV_WRAPPER_LABELER_HPP
+
+#include <climits>
+#include <vector>
+#include <algorithm>
+#include <boost/shared_ptr.hpp>
+#include <opencv2/opencv.hpp>
+
+namespace cv_wrapper
+{
+
+  class RegionStats
+  {
+  public:
+    RegionStats()
+      : area(0), x_min(INT_MAX), y_min(INT_MAX), x_max(-1), y_max(-1), sum_x(0.0), sum_y(0.0) {}
+
+    void add(int x, int y)
+    {
+      ++area;
+      x_min = std::min(x_min, x);
+      y_min = std::min(y_min, y);
+      x_max = std::max(x_max, x);
+      y_max = std::max(y_max, y);
+      sum_x += x;
+      sum_y += y;
+    }
+
+    void merge(const RegionStats& stats)
+    {
+      area += stats.area;
+      x_min = std::min(x_min, stats.x_min);
+      y_min = std::min(y_min, stats.y_min);
+      x_max = std::max(x_max, stats.x_max);
+      y_max = std::max(y_max, stats.y_max);
+      sum_x += stats.sum_x;
+      sum_y += stats.sum_y;
+    }
+
+    cv::Rect getRect() const
+    {
+      return cv::Rect(x_min, y_min, x_max - x_min + 1, y_max - y_min + 1);
+    }
+
+    cv::Point2d getCentroid() const
+    {
+      return cv::Point2d(sum_x / area, sum_y / area);
+    }
+
+    int area;
+    int x_min;
+    int y_min;
+    int x_max;
+    int y_max;
+    double sum_x;
+    double sum_y;
+  };
+
+  // 8-connected component labeling of binary images.
+  // Pixels are grouped into 2x2 blocks, blocks are labeled with union-find and
+  // region stats are accumulated while scanning, so only one pass over the
+  // pixels is needed. Any image size is accepted. With strip_num > 1, horizontal
+  // strips are labeled in parallel and merged along their borders.
+  // Buffers are kept between calls, so reuse one Labeler per image stream.
+  class Labeler
+  {
+  public:
+    explicit Labeler(unsigned int strip_num = 1);
+
+    // src : CV_8UC1, non-zero pixels are foreground.
+    // Returns the number of regions. Labels are 1, ..., N in block scan order.
+    unsigned int label(const cv::Mat& src);
+
+    // dst : CV_32SC1, 0 is background
+    void getLabelImage(const cv::Mat& src, cv::Mat& dst) const;
+    // dst : CV_8UC1, 255 on pixels of the designated region
+    void extract(const cv::Mat& src, cv::Mat& dst, unsigned int label) const;
+
+    // Returns 0 if there is no region.
+    unsigned int getLargestLabel() const;
+
+    unsigned int getRegionNum() const
+    {
+      return region_num_;
+    }
+
+    // stats[label - 1]
+    const std::vector<RegionStats>& getStats() const
+    {
+      return stats_;
+    }
+
+  private:
+    class StripLabeling;
+
+    void labelStrip(const cv::Mat& src, unsigned int strip);
+    int connectUpperBlocks(int label, const uchar* upper, int x, int w, int bx, int by, bool a, bool b);
+    void mergeStrips(const cv::Mat& src);
+    void flatten();
+
+    int newLabel(int& next_label);
+    int findRoot(int label) const;
+    int unite(int label1, int label2);
+
+    unsigned int strip_num_;
+    int block_w_;
+    int block_h_;
+    // block rows of strip k are [strip_begin_[k], strip_begin_[k + 1])
+    std::vector<int> strip_begin_;
+    // provisional labels of strip k are [strip_begin_[k] * block_w_ + 1, strip_end_label_[k])
+    std::vector<int> strip_end_label_;
+
+    std::vector<int> block_label_;
+    std::vector<int> parent_;
+    std::vector<RegionStats> provisional_stats_;
+    std::vector<RegionStats> stats_;
+    unsigned int region_num_;
+  };
+
+  typedef boost::shared_ptr<Labeler> LabelerPtr;
+}
+
+#endif /* __CV_WRAPPER_LABELER_HPP */
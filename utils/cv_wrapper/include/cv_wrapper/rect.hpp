@@ -57,6 +57,9 @@ namespace cv_wrapper
     void draw(cv::Mat& image, int r = 0, int g = 0, int b = 255);
     void set(int x, int y, int w, int h);
     void bound(cv::Mat& src, unsigned int pad, bool white_is_ignored = true, bool square = false);
+    // Coarse version of bound which scans only every (2^level)-th row.
+    // Regions thinner than 2^level rows may be missed.
+    void boundCoarse(const cv::Mat& src, unsigned int level, unsigned int pad, bool white_is_ignored = true, bool square = false);
     void printInfo();
 
     double getAspectRatio()
@@ -90,11 +93,9 @@ namespace cv_wrapper
 
   private:
     void limit(const cv::Mat& img);
-    bool pixelIsNot(uchar* psrc, int channels, int ignored_value);
-    int getUpperY(cv::Mat& src, uchar ignored_value);
-    int getLowerY(cv::Mat& src, uchar ignored_value);
-    int getLeftX (cv::Mat& src, uchar ignored_value);
-    int getRightX(cv::Mat& src, uchar ignored_value);
+    void boundRows(const cv::Mat& src, unsigned int row_step, unsigned int pad, bool white_is_ignored, bool square);
+    int findFirstByteIsNot(const uchar* psrc, int bytes, uchar ignored_value);
+    int findLastByteIsNot (const uchar* psrc, int bytes, uchar ignored_value);
 
     void convertSquare();
 
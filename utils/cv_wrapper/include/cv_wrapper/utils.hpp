@@ -40,6 +40,7 @@
 #define __CV_WRAPPER_UTILS_HPP
 
 #include <opencv2/opencv.hpp>
+#include "cv_wrapper/labeler.hpp"
 
 namespace cv_wrapper
 {
@@ -58,7 +59,9 @@ namespace cv_wrapper
                                 int s_min, int s_max,
                                 int v_min, int v_max,
                                 bool labeling, int erode_num, int dilate_num);
+  // Keep the largest region only
   void labeling(cv::Mat& src, cv::Mat& dst);
+  void labeling(const cv::Mat& src, cv::Mat& dst, Labeler& labeler);
 
 }
 
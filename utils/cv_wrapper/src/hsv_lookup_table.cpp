@@ -0,0 +1,124 @@
+#include <cstring>
+#include "cv_wrapper/hsv_lookup_table.hpp"
+#include "cv_wrapper/exceptions.hpp"
+
+using namespace cv_wrapper;
+
+HSVLookupTable::HSVLookupTable()
+{
+  this->clear();
+}
+
+void HSVLookupTable::clear()
+{
+  range_num_ = 0;
+  std::memset(h_, 0, sizeof(h_));
+  std::memset(s_, 0, sizeof(s_));
+  std::memset(v_, 0, sizeof(v_));
+}
+
+void HSVLookupTable::set(const HSVMaskParamPtr& param, unsigned int idx)
+{
+  if(idx >= range_num_)
+  {
+    std::stringstream ss;
+    ss << "idx is larger than param size." << std::endl
+       << "  idx  : " << idx << std::endl
+       << "  size : " << range_num_ << std::endl;
+    throw Exception("HSVLookupTable::set", ss.str());
+  }
+
+  this->setHueRange(idx, param->getHMin(), param->getHMax());
+  this->setRange(s_, idx, param->getSMin(), param->getSMax());
+  this->setRange(v_, idx, param->getVMin(), param->getVMax());
+}
+
+void HSVLookupTable::add(const HSVMaskParamPtr& param)
+{
+  if(range_num_ >= MAX_RANGES)
+  {
+    std::stringstream ss;
+    ss << "Too many ranges were added." << std::endl
+       << "  max : " << MAX_RANGES << std::endl;
+    throw Exception("HSVLookupTable::add", ss.str());
+  }
+
+  ++range_num_;
+  this->set(param, range_num_ - 1);
+}
+
+void HSVLookupTable::apply(const cv::Mat& hsv, cv::Mat& dst) const
+{
+  if(hsv.type() != CV_8UC3)
+  {
+    throw Exception("HSVLookupTable::apply", "hsv.type() should be CV_8UC3.");
+  }
+
+  dst.create(hsv.rows, hsv.cols, CV_8UC1);
+
+  int rows = hsv.rows;
+  int cols = hsv.cols;
+  if(hsv.isContinuous() && dst.isContinuous())
+  {
+    cols *= rows;
+    rows = 1;
+  }
+
+  for(int y = 0; y < rows; ++y)
+  {
+    const uchar* psrc = hsv.ptr<uchar>(y);
+    uchar* pdst = dst.ptr<uchar>(y);
+
+    for(int x = 0; x < cols; ++x, psrc += 3)
+    {
+      const boost::uint32_t hit = h_[psrc[0]] & s_[psrc[1]] & v_[psrc[2]];
+      pdst[x] = static_cast<uchar>(-static_cast<int>(hit != 0));
+    }
+  }
+}
+
+void HSVLookupTable::setHueRange(unsigned int idx, int min, int max)
+{
+  const boost::uint32_t bit = static_cast<boost::uint32_t>(1) << idx;
+
+  if(min > 255 && max > 255)
+  {
+    this->setRange(h_, idx, min - 255, max - 255);
+  }
+  else if(min <= 255 && max <= 255)
+  {
+    this->setRange(h_, idx, min, max);
+  }
+  else
+  {
+    if(min > 255)
+    {
+      min -= 255;
+    }
+    else
+    {
+      max -= 255;
+    }
+
+    for(int i = 0; i < 256; ++i)
+    {
+      if(i > min || i <= max)
+        h_[i] |= bit;
+      else
+        h_[i] &= ~bit;
+    }
+  }
+}
+
+void HSVLookupTable::setRange(boost::uint32_t* table, unsigned int idx, int min, int max)
+{
+  const boost::uint32_t bit = static_cast<boost::uint32_t>(1) << idx;
+
+  for(int i = 0; i < 256; ++i)
+  {
+    if(i > min && i <= max)
+      table[i] |= bit;
+    else
+      table[i] &= ~bit;
+  }
+}
@@ -20,10 +20,12 @@ void HSVMask::set(const HSVMaskParamPtr& param, int idx)
   }
 
   param_[idx] = param;
+  lut_.set(param, idx);
 }
 
 void HSVMask::add(const HSVMaskParamPtr& param)
 {
+  lut_.add(param);
   param_.push_back(param);
 }
 
@@ -44,6 +46,22 @@ void HSVMask::getMask(std::vector<cv::Mat>& hsv, bool labeling, int erode_num, i
   }
 }
 
+void HSVMask::getMaskFromBGR(const cv::Mat& bgr, bool labeling, int erode_num, int dilate_num)
+{
+  cv::cvtColor(bgr, hsv_, CV_BGR2HSV);
+  lut_.apply(hsv_, mask_);
+
+  if(erode_num > 0 || dilate_num > 0)
+  {
+    closing(mask_, mask_, erode_num, dilate_num);
+  }
+
+  if(labeling)
+  {
+    cv_wrapper::labeling(mask_, mask_, labeler_);
+  }
+}
+
 const cv::Mat& HSVMask::get() const
 {
   return mask_;
@@ -0,0 +1,314 @@
+#include "cv_wrapper/labeler.hpp"
+#include "cv_wrapper/exceptions.hpp"
+
+using namespace cv_wrapper;
+
+class Labeler::StripLabeling : public cv::ParallelLoopBody
+{
+public:
+  StripLabeling(Labeler* labeler, const cv::Mat& src)
+    : labeler_(labeler), src_(src) {}
+
+  virtual void operator()(const cv::Range& range) const
+  {
+    for(int i = range.start; i < range.end; ++i)
+    {
+      labeler_->labelStrip(src_, i);
+    }
+  }
+
+private:
+  Labeler* labeler_;
+  const cv::Mat& src_;
+};
+
+Labeler::Labeler(unsigned int strip_num)
+  : strip_num_(strip_num), block_w_(0), block_h_(0), region_num_(0)
+{
+  if(strip_num_ == 0)
+  {
+    strip_num_ = 1;
+  }
+}
+
+unsigned int Labeler::label(const cv::Mat& src)
+{
+  if(src.type() != CV_8UC1)
+  {
+    throw Exception("Labeler::label", "src.type() should be CV_8UC1.");
+  }
+
+  block_w_ = (src.cols + 1) / 2;
+  block_h_ = (src.rows + 1) / 2;
+
+  const int block_num = block_w_ * block_h_;
+  block_label_.resize(block_num);
+  parent_.resize(block_num + 1);
+  provisional_stats_.resize(block_num + 1);
+  parent_[0] = 0;
+
+  if(block_num == 0)
+  {
+    stats_.clear();
+    region_num_ = 0;
+    return region_num_;
+  }
+
+  const unsigned int strip_num = std::min(strip_num_, static_cast<unsigned int>(block_h_));
+  strip_begin_.resize(strip_num + 1);
+  strip_end_label_.resize(strip_num);
+  for(unsigned int i = 0; i <= strip_num; ++i)
+  {
+    strip_begin_[i] = block_h_ * i / strip_num;
+  }
+
+  if(strip_num > 1)
+  {
+    cv::parallel_for_(cv::Range(0, strip_num), StripLabeling(this, src));
+    this->mergeStrips(src);
+  }
+  else
+  {
+    this->labelStrip(src, 0);
+  }
+
+  this->flatten();
+
+  return region_num_;
+}
+
+void Labeler::getLabelImage(const cv::Mat& src, cv::Mat& dst) const
+{
+  dst.create(src.rows, src.cols, CV_32SC1);
+
+  for(int y = 0; y < src.rows; ++y)
+  {
+    const uchar* psrc = src.ptr<uchar>(y);
+    const int* plabel = &block_label_[(y / 2) * block_w_];
+    int* pdst = dst.ptr<int>(y);
+
+    for(int x = 0; x < src.cols; ++x)
+    {
+      pdst[x] = psrc[x] ? plabel[x / 2] : 0;
+    }
+  }
+}
+
+void Labeler::extract(const cv::Mat& src, cv::Mat& dst, unsigned int label) const
+{
+  dst.create(src.rows, src.cols, CV_8UC1);
+
+  for(int y = 0; y < src.rows; ++y)
+  {
+    const uchar* psrc = src.ptr<uchar>(y);
+    const int* plabel = &block_label_[(y / 2) * block_w_];
+    uchar* pdst = dst.ptr<uchar>(y);
+
+    for(int x = 0; x < src.cols; ++x)
+    {
+      pdst[x] = (psrc[x] && plabel[x / 2] == static_cast<int>(label)) ? 255 : 0;
+    }
+  }
+}
+
+unsigned int Labeler::getLargestLabel() const
+{
+  unsigned int largest = 0;
+  int area = 0;
+
+  for(unsigned int i = 0; i < stats_.size(); ++i)
+  {
+    if(stats_[i].area > area)
+    {
+      area = stats_[i].area;
+      largest = i + 1;
+    }
+  }
+
+  return largest;
+}
+
+//  Block X = [a b]  and its neighbors  P Q R
+//            [c d]                     S X
+//  All foreground pixels in a block are 8-connected, so only the pixels
+//  touching the neighbor blocks have to be checked.
+void Labeler::labelStrip(const cv::Mat& src, unsigned int strip)
+{
+  const int w = src.cols;
+  const int begin_by = strip_begin_[strip];
+  const int end_by   = strip_begin_[strip + 1];
+  int next_label = begin_by * block_w_ + 1;
+
+  for(int by = begin_by; by < end_by; ++by)
+  {
+    const int y0 = 2 * by;
+    const int y1 = y0 + 1;
+    const uchar* row0  = src.ptr<uchar>(y0);
+    const uchar* row1  = (y1 < src.rows) ? src.ptr<uchar>(y1) : NULL;
+    const uchar* upper = (by > begin_by) ? src.ptr<uchar>(y0 - 1) : NULL;
+    int* plabel = &block_label_[by * block_w_];
+
+    for(int bx = 0; bx < block_w_; ++bx)
+    {
+      const int x0 = 2 * bx;
+      const int x1 = x0 + 1;
+      const bool has_x1 = (x1 < w);
+
+      const bool a = row0[x0] != 0;
+      const bool b = has_x1 && row0[x1] != 0;
+      const bool c = row1 && row1[x0] != 0;
+      const bool d = row1 && has_x1 && row1[x1] != 0;
+
+      if(!(a || b || c || d))
+      {
+        plabel[bx] = 0;
+        continue;
+      }
+
+      int label = 0;
+
+      if(upper)
+      {
+        label = this->connectUpperBlocks(label, upper, x0, w, bx, by, a, b);
+      }
+
+      // S
+      if(bx > 0 && (a || c) && (row0[x0 - 1] || (row1 && row1[x0 - 1])))
+      {
+        label = label ? this->unite(label, plabel[bx - 1]) : plabel[bx - 1];
+      }
+
+      if(label == 0)
+      {
+        label = this->newLabel(next_label);
+      }
+
+      plabel[bx] = label;
+
+      RegionStats& stats = provisional_stats_[label];
+      if(a) stats.add(x0, y0);
+      if(b) stats.add(x1, y0);
+      if(c) stats.add(x0, y1);
+      if(d) stats.add(x1, y1);
+    }
+  }
+
+  strip_end_label_[strip] = next_label;
+}
+
+int Labeler::connectUpperBlocks(int label, const uchar* upper, int x, int w, int bx, int by, bool a, bool b)
+{
+  const int* plabel = &block_label_[(by - 1) * block_w_];
+
+  // Q
+  if((a || b) && (upper[x] || (x + 1 < w && upper[x + 1])))
+  {
+    label = label ? this->unite(label, plabel[bx]) : plabel[bx];
+  }
+  // P
+  if(a && x > 0 && upper[x - 1])
+  {
+    label = label ? this->unite(label, plabel[bx - 1]) : plabel[bx - 1];
+  }
+  // R
+  if(b && x + 2 < w && upper[x + 2])
+  {
+    label = label ? this->unite(label, plabel[bx + 1]) : plabel[bx + 1];
+  }
+
+  return label;
+}
+
+void Labeler::mergeStrips(const cv::Mat& src)
+{
+  const int w = src.cols;
+
+  for(unsigned int i = 1; i < strip_end_label_.size(); ++i)
+  {
+    const int by = strip_begin_[i];
+    const int y0 = 2 * by;
+    const uchar* row0  = src.ptr<uchar>(y0);
+    const uchar* upper = src.ptr<uchar>(y0 - 1);
+    const int* plabel = &block_label_[by * block_w_];
+
+    for(int bx = 0; bx < block_w_; ++bx)
+    {
+      if(plabel[bx] == 0)
+        continue;
+
+      const int x0 = 2 * bx;
+      const bool a = row0[x0] != 0;
+      const bool b = (x0 + 1 < w) && row0[x0 + 1] != 0;
+
+      this->connectUpperBlocks(plabel[bx], upper, x0, w, bx, by, a, b);
+    }
+  }
+}
+
+// Provisional labels always point to smaller ones, so a single increasing
+// sweep resolves every label to its final one and gathers the region stats.
+void Labeler::flatten()
+{
+  stats_.clear();
+  int final_label = 0;
+
+  for(unsigned int i = 0; i < strip_end_label_.size(); ++i)
+  {
+    const int begin = strip_begin_[i] * block_w_ + 1;
+
+    for(int l = begin; l < strip_end_label_[i]; ++l)
+    {
+      if(parent_[l] == l)
+      {
+        parent_[l] = ++final_label;
+        stats_.push_back(provisional_stats_[l]);
+      }
+      else
+      {
+        parent_[l] = parent_[parent_[l]];
+        stats_[parent_[l] - 1].merge(provisional_stats_[l]);
+      }
+    }
+  }
+
+  for(unsigned int i = 0; i < block_label_.size(); ++i)
+  {
+    block_label_[i] = parent_[block_label_[i]];
+  }
+
+  region_num_ = final_label;
+}
+
+int Labeler::newLabel(int& next_label)
+{
+  const int label = next_label++;
+  parent_[label] = label;
+  provisional_stats_[label] = RegionStats();
+
+  return label;
+}
+
+int Labeler::findRoot(int label) const
+{
+  while(parent_[label] < label)
+  {
+    label = parent_[label];
+  }
+
+  return label;
+}
+
+int Labeler::unite(int label1, int label2)
+{
+  int root1 = this->findRoot(label1);
+  int root2 = this->findRoot(label2);
+
+  if(root1 < root2)
+  {
+    parent_[root2] = root1;
+    return root1;
+  }
+
+  parent_[root1] = root2;
+  return root2;
+}
@@ -1,3 +1,5 @@
+#include <cstring>
+#include <boost/cstdint.hpp>
 #include <ros/ros.h>
 #include "cv_wrapper/rect.hpp"
 
@@ -61,16 +63,25 @@ void Rect::limit(const cv::Mat& img)
   }
 }
 
-//TODO : a bound function & related functions may include some bugs...
 void Rect::bound(cv::Mat& src, unsigned int pad, bool white_is_ignored, bool square)
+{
+  this->boundRows(src, 1, pad, white_is_ignored, square);
+}
+
+void Rect::boundCoarse(const cv::Mat& src, unsigned int level, unsigned int pad, bool white_is_ignored, bool square)
+{
+  const unsigned int row_step = 1 << level;
+  this->boundRows(src, row_step, pad + row_step - 1, white_is_ignored, square);
+}
+
+// Every (row_step)-th row is visited once. Each row is compared 8 bytes
+// at a time from both ends, so rows and columns are bounded in one pass.
+void Rect::boundRows(const cv::Mat& src, unsigned int row_step, unsigned int pad, bool white_is_ignored, bool square)
 {
   int height = src.rows;
   int width  = src.cols;
-
-  int upper_y = 0;
-  int lower_y = height;
-  int left_x  = 0;
-  int right_x = width;
+  int channels = src.channels();
+  int bytes = width * channels;
 
   uchar ignored_value = 0;
   if(white_is_ignored)
@@ -78,10 +89,41 @@ void Rect::bound(cv::Mat& src, unsigned int pad, bool white_is_ignored, bool squ
     ignored_value = 255;
   }
 
-  upper_y = getUpperY(src, ignored_value);
-  lower_y = getLowerY(src, ignored_value);
-  left_x  = getLeftX (src, ignored_value);
-  right_x = getRightX(src, ignored_value);
+  int top    = -1;
+  int bottom = -1;
+  int left   = width;
+  int right  = -1;
+
+  for(int y = 0; y < height; y += row_step)
+  {
+    const uchar* psrc = src.ptr<uchar>(y);
+
+    int first = findFirstByteIsNot(psrc, bytes, ignored_value);
+    if(first < 0)
+      continue;
+
+    if(top < 0)
+    {
+      top = y;
+    }
+    bottom = y;
+
+    left  = std::min(left, first / channels);
+    right = std::max(right, findLastByteIsNot(psrc, bytes, ignored_value) / channels);
+  }
+
+  int upper_y = 0;
+  int lower_y = height - 1;
+  int left_x  = 0;
+  int right_x = width - 1;
+
+  if(top >= 0)
+  {
+    upper_y = (top > 0) ? top - 1 : top;
+    lower_y = (bottom < height - 1) ? bottom + 1 : bottom;
+    left_x  = (left > 0) ? left - 1 : left;
+    right_x = (right < width - 1) ? right + 1 : right;
+  }
 
   rect_.x = left_x - pad;
   rect_.y = upper_y - pad;
@@ -117,164 +159,48 @@ bool Rect::isZero()
   return false;
 }
 
-bool Rect::pixelIsNot(uchar* psrc, int channels, int ignored_value)
-{
-  if(channels == 1)
-  {
-    if(*psrc != ignored_value)
-    {
-      return true;
-    }
-    else
-    {
-      return false;
-    }
-  }
-  else if(channels == 3)
-  {
-    if(psrc[0] != ignored_value
-       || psrc[1] != ignored_value
-       || psrc[2] != ignored_value)
-    {
-      return true;
-    }
-    else
-    {
-      return false;
-    }
-  }
-  else if(channels == 4)
-  {
-    if(psrc[0] != ignored_value
-       || psrc[1] != ignored_value
-       || psrc[2] != ignored_value
-       || psrc[3] != ignored_value)
-    {
-      return true;
-    }
-    else
-    {
-      return false;
-    }
-  }
-  else
-  {
-    return false;
-  }
-}
-
-int Rect::getUpperY(cv::Mat& src, uchar ignored_value)
+int Rect::findFirstByteIsNot(const uchar* psrc, int bytes, uchar ignored_value)
 {
-  int channels = src.channels();
-  int height   = src.rows;
-  int width    = src.cols*channels;
+  const boost::uint64_t pattern = 0x0101010101010101ULL * ignored_value;
+  boost::uint64_t word;
 
-  for(int y = 0; y < height; ++y)
+  int x = 0;
+  for(; x + 8 <= bytes; x += 8)
   {
-    uchar* psrc = src.ptr<uchar>(y);
-
-    for(int x = 0; x < width; x += channels)
-    {
-      if(pixelIsNot(&psrc[x], channels, ignored_value))
-      {
-        if(y > 0)
-        {
-          return y - 1;
-        }
-        else
-        {
-          return y;
-        }
-      }
-    }
+    std::memcpy(&word, &psrc[x], 8);
+    if(word != pattern)
+      break;
   }
 
-  return 0;
-}
-
-int Rect::getLowerY(cv::Mat& src, uchar ignored_value)
-{
-  int channels = src.channels();
-  int height   = src.rows;
-  int width    = src.cols*channels;
-
-  for(int y = height - 1; y >= 0; --y)
+  for(; x < bytes; ++x)
   {
-    uchar* psrc = src.ptr<uchar>(y);
-
-    for(int x = 0; x < width; x += channels)
-    {
-      if(pixelIsNot(&psrc[x], channels, ignored_value))
-      {
-        if(y < height - 1)
-        {
-          return y + 1;
-        }
-        else
-        {
-          return y;
-        }
-      }
-    }
+    if(psrc[x] != ignored_value)
+      return x;
   }
 
-  return height - 1;
+  return -1;
 }
 
-int Rect::getLeftX (cv::Mat& src, uchar ignored_value)
+int Rect::findLastByteIsNot(const uchar* psrc, int bytes, uchar ignored_value)
 {
-  int channels = src.channels();
-  int height   = src.rows;
-  int width    = src.cols*channels;
+  const boost::uint64_t pattern = 0x0101010101010101ULL * ignored_value;
+  boost::uint64_t word;
 
-  for(int x = 0; x < width; x += channels)
+  int x = bytes;
+  for(; x >= 8; x -= 8)
   {
-    for(int y = 0; y < height; ++y)
-    {
-      uchar* psrc = src.ptr<uchar>(y);
-      if(pixelIsNot(&psrc[x], channels, ignored_value))
-      {
-        if(x > 0)
-        {
-          return x/channels - 1;
-        }
-        else
-        {
-          return x/channels;
-        }
-      }
-    }
+    std::memcpy(&word, &psrc[x - 8], 8);
+    if(word != pattern)
+      break;
   }
 
-  return 0;
-}
-
-int Rect::getRightX(cv::Mat& src, uchar ignored_value)
-{
-  int channels = src.channels();
-  int height   = src.rows;
-  int width    = src.cols*channels;
-
-  for(int x = width - channels; x >= 0; x -= channels)
+  for(--x; x >= 0; --x)
   {
-    for(int y = 0; y < height; ++y)
-    {
-      uchar* psrc = src.ptr<uchar>(y);
-      if(pixelIsNot(&psrc[x], channels, ignored_value))
-      {
-        if(x < width - 1)
-        {
-          return x/channels + 1;
-        }
-        else
-        {
-          return x/channels;
-        }
-      }
-    }
+    if(psrc[x] != ignored_value)
+      return x;
   }
 
-  return width - 1;
+  return -1;
 }
 
 //TODO : fix bug
@@ -36,8 +36,8 @@
  *
  *********************************************************************/
 
-#include "cv_wrapper/Labeling.h"
 #include "cv_wrapper/utils.hpp"
+#include "cv_wrapper/exceptions.hpp"
 
 namespace cv_wrapper
 {
@@ -177,31 +177,33 @@ namespace cv_wrapper
 
   void labeling(cv::Mat& src, cv::Mat& dst)
   {
-    if(src.rows % 2 != 0 || src.cols % 2 != 0)
-    {
-      throw("cv_wrapper::labeling", "src width or height is not an even number.");
-    }
-
-    cv::Mat label(src.size(), CV_16SC1);
-
-    LabelingBS labeling;
-    labeling.Exec(src.data, (short*)label.data, src.cols, src.rows, true, 0);
-
-    cv::Mat labelarea(src.size(), CV_8UC1, cv::Scalar(0));
-    cv::compare(label, 1, labelarea, CV_CMP_EQ);
+    Labeler labeler;
+    labeling(src, dst, labeler);
+  }
 
+  void labeling(const cv::Mat& src, cv::Mat& dst, Labeler& labeler)
+  {
     if(src.type() == CV_8UC1)
     {
-      labelarea.copyTo(dst);
+      labeler.label(src);
+      labeler.extract(src, dst, labeler.getLargestLabel());
     }
     else if(src.type() == CV_8UC3)
     {
-      cv::Mat color(src.size(), CV_8UC3, cv::Scalar(255, 255, 255));
-      color.copyTo(dst, labelarea);
+      cv::Mat gray;
+      cv::cvtColor(src, gray, CV_BGR2GRAY);
+
+      cv::Mat labelarea;
+      labeler.label(gray);
+      labeler.extract(gray, labelarea, labeler.getLargestLabel());
+
+      dst.create(src.size(), CV_8UC3);
+      dst.setTo(cv::Scalar(0, 0, 0));
+      dst.setTo(cv::Scalar(255, 255, 255), labelarea);
     }
     else
     {
-      throw("cv_wrapper::labeling", "Not supported src.type() was used.");
+      throw Exception("cv_wrapper::labeling", "Not supported src.type() was used.");
     }
   }
 